@@ -0,0 +1,156 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QDir>
+#include <QDebug>
+#include <cstdio>
+#include "src/crypto/CryptoManager.h"
+#include "src/crypto/FieldCipher.h"
+
+// 字段加密吞吐量基准
+//
+// 1. FieldCipher对不同长度字段的单次加密/解密耗时和吞吐量
+// 2. CryptoManager批量加解密时每个条目的耗时，每个条目3个字段
+// 3. 同样的条目打包为记录信封时的耗时和密文大小
+//
+// 每条目耗时超过--max-ns-per-entry时返回非零，可以在CI中作为回归门槛。
+// 配置写入临时目录，不会影响真实的crypto.ini。
+
+static const int FIELDS_PER_ENTRY = 3;
+
+/**
+ * @brief 测量FieldCipher在指定字段长度下的加解密耗时
+ * @param key 字段密钥
+ * @param fieldSize 字段长度（字节）
+ * @param rounds 重复次数
+ */
+static void benchmarkFieldCipher(const QByteArray &key, int fieldSize, int rounds)
+{
+    const QByteArray plaintext(fieldSize, 'p');
+    QByteArray sealed;
+    QByteArray opened;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < rounds; ++i) {
+        FieldCipher::seal(key, plaintext, sealed);
+    }
+    const double sealNs = double(timer.nsecsElapsed()) / rounds;
+
+    timer.restart();
+    for (int i = 0; i < rounds; ++i) {
+        FieldCipher::open(key, sealed, opened);
+    }
+    const double openNs = double(timer.nsecsElapsed()) / rounds;
+
+    std::printf("%8d B  seal %9.0f ns (%8.1f MB/s)  open %9.0f ns (%8.1f MB/s)\n",
+                fieldSize, sealNs, fieldSize * 1000.0 / sealNs, openNs, fieldSize * 1000.0 / openNs);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QtSecretToolBench");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption entriesOption("entries", "Number of entries for the bulk benchmark.", "n", "20000");
+    QCommandLineOption boundOption("max-ns-per-entry", "Fail when bulk encrypt+decrypt exceeds this.", "ns", "20000");
+    parser.addOption(entriesOption);
+    parser.addOption(boundOption);
+    parser.process(app);
+
+    const int entries = qMax(1, parser.value(entriesOption).toInt());
+    const double bound = parser.value(boundOption).toDouble();
+
+    // 使用独立的配置目录
+    QStandardPaths::setTestModeEnabled(true);
+    QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).removeRecursively();
+
+    std::printf("FieldCipher (AES-256-GCM)\n");
+    const QByteArray key(FieldCipher::KEY_SIZE, 'k');
+    for (int fieldSize : {16, 64, 256, 4096, 65536}) {
+        benchmarkFieldCipher(key, fieldSize, fieldSize >= 4096 ? 20000 : 200000);
+    }
+
+    CryptoManager *crypto = CryptoManager::instance();
+    if (!crypto->initialize("bench_master_password")) {
+        qCritical() << "Failed to initialize CryptoManager";
+        return 1;
+    }
+
+    // 模拟用户名、密码和备注三个字段
+    QStringList plaintexts;
+    plaintexts.reserve(entries * FIELDS_PER_ENTRY);
+    for (int i = 0; i < entries; ++i) {
+        plaintexts.append(QString("user%1@example.com").arg(i));
+        plaintexts.append(QString("P@ssw0rd-%1-xYz!").arg(i));
+        plaintexts.append(QString("notes for entry %1, ").arg(i).repeated(4));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QList<QByteArray> ciphertexts = crypto->encryptFields(plaintexts);
+    const qint64 encryptNs = timer.nsecsElapsed();
+
+    timer.restart();
+    const QStringList decrypted = crypto->decryptFields(ciphertexts);
+    const qint64 decryptNs = timer.nsecsElapsed();
+
+    if (decrypted != plaintexts) {
+        qCritical() << "Round trip mismatch";
+        return 1;
+    }
+
+    const double perEntryNs = double(encryptNs + decryptNs) / entries;
+    std::printf("\nCryptoManager bulk, %d entries x %d fields\n", entries, FIELDS_PER_ENTRY);
+    std::printf("  encrypt %8.0f ns/entry\n", double(encryptNs) / entries);
+    std::printf("  decrypt %8.0f ns/entry\n", double(decryptNs) / entries);
+    std::printf("  total   %8.0f ns/entry (bound %.0f)\n", perEntryNs, bound);
+
+    // 同样的字段每个条目打包为一个记录信封
+    QList<QStringList> records;
+    records.reserve(entries);
+    for (int i = 0; i < entries; ++i) {
+        records.append(plaintexts.mid(i * FIELDS_PER_ENTRY, FIELDS_PER_ENTRY));
+    }
+
+    timer.restart();
+    const QList<QByteArray> envelopes = crypto->encryptRecords(records);
+    const qint64 sealRecordsNs = timer.nsecsElapsed();
+
+    timer.restart();
+    const QList<QStringList> openedRecords = crypto->decryptRecords(envelopes);
+    const qint64 openRecordsNs = timer.nsecsElapsed();
+
+    if (openedRecords != records) {
+        qCritical() << "Record envelope round trip mismatch";
+        return 1;
+    }
+
+    qint64 fieldBytes = 0;
+    for (const QByteArray &ciphertext : ciphertexts) {
+        fieldBytes += ciphertext.size();
+    }
+    qint64 envelopeBytes = 0;
+    for (const QByteArray &envelope : envelopes) {
+        envelopeBytes += envelope.size();
+    }
+
+    std::printf("\nCryptoManager record envelopes, %d entries\n", entries);
+    std::printf("  encrypt %8.0f ns/entry\n", double(sealRecordsNs) / entries);
+    std::printf("  decrypt %8.0f ns/entry\n", double(openRecordsNs) / entries);
+    std::printf("  total   %8.0f ns/entry\n", double(sealRecordsNs + openRecordsNs) / entries);
+    std::printf("  ciphertext %6.1f B/entry (separate fields %.1f B/entry)\n",
+                double(envelopeBytes) / entries, double(fieldBytes) / entries);
+
+    crypto->clear();
+    QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).removeRecursively();
+
+    if (bound > 0 && perEntryNs > bound) {
+        std::printf("FAILED: per-entry cost exceeds bound\n");
+        return 2;
+    }
+    return 0;
+}
@@ -197,6 +197,14 @@ Dialog {
             Layout.alignment: Qt.AlignRight
             spacing: 10
             
+            // 后台派生密钥时显示进度
+            BusyIndicator {
+                running: passwordManager.isLoading
+                visible: running
+                Layout.preferredWidth: 24
+                Layout.preferredHeight: 24
+            }
+            
             // 只在设置密码或更改密码时显示取消按钮
             Button {
                 visible: isFirstTime || isChangingPassword
@@ -212,7 +220,7 @@ Dialog {
             
             Button {
                 text: isFirstTime ? qsTr("设置") : (isChangingPassword ? qsTr("更改") : qsTr("确定"))
-                enabled: canProceed
+                enabled: canProceed && !passwordManager.isLoading
                 onClicked: handlePasswordAction()
                 background: Rectangle {
                     color: parent.enabled ? (parent.hovered ? "#1976D2" : "#2196F3") : "#e0e0e0"
@@ -298,12 +306,12 @@ Dialog {
             }
             
             // 调用C++方法设置密码
-            passwordManager.setMasterPassword(newPasswordField.text)
+            passwordManager.setMasterPasswordAsync(newPasswordField.text)
             
         } else {
             // 验证密码
-            // 调用C++方法验证密码
-            passwordManager.verifyMasterPassword(newPasswordField.text)
+            // 调用C++方法验证密码（密钥在后台派生，结果通过信号返回）
+            passwordManager.verifyMasterPasswordAsync(newPasswordField.text)
         }
     }
     
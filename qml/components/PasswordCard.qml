@@ -4,11 +4,18 @@ import QtQuick.Layouts 1.15
 
 /**
  * @brief 密码卡片组件
+ *
+ * 只显示列表模型角色提供的普通值，不持有PasswordItem对象，
+ * 需要编辑或删除时由使用方按ID获取
  */
 Rectangle {
     id: passwordCard
     
-    property var passwordItem: null
+    property string title: ""
+    property string username: ""
+    property string website: ""
+    property string category: ""
+    property bool isFavorite: false
     
     signal clicked()
     signal editRequested()
@@ -53,8 +60,8 @@ Rectangle {
                 
                 Text {
                     anchors.centerIn: parent
-                    text: passwordItem && passwordItem.title ? 
-                          passwordItem.title.substring(0, 1).toUpperCase() : "?"
+                    text: passwordCard.title ?
+                          passwordCard.title.substring(0, 1).toUpperCase() : "?"
                     font.pointSize: 18
                     font.bold: true
                     color: "#2196f3"
@@ -70,7 +77,7 @@ Rectangle {
                     Layout.fillWidth: true
                     
                     Text {
-                        text: passwordItem ? passwordItem.title : ""
+                        text: passwordCard.title
                         font.pointSize: 14
                         font.bold: true
                         color: "#212529"
@@ -80,14 +87,14 @@ Rectangle {
                     
                     // 收藏星标
                     Text {
-                        visible: passwordItem && passwordItem.isFavorite
+                        visible: passwordCard.isFavorite
                         text: "⭐"
                         font.pointSize: 12
                     }
                 }
                 
                 Text {
-                    text: passwordItem ? passwordItem.username : ""
+                    text: passwordCard.username
                     font.pointSize: 12
                     color: "#6c757d"
                     elide: Text.ElideRight
@@ -98,7 +105,7 @@ Rectangle {
                     Layout.fillWidth: true
                     
                     Text {
-                        text: passwordItem && passwordItem.website ? passwordItem.website : ""
+                        text: passwordCard.website
                         font.pointSize: 10
                         color: "#adb5bd"
                         elide: Text.ElideRight
@@ -106,7 +113,7 @@ Rectangle {
                     }
                     
                     Rectangle {
-                        visible: passwordItem && passwordItem.category
+                        visible: passwordCard.category !== ""
                         height: 16
                         width: categoryText.width + 8
                         radius: 8
@@ -117,7 +124,7 @@ Rectangle {
                         Text {
                             id: categoryText
                             anchors.centerIn: parent
-                            text: passwordItem ? passwordItem.category : ""
+                            text: passwordCard.category
                             font.pointSize: 8
                             color: "#0066cc"
                         }
@@ -149,10 +156,8 @@ Rectangle {
                 ToolTip.visible: hovered
                 
                 onClicked: {
-                    if (passwordItem) {
-                        // TODO: 复制密码到剪贴板
-                        console.log("Copy password for:", passwordItem.title)
-                    }
+                    // TODO: 复制密码到剪贴板
+                    console.log("Copy password for:", passwordCard.title)
                 }
             }
             
@@ -167,12 +172,12 @@ Rectangle {
                 
                 Text {
                     anchors.centerIn: parent
-                    text: passwordItem && passwordItem.isFavorite ? "⭐" : "☆"
+                    text: passwordCard.isFavorite ? "⭐" : "☆"
                     font.pointSize: 12
-                    color: passwordItem && passwordItem.isFavorite ? "#ffc107" : "#6c757d"
+                    color: passwordCard.isFavorite ? "#ffc107" : "#6c757d"
                 }
                 
-                ToolTip.text: passwordItem && passwordItem.isFavorite ? 
+                ToolTip.text: passwordCard.isFavorite ?
                               qsTr("取消收藏") : qsTr("添加收藏")
                 ToolTip.visible: hovered
                 
@@ -280,6 +280,10 @@ Rectangle {
                     text: qsTr("取消")
                     implicitWidth: 100
                     onClicked: {
+                        // 放弃编辑时清除已解密的敏感字段
+                        if (currentPasswordItem) {
+                            currentPasswordItem.wipeSecrets()
+                        }
                         clearForm()
                         cancelled()
                     }
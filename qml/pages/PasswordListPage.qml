@@ -18,6 +18,11 @@ Rectangle {
         editPasswordRequested(passwordItem)
     }
     
+    // 只在需要编辑对象时才按ID创建PasswordItem包装
+    function passwordItemById(id) {
+        return App.passwordManager.passwordListModel.getPasswordById(id)
+    }
+    
     ColumnLayout {
         anchors.fill: parent
         anchors.margins: 10
@@ -97,26 +102,35 @@ Rectangle {
                 font.pointSize: 14
             }
             
+            // 卡片只绑定普通角色，滚动时不为每行创建对象
             delegate: PasswordCard {
                 width: passwordListView.width
-                passwordItem: model.passwordItem
+                title: model.title
+                username: model.username
+                website: model.website
+                category: model.category
+                isFavorite: model.isFavorite
                 
                 onClicked: {
-                    passwordListPage.openPasswordDetails(model.passwordItem)
+                    passwordListPage.openPasswordDetails(passwordListPage.passwordItemById(model.id))
                 }
                 
                 onEditRequested: {
-                    passwordListPage.editPasswordRequested(model.passwordItem)
+                    passwordListPage.editPasswordRequested(passwordListPage.passwordItemById(model.id))
                 }
                 
                 onDeleteRequested: {
-                    deleteConfirmDialog.passwordToDelete = model.passwordItem
+                    deleteConfirmDialog.passwordIdToDelete = model.id
+                    deleteConfirmDialog.passwordTitleToDelete = model.title
                     deleteConfirmDialog.open()
                 }
                 
                 onFavoriteToggled: {
-                    model.passwordItem.isFavorite = !model.passwordItem.isFavorite
-                    App.passwordManager.updatePassword(model.passwordItem)
+                    var item = passwordListPage.passwordItemById(model.id)
+                    if (item) {
+                        item.isFavorite = !item.isFavorite
+                        App.passwordManager.updatePassword(item)
+                    }
                 }
             }
             
@@ -134,17 +148,15 @@ Rectangle {
         title: qsTr("确认删除")
         modal: true
         
-        property var passwordToDelete: null
+        property int passwordIdToDelete: -1
+        property string passwordTitleToDelete: ""
         
         ColumnLayout {
             anchors.fill: parent
             
             Text {
                 Layout.fillWidth: true
-                text: qsTr("确定要删除密码 '%1' 吗？").arg(
-                    deleteConfirmDialog.passwordToDelete ? 
-                    deleteConfirmDialog.passwordToDelete.title : ""
-                )
+                text: qsTr("确定要删除密码 '%1' 吗？").arg(deleteConfirmDialog.passwordTitleToDelete)
                 wrapMode: Text.WordWrap
                 color: "#333"
             }
@@ -167,9 +179,9 @@ Rectangle {
                     pressedColor: "#b71c1c"
                     textColor: "white"
                     onClicked: {
-                        if (deleteConfirmDialog.passwordToDelete) {
+                        if (deleteConfirmDialog.passwordIdToDelete >= 0) {
                             App.passwordManager.deletePassword(
-                                deleteConfirmDialog.passwordToDelete.id
+                                deleteConfirmDialog.passwordIdToDelete
                             )
                         }
                         deleteConfirmDialog.close()
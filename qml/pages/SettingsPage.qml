@@ -156,6 +156,51 @@ Rectangle {
                         }
                     }
                     
+                    // 备份进度
+                    ProgressBar {
+                        id: backupProgressBar
+                        Layout.fillWidth: true
+                        visible: false
+                        from: 0
+                        to: 1
+                    }
+                    
+                    RowLayout {
+                        Layout.fillWidth: true
+                        
+                        Text {
+                            text: qsTr("性能模式:")
+                            color: "#333"
+                            Layout.preferredWidth: 120
+                        }
+                        
+                        ComboBox {
+                            id: performanceProfileComboBox
+                            Layout.preferredWidth: 200
+                            textRole: "text"
+                            valueRole: "value"
+                            model: [
+                                { value: "durable", text: qsTr("持久优先（完整同步，默认）") },
+                                { value: "balanced", text: qsTr("均衡（WAL，断电可能丢失最近修改）") },
+                                { value: "fast", text: qsTr("速度优先（WAL，关闭内存清零）") }
+                            ]
+                            Component.onCompleted: currentIndex = indexOfValue(App.passwordManager.performanceProfile())
+                            onActivated: {
+                                if (!App.passwordManager.setPerformanceProfile(currentValue)) {
+                                    statusMessage.showMessage(App.passwordManager.lastError, true)
+                                }
+                            }
+                        }
+                        
+                        Item { Layout.fillWidth: true }
+                    }
+                    
+                    CheckBox {
+                        text: qsTr("合并加密敏感字段（记录信封，加载更快）")
+                        Component.onCompleted: checked = App.passwordManager.recordEnvelopeEnabled()
+                        onToggled: App.passwordManager.setRecordEnvelopeEnabled(checked)
+                    }
+                    
                     RowLayout {
                         Layout.fillWidth: true
                         spacing: 10
@@ -165,11 +210,29 @@ Rectangle {
                             onClicked: backupFileDialog.open()
                         }
                         
+                        Button {
+                            text: qsTr("增量备份")
+                            enabled: !App.passwordManager.isLoading
+                            onClicked: snapshotFolderDialog.open()
+                        }
+                        
                         Button {
                             text: qsTr("恢复数据")
                             onClicked: restoreFileDialog.open()
                         }
                         
+                        Button {
+                            text: qsTr("压缩数据库")
+                            enabled: !App.passwordManager.isLoading
+                            onClicked: App.passwordManager.compactDatabase()
+                        }
+                        
+                        Button {
+                            text: qsTr("检查完整性")
+                            enabled: !App.passwordManager.isLoading
+                            onClicked: App.passwordManager.checkDatabaseIntegrity()
+                        }
+                        
                         Button {
                             text: qsTr("清除所有数据")
                             enabled: false  // 需要确认对话框
@@ -237,6 +300,26 @@ Rectangle {
                         Item { Layout.fillWidth: true }
                     }
                     
+                    // 导入进度
+                    RowLayout {
+                        id: importProgressRow
+                        Layout.fillWidth: true
+                        spacing: 10
+                        visible: false
+                        
+                        ProgressBar {
+                            id: importProgressBar
+                            Layout.fillWidth: true
+                            from: 0
+                            to: 1
+                        }
+                        
+                        Button {
+                            text: qsTr("取消导入")
+                            onClicked: App.passwordManager.cancelImport()
+                        }
+                    }
+                    
                     CheckBox {
                         text: qsTr("导出时包含密码明文（不推荐）")
                         id: includePasswordsCheckBox
@@ -314,6 +397,65 @@ Rectangle {
         }
     }
     
+    // 后台数据库维护任务的结果
+    Connections {
+        target: App.passwordManager
+        
+        function onBackupProgress(copiedPages, totalPages) {
+            backupProgressBar.visible = true
+            backupProgressBar.to = Math.max(totalPages, 1)
+            backupProgressBar.value = copiedPages
+        }
+        
+        function onBackupFinished(success) {
+            backupProgressBar.visible = false
+            if (success) {
+                statusMessage.showMessage(qsTr("备份成功"), false)
+            } else {
+                statusMessage.showMessage(qsTr("备份失败: ") + App.passwordManager.lastError, true)
+            }
+        }
+        
+        function onCompactFinished(success) {
+            if (success) {
+                statusMessage.showMessage(qsTr("压缩完成"), false)
+            } else {
+                statusMessage.showMessage(qsTr("压缩失败: ") + App.passwordManager.lastError, true)
+            }
+        }
+        
+        function onExportFinished(success) {
+            if (success) {
+                statusMessage.showMessage(qsTr("导出成功"), false)
+            } else {
+                statusMessage.showMessage(App.passwordManager.lastError, true)
+            }
+        }
+        
+        function onImportProgress(processed, total) {
+            importProgressRow.visible = true
+            importProgressBar.to = Math.max(total, 1)
+            importProgressBar.value = processed
+        }
+        
+        function onImportFinished(success, imported, updated, skipped) {
+            importProgressRow.visible = false
+            if (success) {
+                statusMessage.showMessage(qsTr("导入完成：新增 %1，覆盖 %2，跳过 %3").arg(imported).arg(updated).arg(skipped), false)
+            } else {
+                statusMessage.showMessage(qsTr("导入失败: ") + App.passwordManager.lastError, true)
+            }
+        }
+        
+        function onIntegrityCheckFinished(ok) {
+            if (ok) {
+                statusMessage.showMessage(qsTr("数据库完整"), false)
+            } else {
+                statusMessage.showMessage(qsTr("完整性检查失败: ") + App.passwordManager.lastError, true)
+            }
+        }
+    }
+    
     // 文件对话框
     FileDialog {
         id: backupFileDialog
@@ -321,20 +463,20 @@ Rectangle {
         fileMode: FileDialog.SaveFile
         nameFilters: [qsTr("数据库文件 (*.db)"), qsTr("所有文件 (*)")]
         defaultSuffix: "db"
-        onAccepted: {
-            if (App.passwordManager.backupDatabase(selectedFile)) {
-                statusMessage.showMessage(qsTr("备份成功"), false)
-            } else {
-                statusMessage.showMessage(qsTr("备份失败: ") + App.passwordManager.lastError, true)
-            }
-        }
+        onAccepted: App.passwordManager.backupDatabase(selectedFile)
+    }
+    
+    FolderDialog {
+        id: snapshotFolderDialog
+        title: qsTr("选择增量备份仓库")
+        onAccepted: App.passwordManager.createBackupSnapshot(selectedFolder)
     }
     
     FileDialog {
         id: restoreFileDialog
         title: qsTr("选择要恢复的备份文件")
         fileMode: FileDialog.OpenFile
-        nameFilters: [qsTr("数据库文件 (*.db)"), qsTr("所有文件 (*)")]
+        nameFilters: [qsTr("数据库文件 (*.db)"), qsTr("增量备份快照 (*.manifest)"), qsTr("所有文件 (*)")]
         onAccepted: {
             if (App.passwordManager.restoreDatabase(selectedFile)) {
                 statusMessage.showMessage(qsTr("恢复成功"), false)
@@ -351,9 +493,7 @@ Rectangle {
         nameFilters: [qsTr("JSON文件 (*.json)"), qsTr("所有文件 (*)")]
         defaultSuffix: "json"
         onAccepted: {
-            if (App.passwordManager.exportToJson(selectedFile, includePasswordsCheckBox.checked)) {
-                statusMessage.showMessage(qsTr("导出成功"), false)
-            } else {
+            if (!App.passwordManager.exportToJson(selectedFile, includePasswordsCheckBox.checked)) {
                 statusMessage.showMessage(qsTr("导出失败: ") + App.passwordManager.lastError, true)
             }
         }
@@ -366,9 +506,7 @@ Rectangle {
         nameFilters: [qsTr("CSV文件 (*.csv)"), qsTr("所有文件 (*)")]
         defaultSuffix: "csv"
         onAccepted: {
-            if (App.passwordManager.exportToCsv(selectedFile, includePasswordsCheckBox.checked)) {
-                statusMessage.showMessage(qsTr("导出成功"), false)
-            } else {
+            if (!App.passwordManager.exportToCsv(selectedFile, includePasswordsCheckBox.checked)) {
                 statusMessage.showMessage(qsTr("导出失败: ") + App.passwordManager.lastError, true)
             }
         }
@@ -380,9 +518,7 @@ Rectangle {
         fileMode: FileDialog.OpenFile
         nameFilters: [qsTr("JSON文件 (*.json)"), qsTr("所有文件 (*)")]
         onAccepted: {
-            if (App.passwordManager.importFromJson(selectedFile, true)) {
-                statusMessage.showMessage(qsTr("导入成功"), false)
-            } else {
+            if (!App.passwordManager.importFromJson(selectedFile, true)) {
                 statusMessage.showMessage(qsTr("导入失败: ") + App.passwordManager.lastError, true)
             }
         }
@@ -394,9 +530,7 @@ Rectangle {
         fileMode: FileDialog.OpenFile
         nameFilters: [qsTr("CSV文件 (*.csv)"), qsTr("所有文件 (*)")]
         onAccepted: {
-            if (App.passwordManager.importFromCsv(selectedFile, true)) {
-                statusMessage.showMessage(qsTr("导入成功"), false)
-            } else {
+            if (!App.passwordManager.importFromCsv(selectedFile, true)) {
                 statusMessage.showMessage(qsTr("导入失败: ") + App.passwordManager.lastError, true)
             }
         }
@@ -2,13 +2,23 @@
 #include <QDebug>
 #include <QSettings>
 #include <QRandomGenerator>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
 #include <QFile>
 #include <QFileInfo>
-#include <QTextStream>
 #include <QStandardPaths>
+#include <QTimer>
+#include <QQmlEngine>
+#include <QPointer>
+#include "io/JsonPasswordRecordReader.h"
+#include "io/CsvPasswordRecordReader.h"
+#include "io/JsonPasswordRecordWriter.h"
+#include "io/CsvPasswordRecordWriter.h"
+
+// 分批加载密码列表时首批和后续每批的行数
+static const int FIRST_LOAD_BATCH_SIZE = 64;
+static const int LOAD_BATCH_SIZE = 512;
+
+// 搜索输入停止多久后执行查询（毫秒）
+static const int SEARCH_DEBOUNCE_MS = 150;
 
 /**
  * @brief 构造函数
@@ -20,7 +30,16 @@ PasswordManager::PasswordManager(QObject *parent)
     , m_databaseManager(DatabaseManager::instance())
     , m_passwordListModel(new PasswordListModel(this))
     , m_isLoading(false)
+    , m_loadGeneration(0)
+    , m_showingFullList(false)
+    , m_searchTimer(new QTimer(this))
+    , m_searchGeneration(0)
+    , m_exporting(false)
 {
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(SEARCH_DEBOUNCE_MS);
+    connect(m_searchTimer, &QTimer::timeout, this, &PasswordManager::runPendingSearch);
+
     // 连接加密管理器的错误信号
     connect(m_cryptoManager, &CryptoManager::cryptoError, 
             this, &PasswordManager::passwordError);
@@ -28,12 +47,11 @@ PasswordManager::PasswordManager(QObject *parent)
     // 连接数据库管理器的信号
     connect(m_databaseManager, &DatabaseManager::databaseError,
             this, &PasswordManager::setLastError);
-    connect(m_databaseManager, &DatabaseManager::passwordItemSaved,
-            this, &PasswordManager::refreshPasswordList);
-    connect(m_databaseManager, &DatabaseManager::passwordItemUpdated,
-            this, &PasswordManager::refreshPasswordList);
+    // 单个条目的写入只更新对应的一行，不重新加载整个列表
+    connect(m_databaseManager, &DatabaseManager::passwordRecordStored,
+            this, &PasswordManager::onPasswordRecordStored);
     connect(m_databaseManager, &DatabaseManager::passwordItemDeleted,
-            this, &PasswordManager::refreshPasswordList);
+            this, &PasswordManager::onPasswordItemDeleted);
 }
 
 /**
@@ -78,18 +96,14 @@ bool PasswordManager::setMasterPassword(const QString &password)
         return false;
     }
 
-    // 设置数据库密码（SQLCipher）
-    if (!m_databaseManager->setDatabasePassword(password)) {
-        setLastError("设置数据库密码失败");
+    // 只派生一次主密钥，数据库密钥和字段加密密钥都由它扩展得到
+    if (!m_cryptoManager->initialize(password)) {
+        setLastError("初始化加密管理器失败");
         return false;
     }
 
-    // 创建表结构（新库）
-    m_databaseManager->createTables();
-
-    // 初始化加密管理器
-    if (!m_cryptoManager->initialize(password)) {
-        setLastError("初始化加密管理器失败");
+    // 设置数据库密钥（SQLCipher）
+    if (!unlockDatabase(password, true)) {
         return false;
     }
 
@@ -120,15 +134,14 @@ bool PasswordManager::verifyMasterPassword(const QString &password)
         return false;
     }
 
-    // 验证数据库密码（SQLCipher）
-    if (!m_databaseManager->verifyDatabasePassword(password)) {
-        setLastError("数据库密码验证失败");
+    // 只派生一次主密钥，数据库密钥和字段加密密钥都由它扩展得到
+    if (!m_cryptoManager->initialize(password)) {
+        setLastError("初始化加密管理器失败");
         return false;
     }
 
-    // 验证成功后初始化加密管理器
-    if (!m_cryptoManager->initialize(password)) {
-        setLastError("初始化加密管理器失败");
+    // 用派生出的密钥打开数据库，密钥错误即主密码错误
+    if (!unlockDatabase(password, false)) {
         return false;
     }
 
@@ -137,6 +150,109 @@ bool PasswordManager::verifyMasterPassword(const QString &password)
     return true;
 }
 
+/**
+ * @brief 异步设置主密码
+ * @param password 主密码
+ */
+void PasswordManager::setMasterPasswordAsync(const QString &password)
+{
+    clearLastError();
+
+    if (password.isEmpty()) {
+        setLastError("主密码不能为空");
+        emit passwordError(m_lastError);
+        return;
+    }
+
+    // 先打开数据库
+    if (!m_databaseManager->openDatabase(m_databaseManager->getDatabasePath())) {
+        setLastError("打开数据库失败");
+        emit passwordError(m_lastError);
+        return;
+    }
+
+    initializeCryptoAsync(password, true, &PasswordManager::masterPasswordSet);
+}
+
+/**
+ * @brief 异步验证主密码
+ * @param password 要验证的主密码
+ */
+void PasswordManager::verifyMasterPasswordAsync(const QString &password)
+{
+    clearLastError();
+
+    if (password.isEmpty()) {
+        setLastError("主密码不能为空");
+        emit passwordError(m_lastError);
+        return;
+    }
+
+    // 先打开数据库
+    if (!m_databaseManager->openDatabase(m_databaseManager->getDatabasePath())) {
+        setLastError("打开数据库失败");
+        emit passwordError(m_lastError);
+        return;
+    }
+
+    initializeCryptoAsync(password, false, &PasswordManager::masterPasswordVerified);
+}
+
+/**
+ * @brief 异步派生加密密钥，再用派生出的数据库密钥解锁数据库，完成后发出指定的成功信号
+ * @param password 主密码
+ * @param create 是否为新数据库设置密钥
+ * @param onSuccess 成功后要执行的操作
+ */
+void PasswordManager::initializeCryptoAsync(const QString &password, bool create, void (PasswordManager::*onSuccess)())
+{
+    setLoading(true);
+    m_cryptoManager->initializeAsync(password).then(this, [this, password, create, onSuccess](bool success) {
+        setLoading(false);
+        if (!success) {
+            setLastError("初始化加密管理器失败");
+            emit passwordError(m_lastError);
+            return;
+        }
+
+        if (!unlockDatabase(password, create)) {
+            emit passwordError(m_lastError);
+            return;
+        }
+
+        qInfo() << "Crypto manager initialized in background";
+        (this->*onSuccess)();
+    });
+}
+
+/**
+ * @brief 用加密管理器派生出的数据库密钥解锁数据库
+ * @param password 主密码，仅用于迁移以口令加密的旧数据库
+ * @param create 是否为新数据库设置密钥
+ * @return 解锁是否成功
+ */
+bool PasswordManager::unlockDatabase(const QString &password, bool create)
+{
+    const QByteArray key = m_cryptoManager->databaseKey();
+    const bool unlocked = create ? m_databaseManager->setDatabaseKey(key, password)
+                                 : m_databaseManager->verifyDatabaseKey(key, password);
+    if (!unlocked) {
+        // 密钥不对时不能保留加密状态
+        m_cryptoManager->clear();
+        setLastError(create ? "设置数据库密码失败" : "数据库密码验证失败");
+        return false;
+    }
+
+    // 创建表结构（新库）
+    if (create) {
+        m_databaseManager->createTables();
+    }
+
+    // 加密管理器就绪后才能为解密后的字段建立搜索索引
+    m_databaseManager->ensureSearchIndex();
+    return true;
+}
+
 /**
  * @brief 更改主密码
  * @param oldPassword 旧主密码
@@ -150,15 +266,25 @@ bool PasswordManager::changeMasterPassword(const QString &oldPassword, const QSt
         return false;
     }
 
-    // 更改数据库密码（SQLCipher）
-    if (!m_databaseManager->changeDatabasePassword(oldPassword, newPassword)) {
-        setLastError("更改数据库密码失败");
+    if (isTransferInProgress()) {
         return false;
     }
 
-    // 更改加密管理器密码
-    if (!m_cryptoManager->changeMasterPassword(oldPassword, newPassword)) {
-        setLastError("更改加密管理器密码失败");
+    // 改写密文期间连接上不能有未读完的列表游标
+    cancelPasswordLoading();
+
+    // 新密钥只派生一次，先重新加密数据库并改写所有密文，成功后才提交
+    bool rekeyFailed = false;
+    const bool changed = m_cryptoManager->changeMasterPassword(oldPassword, newPassword,
+        [this, &rekeyFailed](const CiphertextRekeyer &rekeyer) {
+            rekeyFailed = !m_databaseManager->changeDatabaseKey(rekeyer);
+            return !rekeyFailed;
+        });
+
+    // 加载已被中断；成功时列表中的记录还持有旧密钥的密文，都需要重新加载
+    refreshPasswordList();
+    if (!changed) {
+        setLastError(rekeyFailed ? "更改数据库密码失败" : "更改加密管理器密码失败");
         return false;
     }
 
@@ -184,6 +310,9 @@ bool PasswordManager::initializeCrypto(const QString &password)
         return false;
     }
 
+    // 加密管理器就绪后才能为解密后的字段建立搜索索引
+    m_databaseManager->ensureSearchIndex();
+
     return true;
 }
 
@@ -198,7 +327,7 @@ bool PasswordManager::isCryptoInitialized() const
 
 /**
  * @brief 设置数据库密码（SQLCipher）
- * @param password 主密码
+ * @param password 主密码，数据库密钥由它派生
  * @return 设置是否成功
  */
 bool PasswordManager::setDatabasePassword(const QString &password)
@@ -208,8 +337,12 @@ bool PasswordManager::setDatabasePassword(const QString &password)
         return false;
     }
 
-    if (!m_databaseManager->setDatabasePassword(password)) {
-        setLastError("设置数据库密码失败");
+    if (!m_cryptoManager->initialize(password)) {
+        setLastError("初始化加密管理器失败");
+        return false;
+    }
+
+    if (!unlockDatabase(password, true)) {
         return false;
     }
 
@@ -219,7 +352,7 @@ bool PasswordManager::setDatabasePassword(const QString &password)
 
 /**
  * @brief 验证数据库密码（SQLCipher）
- * @param password 主密码
+ * @param password 主密码，数据库密钥由它派生
  * @return 验证是否成功
  */
 bool PasswordManager::verifyDatabasePassword(const QString &password)
@@ -229,8 +362,12 @@ bool PasswordManager::verifyDatabasePassword(const QString &password)
         return false;
     }
 
-    if (!m_databaseManager->verifyDatabasePassword(password)) {
-        setLastError("数据库密码验证失败");
+    if (!m_cryptoManager->initialize(password)) {
+        setLastError("初始化加密管理器失败");
+        return false;
+    }
+
+    if (!unlockDatabase(password, false)) {
         return false;
     }
 
@@ -240,24 +377,15 @@ bool PasswordManager::verifyDatabasePassword(const QString &password)
 
 /**
  * @brief 更改数据库密码（SQLCipher）
+ *
+ * 数据库密钥由主密码派生，只能与主密码一起更改
  * @param oldPassword 旧密码
  * @param newPassword 新密码
  * @return 更改是否成功
  */
 bool PasswordManager::changeDatabasePassword(const QString &oldPassword, const QString &newPassword)
 {
-    if (oldPassword.isEmpty() || newPassword.isEmpty()) {
-        setLastError("密码不能为空");
-        return false;
-    }
-
-    if (!m_databaseManager->changeDatabasePassword(oldPassword, newPassword)) {
-        setLastError("更改数据库密码失败");
-        return false;
-    }
-
-    qInfo() << "Database password changed successfully";
-    return true;
+    return changeMasterPassword(oldPassword, newPassword);
 }
 
 /**
@@ -348,6 +476,9 @@ QString PasswordManager::generatePassword(int length, bool includeSymbols)
 
 /**
  * @brief 创建密码项目
+ *
+ * 新项目只在QML中短暂使用（保存后列表会重新加载），交给QML引擎管理，
+ * 不再挂在PasswordManager下随会话累积
  */
 PasswordItem* PasswordManager::createPasswordItem(const QString &title, 
                                                 const QString &username, 
@@ -356,7 +487,8 @@ PasswordItem* PasswordManager::createPasswordItem(const QString &title,
                                                 const QString &notes,
                                                 const QString &category)
 {
-    PasswordItem *item = new PasswordItem(title, username, password, website, notes, category, this);
+    PasswordItem *item = new PasswordItem(title, username, password, website, notes, category);
+    QQmlEngine::setObjectOwnership(item, QQmlEngine::JavaScriptOwnership);
     return item;
 }
 
@@ -369,6 +501,9 @@ bool PasswordManager::savePassword(PasswordItem *item)
         setLastError("密码项目为空");
         return false;
     }
+    if (isTransferInProgress()) {
+        return false;
+    }
 
     setLoading(true);
     clearLastError();
@@ -393,6 +528,9 @@ bool PasswordManager::updatePassword(PasswordItem *item)
         setLastError("密码项目为空");
         return false;
     }
+    if (isTransferInProgress()) {
+        return false;
+    }
 
     setLoading(true);
     clearLastError();
@@ -412,6 +550,9 @@ bool PasswordManager::updatePassword(PasswordItem *item)
  */
 bool PasswordManager::deletePassword(int id)
 {
+    if (isTransferInProgress()) {
+        return false;
+    }
     setLoading(true);
     clearLastError();
 
@@ -430,13 +571,56 @@ bool PasswordManager::deletePassword(int id)
  */
 void PasswordManager::searchPasswords(const QString &searchTerm)
 {
-    setLoading(true);
-    
-    QList<PasswordItem*> items = m_databaseManager->searchPasswordItems(searchTerm);
-    m_passwordListModel->setPasswordItems(items);
-    
-    setLoading(false);
-    emit totalPasswordsCountChanged();
+    m_searchTerm = searchTerm.trimmed();
+    m_searchTimer->start();
+}
+
+/**
+ * @brief 执行最近一次输入的搜索
+ */
+void PasswordManager::runPendingSearch()
+{
+    const quint64 generation = ++m_searchGeneration;
+
+    if (m_searchTerm.isEmpty()) {
+        m_passwordListModel->clearIdFilter();
+        m_passwordListModel->setSearchFilter(QString());
+        return;
+    }
+
+    // 搜索范围是完整列表；之前显示的是收藏或分类结果时先重新加载。
+    // 不能调用refreshPasswordList()，它会重启防抖定时器使搜索再执行一次
+    if (!m_showingFullList) {
+        reloadPasswordList();
+    }
+
+    // 没有全文索引或搜索词短于trigram时使用列表模型的内存索引
+    if (!m_databaseManager->hasSearchIndex() || !DatabaseManager::isIndexSearchable(m_searchTerm)) {
+        m_passwordListModel->clearIdFilter();
+        m_passwordListModel->setSearchFilter(m_searchTerm);
+        return;
+    }
+
+    m_databaseManager->searchPasswordIdsAsync(m_searchTerm).then(this, [this, generation](const QList<int> &ids) {
+        // 输入已经变化，结果作废
+        if (generation != m_searchGeneration) {
+            return;
+        }
+        m_passwordListModel->setSearchFilter(QString());
+        m_passwordListModel->setIdFilter(ids);
+    });
+}
+
+/**
+ * @brief 取消当前搜索并清除搜索过滤
+ */
+void PasswordManager::resetSearch()
+{
+    m_searchTimer->stop();
+    m_searchTerm.clear();
+    ++m_searchGeneration;
+    m_passwordListModel->clearIdFilter();
+    m_passwordListModel->setSearchFilter(QString());
 }
 
 /**
@@ -446,14 +630,15 @@ void PasswordManager::showFavoritesOnly(bool showOnly)
 {
     setLoading(true);
     
-    QList<PasswordItem*> items;
-    if (showOnly) {
-        items = m_databaseManager->getFavoritePasswordItems();
-    } else {
-        items = m_databaseManager->getAllPasswordItems();
+    if (!showOnly) {
+        refreshPasswordList();
+        return;
     }
-    
-    m_passwordListModel->setPasswordItems(items);
+
+    cancelPasswordLoading();
+    resetSearch();
+    m_showingFullList = false;
+    m_passwordListModel->setPasswordRecords(m_databaseManager->getFavoritePasswordRecords());
     setLoading(false);
     emit totalPasswordsCountChanged();
 }
@@ -463,13 +648,8 @@ void PasswordManager::showFavoritesOnly(bool showOnly)
  */
 void PasswordManager::clearFilters()
 {
-    setLoading(true);
-    
-    QList<PasswordItem*> items = m_databaseManager->getAllPasswordItems();
-    m_passwordListModel->setPasswordItems(items);
-    
-    setLoading(false);
-    emit totalPasswordsCountChanged();
+    resetSearch();
+    refreshPasswordList();
 }
 
 /**
@@ -479,8 +659,10 @@ void PasswordManager::filterByCategory(const QString &category)
 {
     setLoading(true);
     
-    QList<PasswordItem*> items = m_databaseManager->getPasswordItemsByCategory(category);
-    m_passwordListModel->setPasswordItems(items);
+    cancelPasswordLoading();
+    resetSearch();
+    m_showingFullList = false;
+    m_passwordListModel->setPasswordRecords(m_databaseManager->getPasswordRecordsByCategory(category));
     
     setLoading(false);
     emit totalPasswordsCountChanged();
@@ -491,31 +673,107 @@ void PasswordManager::filterByCategory(const QString &category)
  */
 QStringList PasswordManager::getCategories()
 {
-    QStringList categories;
-    QList<PasswordItem*> items = m_databaseManager->getAllPasswordItems();
-    
-    for (PasswordItem *item : items) {
-        if (!item->category().isEmpty() && !categories.contains(item->category())) {
-            categories.append(item->category());
-        }
-    }
-    
-    categories.sort();
-    return categories;
+    return m_databaseManager->getCategories();
 }
 
 /**
  * @brief 刷新密码列表
+ *
+ * 首批数据同步加载以便立即显示第一屏，其余数据在事件循环空闲时分批追加
  */
 void PasswordManager::refreshPasswordList()
+{
+    reloadPasswordList();
+
+    // 列表内容变化后重新执行当前搜索，使新增或修改的项目也能被过滤
+    if (!m_searchTerm.isEmpty()) {
+        m_searchTimer->start();
+    }
+}
+
+/**
+ * @brief 把刚保存或更新的记录合并到列表模型
+ * @param record 写入后的密码记录
+ */
+void PasswordManager::onPasswordRecordStored(const PasswordRecord &record)
+{
+    // 收藏或分类视图只替换已显示的条目，新条目在下次刷新时出现
+    const bool isNew = !m_passwordListModel->containsPassword(record.id);
+    if (isNew && !m_showingFullList) {
+        return;
+    }
+
+    m_passwordListModel->upsertPasswordRecords({record});
+    emit totalPasswordsCountChanged();
+    // 修改后的条目可能不再匹配或开始匹配当前搜索
+    if (!m_searchTerm.isEmpty()) {
+        m_searchTimer->start();
+    }
+}
+
+/**
+ * @brief 从列表模型中移除已删除的条目
+ * @param id 删除的密码项目ID
+ */
+void PasswordManager::onPasswordItemDeleted(int id)
+{
+    if (!m_passwordListModel->containsPassword(id)) {
+        return;
+    }
+    m_passwordListModel->removePasswordById(id);
+    emit totalPasswordsCountChanged();
+}
+
+/**
+ * @brief 开始分批重新加载完整列表
+ */
+void PasswordManager::reloadPasswordList()
 {
     setLoading(true);
-    
-    QList<PasswordItem*> items = m_databaseManager->getAllPasswordItems();
-    m_passwordListModel->setPasswordItems(items);
-    
-    setLoading(false);
+
+    // 递增批次编号，使尚未执行的旧加载任务失效
+    const quint64 generation = ++m_loadGeneration;
+    m_showingFullList = true;
+    m_passwordListModel->clear();
+    m_loadCursor = m_databaseManager->openPasswordCursor();
+    loadNextPasswordBatch(generation);
+}
+
+/**
+ * @brief 取消正在进行的分批加载
+ */
+void PasswordManager::cancelPasswordLoading()
+{
+    ++m_loadGeneration;
+    m_loadCursor = PasswordRecordCursor();
+}
+
+/**
+ * @brief 从加载游标读取下一批密码并追加到列表模型
+ * @param generation 发起加载时的批次编号
+ */
+void PasswordManager::loadNextPasswordBatch(quint64 generation)
+{
+    if (generation != m_loadGeneration) {
+        return;
+    }
+
+    const int batchSize = m_passwordListModel->totalCount() == 0
+                              ? FIRST_LOAD_BATCH_SIZE : LOAD_BATCH_SIZE;
+    m_passwordListModel->appendPasswordRecords(m_loadCursor.fetchBatch(batchSize));
     emit totalPasswordsCountChanged();
+
+    if (m_loadCursor.atEnd()) {
+        m_loadCursor = PasswordRecordCursor();
+        // 刷新前的包装对象如果没有被重新加载，此时清除并删除
+        m_passwordListModel->releaseStaleItems();
+        setLoading(false);
+        return;
+    }
+
+    QTimer::singleShot(0, this, [this, generation]() {
+        loadNextPasswordBatch(generation);
+    });
 }
 
 /**
@@ -528,20 +786,148 @@ int PasswordManager::totalPasswordsCount() const
 
 /**
  * @brief 备份数据库
+ *
+ * 在数据库线程中执行，完成后发出backupFinished信号
  */
-bool PasswordManager::backupDatabase(const QString &filePath)
+void PasswordManager::backupDatabase(const QString &filePath)
 {
     setLoading(true);
     clearLastError();
 
-    bool success = m_databaseManager->backupDatabase(filePath);
-    setLoading(false);
-    
-    if (!success) {
-        setLastError("备份数据库失败");
+    const QPointer<PasswordManager> self(this);
+    auto progress = [self](int copiedPages, int totalPages) {
+        QMetaObject::invokeMethod(self, [self, copiedPages, totalPages]() {
+            if (self) {
+                emit self->backupProgress(copiedPages, totalPages);
+            }
+        }, Qt::QueuedConnection);
+        return true;
+    };
+
+    m_databaseManager->backupDatabaseAsync(filePath, progress).then(this, [this](bool success) {
+        setLoading(false);
+        if (!success) {
+            setLastError("备份数据库失败");
+        }
+        emit backupFinished(success);
+    });
+}
+
+/**
+ * @brief 创建增量备份快照
+ *
+ * 在数据库线程中执行，完成后发出backupFinished信号
+ */
+void PasswordManager::createBackupSnapshot(const QString &repositoryPath)
+{
+    setLoading(true);
+    clearLastError();
+
+    m_databaseManager->createBackupSnapshotAsync(repositoryPath).then(this, [this](bool success) {
+        setLoading(false);
+        if (!success) {
+            setLastError("创建增量备份失败");
+        }
+        emit backupFinished(success);
+    });
+}
+
+/**
+ * @brief 获取可选的数据库性能配置名
+ */
+QStringList PasswordManager::performanceProfiles() const
+{
+    QStringList names;
+    for (const PerformanceProfile &profile : PerformanceProfile::builtinProfiles()) {
+        names.append(profile.name);
     }
-    
-    return success;
+    return names;
+}
+
+/**
+ * @brief 获取当前选择的数据库性能配置名
+ */
+QString PasswordManager::performanceProfile() const
+{
+    return PerformanceProfile::load().name;
+}
+
+/**
+ * @brief 选择数据库性能配置
+ */
+bool PasswordManager::setPerformanceProfile(const QString &name)
+{
+    clearLastError();
+    if (isTransferInProgress()) {
+        return false;
+    }
+    if (!m_databaseManager->setPerformanceProfile(name)) {
+        setLastError("部分性能设置未能应用，将在下次打开数据库时生效");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 新保存的条目是否使用记录信封
+ */
+bool PasswordManager::recordEnvelopeEnabled() const
+{
+    return m_databaseManager->recordEnvelopeEnabled();
+}
+
+/**
+ * @brief 选择新保存条目的敏感字段格式
+ */
+void PasswordManager::setRecordEnvelopeEnabled(bool enabled)
+{
+    m_databaseManager->setRecordEnvelopeEnabled(enabled);
+}
+
+/**
+ * @brief 压缩数据库
+ *
+ * 在数据库线程中执行VACUUM，完成后发出compactFinished信号。
+ * 列表仍在分批加载时先停止加载游标，否则VACUUM会因语句未完成而失败，
+ * 压缩结束后重新加载
+ */
+void PasswordManager::compactDatabase()
+{
+    setLoading(true);
+    clearLastError();
+
+    const bool interruptedLoading = m_loadCursor.isValid() && !m_loadCursor.atEnd();
+    cancelPasswordLoading();
+
+    m_databaseManager->compactDatabaseAsync().then(this, [this, interruptedLoading](bool success) {
+        setLoading(false);
+        if (!success) {
+            setLastError("压缩数据库失败");
+        }
+        emit compactFinished(success);
+        if (interruptedLoading) {
+            reloadPasswordList();
+        }
+    });
+}
+
+/**
+ * @brief 检查数据库完整性
+ *
+ * 在数据库线程中执行，完成后发出integrityCheckFinished信号
+ */
+void PasswordManager::checkDatabaseIntegrity()
+{
+    setLoading(true);
+    clearLastError();
+
+    m_databaseManager->checkIntegrityAsync().then(this, [this](bool ok) {
+        setLoading(false);
+        if (!ok) {
+            setLastError("数据库完整性检查未通过");
+        }
+        emit integrityCheckFinished(ok);
+    });
 }
 
 /**
@@ -549,6 +935,10 @@ bool PasswordManager::backupDatabase(const QString &filePath)
  */
 bool PasswordManager::restoreDatabase(const QString &filePath)
 {
+    // 恢复前要关闭连接，会一直等到数据库线程中的任务结束
+    if (isTransferInProgress()) {
+        return false;
+    }
     setLoading(true);
     clearLastError();
 
@@ -569,40 +959,7 @@ bool PasswordManager::restoreDatabase(const QString &filePath)
  */
 bool PasswordManager::exportToJson(const QString &filePath, bool includePasswords)
 {
-    setLoading(true);
-    clearLastError();
-
-    QList<PasswordItem*> items = m_databaseManager->getAllPasswordItems();
-    QJsonArray jsonArray;
-    
-    for (PasswordItem *item : items) {
-        QJsonObject jsonItem;
-        jsonItem["title"] = item->title();
-        jsonItem["username"] = includePasswords ? item->username() : "";
-        jsonItem["password"] = includePasswords ? item->password() : "";
-        jsonItem["website"] = item->website();
-        jsonItem["notes"] = includePasswords ? item->notes() : "";
-        jsonItem["category"] = item->category();
-        jsonItem["created_at"] = item->createdAt().toString(Qt::ISODate);
-        jsonItem["updated_at"] = item->updatedAt().toString(Qt::ISODate);
-        jsonItem["is_favorite"] = item->isFavorite();
-        
-        jsonArray.append(jsonItem);
-    }
-    
-    QJsonDocument doc(jsonArray);
-    QFile file(filePath);
-    
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        file.close();
-        setLoading(false);
-        return true;
-    } else {
-        setLastError("导出JSON失败");
-        setLoading(false);
-        return false;
-    }
+    return startExport(std::make_shared<JsonPasswordRecordWriter>(includePasswords), filePath);
 }
 
 /**
@@ -610,52 +967,44 @@ bool PasswordManager::exportToJson(const QString &filePath, bool includePassword
  */
 bool PasswordManager::exportToCsv(const QString &filePath, bool includePasswords)
 {
-    setLoading(true);
-    clearLastError();
+    return startExport(std::make_shared<CsvPasswordRecordWriter>(includePasswords), filePath);
+}
 
-    QList<PasswordItem*> items = m_databaseManager->getAllPasswordItems();
-    QFile file(filePath);
-    
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream stream(&file);
-        stream.setEncoding(QStringConverter::Utf8);
-        
-        // 写入标题行
-        stream << "Title,Username,Password,Website,Notes,Category,Created At,Updated At,Is Favorite\n";
-        
-        // 写入数据行
-        for (PasswordItem *item : items) {
-            QStringList fields;
-            fields << item->title();
-            fields << (includePasswords ? item->username() : "");
-            fields << (includePasswords ? item->password() : "");
-            fields << item->website();
-            fields << (includePasswords ? item->notes() : "");
-            fields << item->category();
-            fields << item->createdAt().toString(Qt::ISODate);
-            fields << item->updatedAt().toString(Qt::ISODate);
-            fields << (item->isFavorite() ? "true" : "false");
-            
-            // 转义CSV字段
-            for (int i = 0; i < fields.size(); ++i) {
-                QString field = fields[i];
-                if (field.contains(",") || field.contains("\"") || field.contains("\n")) {
-                    field = "\"" + field.replace("\"", "\"\"") + "\"";
-                    fields[i] = field;
-                }
-            }
-            
-            stream << fields.join(",") << "\n";
-        }
-        
-        file.close();
-        setLoading(false);
-        return true;
-    } else {
-        setLastError("导出CSV失败");
-        setLoading(false);
+/**
+ * @brief 在数据库线程中把所有密码逐条写入导出文件
+ *
+ * 记录在单独只读连接的读事务中按批解密并立即写出，完成后发出exportFinished信号
+ * @param writer 导出文件写入器，由导出任务持有直到完成
+ * @param filePath 导出文件路径
+ * @return 导出任务是否已开始
+ */
+bool PasswordManager::startExport(std::shared_ptr<PasswordRecordWriter> writer, const QString &filePath)
+{
+    clearLastError();
+    if (!writer->open(filePath)) {
+        setLastError("无法创建导出文件: " + writer->errorString());
         return false;
     }
+    setLoading(true);
+
+    m_exporting = true;
+    DatabaseManager *databaseManager = m_databaseManager;
+    databaseManager->executor()->submitLongRunning([databaseManager, writer]() {
+        // 不导出敏感字段时不必解密
+        const bool completed = databaseManager->forEachPasswordRecord([&writer](const PasswordRecord &record) {
+            return writer->writeRecord(record);
+        }, writer->includesSecrets());
+        return completed && writer->finish();
+    }).then(this, [this, writer](bool success) {
+        m_exporting = false;
+        setLoading(false);
+        if (!success) {
+            const QString reason = writer->errorString();
+            setLastError(reason.isEmpty() ? QStringLiteral("导出失败") : "导出失败: " + reason);
+        }
+        emit exportFinished(success);
+    });
+    return true;
 }
 
 /**
@@ -663,58 +1012,19 @@ bool PasswordManager::exportToCsv(const QString &filePath, bool includePasswords
  */
 bool PasswordManager::importFromJson(const QString &filePath, bool overwrite)
 {
-    setLoading(true);
-    clearLastError();
-
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        setLastError("无法打开JSON文件");
-        setLoading(false);
-        return false;
-    }
-    
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    if (!doc.isArray()) {
-        setLastError("JSON格式错误");
-        setLoading(false);
+    if (m_importCancelled) {
+        setLastError("已有导入任务正在进行");
         return false;
     }
-    
-    QJsonArray jsonArray = doc.array();
-    int successCount = 0;
-    
-    for (const QJsonValue &value : jsonArray) {
-        if (value.isObject()) {
-            QJsonObject obj = value.toObject();
-            
-            PasswordItem *item = new PasswordItem(
-                obj["title"].toString(),
-                obj["username"].toString(),
-                obj["password"].toString(),
-                obj["website"].toString(),
-                obj["notes"].toString(),
-                obj["category"].toString()
-            );
-            
-            item->setCreatedAt(QDateTime::fromString(obj["created_at"].toString(), Qt::ISODate));
-            item->setUpdatedAt(QDateTime::fromString(obj["updated_at"].toString(), Qt::ISODate));
-            item->setIsFavorite(obj["is_favorite"].toBool());
-            
-            if (m_databaseManager->savePasswordItem(item) > 0) {
-                successCount++;
-            }
-        }
-    }
-    
-    setLoading(false);
-    refreshPasswordList();
-    
-    if (successCount == 0) {
-        setLastError("导入失败，没有成功导入任何密码");
+    clearLastError();
+
+    // 只在这里打开文件，解析在数据库线程中边读边写
+    auto reader = std::make_shared<JsonPasswordRecordReader>();
+    if (!reader->open(filePath)) {
+        setLastError(reader->errorString());
         return false;
     }
-    
-    return true;
+    return startImport(std::move(reader), overwrite);
 }
 
 /**
@@ -722,70 +1032,98 @@ bool PasswordManager::importFromJson(const QString &filePath, bool overwrite)
  */
 bool PasswordManager::importFromCsv(const QString &filePath, bool overwrite)
 {
-    setLoading(true);
+    if (m_importCancelled) {
+        setLastError("已有导入任务正在进行");
+        return false;
+    }
     clearLastError();
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        setLastError("无法打开CSV文件");
-        setLoading(false);
+    // 只在这里打开文件并跳过标题行，解析在数据库线程中分批并行进行
+    auto reader = std::make_shared<CsvPasswordRecordReader>();
+    if (!reader->open(filePath)) {
+        setLastError(reader->errorString());
         return false;
     }
-    
-    QTextStream stream(&file);
-    stream.setEncoding(QStringConverter::Utf8);
-    
-    // 跳过标题行
-    QString line = stream.readLine();
-    if (line.isNull()) {
-        setLastError("CSV文件为空");
+    return startImport(std::move(reader), overwrite);
+}
+
+/**
+ * @brief 在数据库线程中从数据源批量导入记录
+ *
+ * 进度通过importProgress信号报告，完成后把写入的记录一次性合并到列表模型
+ * （写入过多时改为重新加载列表），并发出importFinished信号
+ * @param reader 导入数据源
+ * @param overwrite 是否覆盖重复的已有条目
+ * @return 导入任务是否已开始
+ */
+bool PasswordManager::startImport(std::shared_ptr<PasswordRecordReader> reader, bool overwrite)
+{
+    setLoading(true);
+    m_importCancelled = std::make_shared<std::atomic<bool>>(false);
+    emit importProgress(0, reader->progressMaximum());
+
+    const auto cancelled = m_importCancelled;
+    const QPointer<PasswordManager> self(this);
+    auto progress = [cancelled, self](qint64 processed, qint64 total) {
+        QMetaObject::invokeMethod(self, [self, processed, total]() {
+            if (self) {
+                emit self->importProgress(processed, total);
+            }
+        }, Qt::QueuedConnection);
+        return !cancelled->load();
+    };
+
+    DatabaseManager *databaseManager = m_databaseManager;
+    databaseManager->executor()->submitLongRunning([databaseManager, reader = std::move(reader), overwrite, progress]() {
+        return databaseManager->importPasswordRecords(*reader, overwrite, progress);
+    }).then(this, [this](PasswordImportResult result) {
+        m_importCancelled.reset();
         setLoading(false);
-        return false;
-    }
-    
-    int successCount = 0;
-    while (!stream.atEnd()) {
-        line = stream.readLine();
-        if (line.isNull()) break;
-        
-        QStringList fields = parseCsvLine(line);
-        if (fields.size() >= 9) {
-            PasswordItem *item = new PasswordItem(
-                fields[0], // title
-                fields[1], // username
-                fields[2], // password
-                fields[3], // website
-                fields[4], // notes
-                fields[5]  // category
-            );
-            
-            item->setCreatedAt(QDateTime::fromString(fields[6], Qt::ISODate));
-            item->setUpdatedAt(QDateTime::fromString(fields[7], Qt::ISODate));
-            item->setIsFavorite(fields[8] == "true");
-            
-            if (m_databaseManager->savePasswordItem(item) > 0) {
-                successCount++;
+
+        // 只有显示完整列表时才合并，收藏或分类视图在下次刷新时更新；
+        // 写入条目过多时结果中没有记录，改为分批重新加载
+        const int written = result.imported + result.updated;
+        if (m_showingFullList && written > 0) {
+            if (result.reloadRequired) {
+                refreshPasswordList();
+            } else {
+                m_passwordListModel->upsertPasswordRecords(std::move(result.records));
+                if (!m_searchTerm.isEmpty()) {
+                    m_searchTimer->start();
+                }
             }
+            emit totalPasswordsCountChanged();
         }
-    }
-    
-    file.close();
-    setLoading(false);
-    refreshPasswordList();
-    
-    if (successCount == 0) {
-        setLastError("导入失败，没有成功导入任何密码");
-        return false;
-    }
-    
+
+        const bool success = result.error.isEmpty() && (written > 0 || result.skipped > 0);
+        if (!result.error.isEmpty()) {
+            setLastError(result.error);
+        } else if (!success) {
+            setLastError("导入失败，没有成功导入任何密码");
+        }
+        emit importFinished(success, result.imported, result.updated, result.skipped);
+    });
     return true;
 }
 
+/**
+ * @brief 取消正在进行的导入，已提交的批次保留
+ */
+void PasswordManager::cancelImport()
+{
+    if (m_importCancelled) {
+        m_importCancelled->store(true);
+    }
+}
+
 /**
  * @brief 清除所有密码
  */
 bool PasswordManager::clearAllPasswords()
 {
+    if (isTransferInProgress()) {
+        return false;
+    }
     setLoading(true);
     clearLastError();
 
@@ -801,6 +1139,27 @@ bool PasswordManager::clearAllPasswords()
     return success;
 }
 
+/**
+ * @brief 检查是否有导入、导出或数据库维护任务正在进行
+ *
+ * 写操作与这些任务在同一数据库线程中串行执行，期间的修改会一直等到任务结束，
+ * 因此直接拒绝并提示稍后再试
+ * @return 有这类任务时设置错误信息并返回true
+ */
+bool PasswordManager::isTransferInProgress()
+{
+    if (m_importCancelled || m_exporting) {
+        setLastError("正在导入或导出，请在完成后再修改");
+        return true;
+    }
+    // 压缩、备份、快照和完整性检查期间写操作要等它们结束，直接拒绝而不卡住界面
+    if (m_databaseManager->executor()->hasLongRunningTasks()) {
+        setLastError("正在进行数据库维护，请在完成后再修改");
+        return true;
+    }
+    return false;
+}
+
 /**
  * @brief 设置加载状态
  */
@@ -830,39 +1189,4 @@ void PasswordManager::clearLastError()
 {
     setLastError("");
 }
-
-/**
- * @brief 解析CSV行
- */
-QStringList PasswordManager::parseCsvLine(const QString &line)
-{
-    QStringList fields;
-    QString currentField;
-    bool inQuotes = false;
-    
-    for (int i = 0; i < line.length(); ++i) {
-        QChar ch = line[i];
-        
-        if (ch == '"') {
-            if (inQuotes && i + 1 < line.length() && line[i + 1] == '"') {
-                // 转义的引号
-                currentField += '"';
-                i++; // 跳过下一个引号
-            } else {
-                // 开始或结束引号
-                inQuotes = !inQuotes;
-            }
-        } else if (ch == ',' && !inQuotes) {
-            // 字段分隔符
-            fields.append(currentField);
-            currentField.clear();
-        } else {
-            currentField += ch;
-        }
-    }
-    
-    // 添加最后一个字段
-    fields.append(currentField);
-    
-    return fields;
-} 
\ No newline at end of file
+ 
\ No newline at end of file
@@ -5,11 +5,16 @@
 #include <QString>
 #include <QList>
 #include <QVariant>
+#include <QTimer>
+#include <atomic>
+#include <memory>
 #include "crypto/CryptoManager.h"
 #include "models/PasswordItem.h"
 #include "models/PasswordListModel.h"
 #include "database/DatabaseManager.h"
 
+class PasswordRecordWriter;
+
 /**
  * @brief 密码管理器类
  * 
@@ -56,6 +61,24 @@ public:
      */
     Q_INVOKABLE bool verifyMasterPassword(const QString &password);
 
+    /**
+     * @brief 异步设置主密码
+     *
+     * 加密密钥在后台线程派生，完成后发出masterPasswordSet信号，
+     * 失败时设置lastError并发出passwordError信号
+     * @param password 主密码
+     */
+    Q_INVOKABLE void setMasterPasswordAsync(const QString &password);
+
+    /**
+     * @brief 异步验证主密码
+     *
+     * 加密密钥在后台线程派生，完成后发出masterPasswordVerified信号，
+     * 失败时设置lastError并发出passwordError信号
+     * @param password 要验证的主密码
+     */
+    Q_INVOKABLE void verifyMasterPasswordAsync(const QString &password);
+
     /**
      * @brief 更改主密码
      * @param oldPassword 旧主密码
@@ -92,7 +115,7 @@ public:
     Q_INVOKABLE bool verifyDatabasePassword(const QString &password);
 
     /**
-     * @brief 更改数据库密码（SQLCipher）
+     * @brief 更改数据库密码（SQLCipher），与更改主密码相同
      * @param oldPassword 旧密码
      * @param newPassword 新密码
      * @return 更改是否成功
@@ -160,6 +183,10 @@ public:
 
     /**
      * @brief 搜索密码
+     *
+     * 连续输入会被合并，只有停止输入一段时间后才执行查询。查询在工作线程中
+     * 通过全文索引完成，结果只作为ID过滤应用到已有的列表模型上；
+     * 被更新的搜索取代的旧结果会被丢弃
      * @param searchTerm 搜索词
      */
     Q_INVOKABLE void searchPasswords(const QString &searchTerm);
@@ -194,11 +221,57 @@ public:
 
     // 数据库管理方法
     /**
-     * @brief 备份数据库
+     * @brief 在后台分步备份数据库，期间发出backupProgress信号，完成后发出backupFinished信号
      * @param filePath 备份文件路径
-     * @return 备份是否成功
      */
-    Q_INVOKABLE bool backupDatabase(const QString &filePath);
+    Q_INVOKABLE void backupDatabase(const QString &filePath);
+
+    /**
+     * @brief 在后台向去重的备份仓库写入增量快照，完成后发出backupFinished信号
+     * @param repositoryPath 备份仓库目录
+     */
+    Q_INVOKABLE void createBackupSnapshot(const QString &repositoryPath);
+
+    /**
+     * @brief 获取可选的数据库性能配置名
+     * @return 按持久性从高到低排列的配置名列表
+     */
+    Q_INVOKABLE QStringList performanceProfiles() const;
+
+    /**
+     * @brief 获取当前选择的数据库性能配置名
+     * @return 配置名
+     */
+    Q_INVOKABLE QString performanceProfile() const;
+
+    /**
+     * @brief 选择数据库性能配置，保存后立即应用到当前连接
+     * @param name 配置名
+     * @return 应用是否成功
+     */
+    Q_INVOKABLE bool setPerformanceProfile(const QString &name);
+
+    /**
+     * @brief 新保存的条目是否把敏感字段打包为一个记录信封加密
+     * @return 启用时返回true
+     */
+    Q_INVOKABLE bool recordEnvelopeEnabled() const;
+
+    /**
+     * @brief 选择新保存条目的敏感字段格式，已有条目在下次保存时改写
+     * @param enabled 是否启用记录信封
+     */
+    Q_INVOKABLE void setRecordEnvelopeEnabled(bool enabled);
+
+    /**
+     * @brief 在后台压缩数据库，完成后发出compactFinished信号
+     */
+    Q_INVOKABLE void compactDatabase();
+
+    /**
+     * @brief 在后台检查数据库完整性，完成后发出integrityCheckFinished信号
+     */
+    Q_INVOKABLE void checkDatabaseIntegrity();
 
     /**
      * @brief 恢复数据库
@@ -208,37 +281,42 @@ public:
     Q_INVOKABLE bool restoreDatabase(const QString &filePath);
 
     /**
-     * @brief 导出为JSON
+     * @brief 在后台导出为JSON，完成后发出exportFinished信号
      * @param filePath 导出文件路径
      * @param includePasswords 是否包含密码
-     * @return 导出是否成功
+     * @return 导出任务是否已开始
      */
     Q_INVOKABLE bool exportToJson(const QString &filePath, bool includePasswords = false);
 
     /**
-     * @brief 导出为CSV
+     * @brief 在后台导出为CSV，完成后发出exportFinished信号
      * @param filePath 导出文件路径
      * @param includePasswords 是否包含密码
-     * @return 导出是否成功
+     * @return 导出任务是否已开始
      */
     Q_INVOKABLE bool exportToCsv(const QString &filePath, bool includePasswords = false);
 
     /**
-     * @brief 从JSON导入
+     * @brief 从JSON导入，在后台流式读取并分批写入，完成后发出importFinished信号
      * @param filePath 导入文件路径
-     * @param overwrite 是否覆盖现有数据
-     * @return 导入是否成功
+     * @param overwrite 是否覆盖标题和网址相同的已有条目（否则跳过）
+     * @return 导入任务是否已开始
      */
     Q_INVOKABLE bool importFromJson(const QString &filePath, bool overwrite = false);
 
     /**
-     * @brief 从CSV导入
+     * @brief 从CSV导入，在后台分批写入，完成后发出importFinished信号
      * @param filePath 导入文件路径
-     * @param overwrite 是否覆盖现有数据
-     * @return 导入是否成功
+     * @param overwrite 是否覆盖标题和网址相同的已有条目（否则跳过）
+     * @return 导入任务是否已开始
      */
     Q_INVOKABLE bool importFromCsv(const QString &filePath, bool overwrite = false);
 
+    /**
+     * @brief 取消正在进行的导入，已写入的批次保留
+     */
+    Q_INVOKABLE void cancelImport();
+
     /**
      * @brief 清除所有密码
      * @return 清除是否成功
@@ -282,23 +360,145 @@ signals:
      */
     void totalPasswordsCountChanged();
 
+    /**
+     * @brief 数据库备份进度信号
+     * @param copiedPages 已复制的页数
+     * @param totalPages 总页数
+     */
+    void backupProgress(int copiedPages, int totalPages);
+
+    /**
+     * @brief 数据库备份完成信号
+     * @param success 是否成功
+     */
+    void backupFinished(bool success);
+
+    /**
+     * @brief 数据库压缩完成信号
+     * @param success 是否成功
+     */
+    void compactFinished(bool success);
+
+    /**
+     * @brief 数据库完整性检查完成信号
+     * @param ok 数据库是否完整
+     */
+    void integrityCheckFinished(bool ok);
+
+    /**
+     * @brief 导出完成信号
+     * @param success 是否成功
+     */
+    void exportFinished(bool success);
+
+    /**
+     * @brief 导入进度信号
+     * @param processed 已处理的数量（CSV为条目数，JSON为字节数）
+     * @param total 总量
+     */
+    void importProgress(qint64 processed, qint64 total);
+
+    /**
+     * @brief 导入完成信号
+     * @param success 是否至少处理了一个条目
+     * @param imported 新增的条目数
+     * @param updated 覆盖的条目数
+     * @param skipped 跳过的重复条目数
+     */
+    void importFinished(bool success, int imported, int updated, int skipped);
+
 private:
     CryptoManager *m_cryptoManager;
     DatabaseManager *m_databaseManager;
     PasswordListModel *m_passwordListModel;
     bool m_isLoading;
     QString m_lastError;
+    PasswordRecordCursor m_loadCursor;     // 分批加载密码列表的游标
+    quint64 m_loadGeneration;            // 加载批次编号，用于丢弃过期的加载任务
+    bool m_showingFullList;              // 列表模型中是否为完整列表（而非收藏或分类结果）
+    QTimer *m_searchTimer;               // 合并连续输入的搜索定时器
+    QString m_searchTerm;                // 当前搜索词
+    quint64 m_searchGeneration;          // 搜索编号，用于丢弃过期的搜索结果
+    std::shared_ptr<std::atomic<bool>> m_importCancelled; // 进行中导入的取消标志，为空表示没有导入
+    bool m_exporting;                    // 是否有导出任务正在进行
 
     void setLoading(bool loading);
     void setLastError(const QString &error);
     void clearLastError();
-    
+    bool isTransferInProgress();
+
+    /**
+     * @brief 取消正在进行的分批加载
+     */
+    void cancelPasswordLoading();
+
+    /**
+     * @brief 开始分批重新加载完整列表，不重新触发搜索
+     *
+     * 只用于解锁、恢复等整个数据库可能变化的场合，单个条目的写入见
+     * onPasswordRecordStored()和onPasswordItemDeleted()
+     */
+    void reloadPasswordList();
+
+    /**
+     * @brief 把刚保存或更新的记录合并到列表模型，只影响对应的一行
+     * @param record 写入后的密码记录
+     */
+    void onPasswordRecordStored(const PasswordRecord &record);
+
+    /**
+     * @brief 从列表模型中移除已删除的条目
+     * @param id 删除的密码项目ID
+     */
+    void onPasswordItemDeleted(int id);
+
+    /**
+     * @brief 在数据库线程中把所有密码写入导出文件
+     * @param writer 导出文件写入器
+     * @param filePath 导出文件路径
+     * @return 导出任务是否已开始
+     */
+    bool startExport(std::shared_ptr<PasswordRecordWriter> writer, const QString &filePath);
+
+    /**
+     * @brief 在数据库线程中从数据源批量导入记录
+     * @param reader 导入数据源，由导入任务持有直到完成
+     * @param overwrite 是否覆盖重复的已有条目
+     * @return 导入任务是否已开始
+     */
+    bool startImport(std::shared_ptr<PasswordRecordReader> reader, bool overwrite);
+
+    /**
+     * @brief 从加载游标读取下一批密码并追加到列表模型
+     * @param generation 发起加载时的批次编号
+     */
+    void loadNextPasswordBatch(quint64 generation);
+
+    /**
+     * @brief 执行最近一次输入的搜索
+     */
+    void runPendingSearch();
+
+    /**
+     * @brief 取消当前搜索并清除搜索过滤
+     */
+    void resetSearch();
+
+    /**
+     * @brief 异步派生加密密钥，再用派生出的数据库密钥解锁数据库，完成后发出指定的成功信号
+     * @param password 主密码
+     * @param create 是否为新数据库设置密钥
+     * @param onSuccess 成功后要执行的操作
+     */
+    void initializeCryptoAsync(const QString &password, bool create, void (PasswordManager::*onSuccess)());
+
     /**
-     * @brief 解析CSV行
-     * @param line CSV行字符串
-     * @return 字段列表
+     * @brief 用加密管理器派生出的数据库密钥解锁数据库
+     * @param password 主密码，仅用于迁移以口令加密的旧数据库
+     * @param create 是否为新数据库设置密钥
+     * @return 解锁是否成功
      */
-    QStringList parseCsvLine(const QString &line);
+    bool unlockDatabase(const QString &password, bool create);
 };
 
 #endif // PASSWORDMANAGER_H 
\ No newline at end of file
@@ -1,15 +1,21 @@
 #include "CryptoManager.h"
+#include "FieldCipher.h"
 #include <QDebug>
 #include <QStandardPaths>
 #include <QDir>
 #include <QDataStream>
-#include <QBuffer>
 #include <QIODevice>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QCoreApplication>
 #include <QRandomGenerator>
+#include <QMessageAuthenticationCode>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+#include <array>
+#include <cstring>
+#include <utility>
 
 // 静态成员初始化
 CryptoManager* CryptoManager::s_instance = nullptr;
@@ -17,8 +23,17 @@ CryptoManager* CryptoManager::s_instance = nullptr;
 // 加密常量
 static const int SALT_SIZE = 32;
 static const int KEY_SIZE = 32;
-static const int IV_SIZE = 16;
+static const int LEGACY_IV_SIZE = 16;
 static const int ITERATIONS = 100000;
+static const int MIN_ITERATIONS = 10000;
+
+// 从主密钥扩展子密钥时使用的用途标签
+static const char DATABASE_KEY_LABEL[] = "QtSecretTool/sqlcipher-raw-key/v1";
+static const char FIELD_KEY_LABEL[] = "QtSecretTool/field-aes-256-gcm/v1";
+static const char RECORD_KEY_LABEL[] = "QtSecretTool/record-envelope-aes-256-gcm/v1";
+
+// 批量解密时启用并行的最小数量，数量较少时线程调度开销大于收益
+static const int PARALLEL_DECRYPT_THRESHOLD = 64;
 
 /**
  * @brief 获取加密管理器的单例实例
@@ -38,6 +53,7 @@ CryptoManager* CryptoManager::instance()
  */
 CryptoManager::CryptoManager(QObject *parent)
     : QObject(parent)
+    , m_iterations(ITERATIONS)
     , m_initialized(false)
     , m_settings(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/crypto.ini", QSettings::IniFormat)
 {
@@ -70,13 +86,57 @@ bool CryptoManager::initialize(const QString &masterPassword)
     }
 
     // 从主密码生成加密密钥
-    m_encryptionKey = deriveKey(masterPassword);
-    
+    return finishInitialization(deriveKey(masterPassword));
+}
+
+/**
+ * @brief 异步初始化加密管理器
+ * @param masterPassword 主密码
+ * @return 初始化结果的future
+ */
+QFuture<bool> CryptoManager::initializeAsync(const QString &masterPassword)
+{
+    if (masterPassword.isEmpty()) {
+        emit cryptoError("Master password cannot be empty");
+        emit initializationFinished(false);
+        return QtFuture::makeReadyValueFuture(false);
+    }
+
+    // 盐值读写依赖QSettings，在当前线程完成
+    if (!loadSalt()) {
+        m_salt = generateSalt();
+        saveSalt();
+    }
+
+    return deriveKeyAsync(masterPassword).then(this, [this](const QByteArray &key) {
+        bool success = finishInitialization(key);
+        emit initializationFinished(success);
+        return success;
+    });
+}
+
+/**
+ * @brief 使用派生好的密钥完成初始化
+ * @param key 派生密钥
+ * @return 初始化是否成功
+ */
+bool CryptoManager::finishInitialization(const QByteArray &key)
+{
+    m_encryptionKey = key;
+
     if (m_encryptionKey.isEmpty()) {
         emit cryptoError("Failed to derive encryption key");
         return false;
     }
 
+    // 数据库密钥和字段密钥都由主密钥单向扩展得到，主密钥只用于迁移版本1数据库
+    m_databaseKey.fill('\0');
+    m_databaseKey = expandKey(m_encryptionKey, DATABASE_KEY_LABEL);
+    m_fieldKey.fill('\0');
+    m_fieldKey = expandKey(m_encryptionKey, FIELD_KEY_LABEL);
+    m_recordKey.fill('\0');
+    m_recordKey = expandKey(m_encryptionKey, RECORD_KEY_LABEL);
+
     m_initialized = true;
     qInfo() << "CryptoManager initialized successfully";
     return true;
@@ -91,106 +151,457 @@ bool CryptoManager::isInitialized() const
     return m_initialized;
 }
 
+/**
+ * @brief 获取SQLCipher使用的原始数据库密钥
+ * @return 32字节密钥，未初始化时为空
+ */
+QByteArray CryptoManager::databaseKey() const
+{
+    return m_initialized ? m_databaseKey : QByteArray();
+}
+
+/**
+ * @brief 按用途从主密钥扩展出子密钥
+ * @param masterKey 主密钥
+ * @param label 用途标签
+ * @return 32字节子密钥
+ */
+QByteArray CryptoManager::expandKey(const QByteArray &masterKey, const QByteArray &label)
+{
+    return QMessageAuthenticationCode::hash(label, masterKey, QCryptographicHash::Sha256);
+}
+
 /**
  * @brief 加密字符串
  * @param plaintext 明文字符串
  * @return 加密后的Base64编码字符串，失败返回空字符串
  */
 QString CryptoManager::encryptString(const QString &plaintext)
+{
+    return QString::fromLatin1(encryptField(plaintext).toBase64());
+}
+
+/**
+ * @brief 解密字符串
+ * @param ciphertext 加密的Base64编码字符串
+ * @return 解密后的明文字符串，失败返回空字符串
+ */
+QString CryptoManager::decryptString(const QString &ciphertext)
+{
+    return decryptField(QByteArray::fromBase64(ciphertext.toLatin1()));
+}
+
+/**
+ * @brief 加密单个字段
+ * @param plaintext 明文字符串
+ * @return 二进制密文，明文为空或失败时返回空QByteArray
+ */
+QByteArray CryptoManager::encryptField(const QString &plaintext)
+{
+    if (!m_initialized) {
+        emit cryptoError("CryptoManager not initialized");
+        return QByteArray();
+    }
+
+    return sealWithKey(m_fieldKey, plaintext);
+}
+
+/**
+ * @brief 解密单个字段
+ * @param ciphertext 二进制密文
+ * @return 解密后的明文字符串，失败返回空字符串
+ */
+QString CryptoManager::decryptField(const QByteArray &ciphertext)
 {
     if (!m_initialized) {
         emit cryptoError("CryptoManager not initialized");
         return QString();
     }
 
-    if (plaintext.isEmpty()) {
+    if (ciphertext.isEmpty()) {
         return QString();
     }
 
-    try {
-        // 生成随机IV
-        QByteArray iv = generateRandomBytes(IV_SIZE);
-        
-        // 将明文转换为字节数组
-        QByteArray plaintextBytes = plaintext.toUtf8();
-        
-        // 创建加密数据流
-        QByteArray encryptedData;
-        QBuffer buffer(&encryptedData);
-        buffer.open(QIODevice::WriteOnly);
-        
-        // 写入IV
-        buffer.write(iv);
-        
-        // 简单的XOR加密（在实际应用中应该使用更安全的加密算法）
-        // 这里使用简单的异或加密作为示例
-        for (int i = 0; i < plaintextBytes.size(); ++i) {
-            char encryptedByte = plaintextBytes[i] ^ m_encryptionKey[i % m_encryptionKey.size()];
-            buffer.write(&encryptedByte, 1);
+    bool ok = false;
+    QString plaintext = openWithKey(m_fieldKey, ciphertext, &ok);
+    if (!ok) {
+        emit cryptoError("Invalid encrypted data");
+    }
+    return plaintext;
+}
+
+/**
+ * @brief 批量解密字段
+ * @param ciphertexts 二进制密文列表
+ * @return 解密后的明文列表，顺序与输入一致
+ */
+QStringList CryptoManager::decryptFields(const QList<QByteArray> &ciphertexts)
+{
+    if (!m_initialized) {
+        emit cryptoError("CryptoManager not initialized");
+        return QStringList();
+    }
+
+    // 按值捕获密钥，工作线程不访问成员状态
+    const QByteArray key = m_fieldKey;
+    auto decryptOne = [key](const QByteArray &ciphertext) {
+        return openWithKey(key, ciphertext);
+    };
+
+    if (ciphertexts.size() < PARALLEL_DECRYPT_THRESHOLD) {
+        QStringList results;
+        results.reserve(ciphertexts.size());
+        for (const QByteArray &ciphertext : ciphertexts) {
+            results.append(decryptOne(ciphertext));
         }
-        
-        buffer.close();
-        
-        // 返回Base64编码的加密数据
-        return encryptedData.toBase64();
-        
-    } catch (const std::exception &e) {
-        QString error = QString("Encryption failed: %1").arg(e.what());
-        emit cryptoError(error);
-        return QString();
+        return results;
     }
+
+    return QtConcurrent::blockingMapped<QStringList>(ciphertexts, decryptOne);
 }
 
 /**
- * @brief 解密字符串
- * @param ciphertext 加密的Base64编码字符串
- * @return 解密后的明文字符串，失败返回空字符串
+ * @brief 批量加密字段
+ * @param plaintexts 明文列表
+ * @return 二进制密文列表，顺序与输入一致
  */
-QString CryptoManager::decryptString(const QString &ciphertext)
+QList<QByteArray> CryptoManager::encryptFields(const QStringList &plaintexts)
 {
     if (!m_initialized) {
         emit cryptoError("CryptoManager not initialized");
-        return QString();
+        return QList<QByteArray>();
+    }
+
+    // 按值捕获密钥，工作线程不访问成员状态
+    const QByteArray key = m_fieldKey;
+    auto encryptOne = [key](const QString &plaintext) {
+        return sealWithKey(key, plaintext);
+    };
+
+    if (plaintexts.size() < PARALLEL_DECRYPT_THRESHOLD) {
+        QList<QByteArray> results;
+        results.reserve(plaintexts.size());
+        for (const QString &plaintext : plaintexts) {
+            results.append(encryptOne(plaintext));
+        }
+        return results;
+    }
+
+    return QtConcurrent::blockingMapped<QList<QByteArray>>(plaintexts, encryptOne);
+}
+
+/**
+ * @brief 把版本1数据库中的字段密文改写为当前格式
+ * @param ciphertexts 版本1中读出的二进制密文
+ * @return 当前格式的二进制密文列表，顺序与输入一致
+ */
+QList<QByteArray> CryptoManager::resealLegacyFields(const QList<QByteArray> &ciphertexts)
+{
+    if (!m_initialized) {
+        emit cryptoError("CryptoManager not initialized");
+        return QList<QByteArray>();
     }
 
+    // 按值捕获密钥，工作线程不访问成员状态
+    const QByteArray key = m_fieldKey;
+    const QByteArray legacyKey = m_encryptionKey;
+    auto resealOne = [key, legacyKey](const QByteArray &ciphertext) {
+        // 认证通过说明已经是当前格式，原样保留
+        QByteArray decryptedData;
+        if (FieldCipher::open(key, ciphertext, decryptedData)) {
+            decryptedData.fill('\0');
+            return ciphertext;
+        }
+
+        bool ok = false;
+        QString plaintext = openLegacyWithKey(legacyKey, ciphertext, &ok);
+        if (!ok) {
+            qWarning() << "Dropping undecryptable legacy field";
+        }
+        const QByteArray sealed = sealWithKey(key, plaintext);
+        plaintext.fill(QChar(0));
+        return sealed;
+    };
+
+    if (ciphertexts.size() < PARALLEL_DECRYPT_THRESHOLD) {
+        QList<QByteArray> results;
+        results.reserve(ciphertexts.size());
+        for (const QByteArray &ciphertext : ciphertexts) {
+            results.append(resealOne(ciphertext));
+        }
+        return results;
+    }
+
+    return QtConcurrent::blockingMapped<QList<QByteArray>>(ciphertexts, resealOne);
+}
+
+/**
+ * @brief 加密记录信封
+ * @param fields 字段明文
+ * @return 二进制密文，失败时返回空QByteArray
+ */
+QByteArray CryptoManager::encryptRecord(const QStringList &fields)
+{
+    if (!m_initialized) {
+        emit cryptoError("CryptoManager not initialized");
+        return QByteArray();
+    }
+
+    return sealRecordWithKey(m_recordKey, fields);
+}
+
+/**
+ * @brief 解密记录信封
+ * @param envelope 二进制密文
+ * @return 字段明文，失败时返回空列表
+ */
+QStringList CryptoManager::decryptRecord(const QByteArray &envelope)
+{
+    if (!m_initialized) {
+        emit cryptoError("CryptoManager not initialized");
+        return QStringList();
+    }
+
+    QStringList fields = openRecordWithKey(m_recordKey, envelope);
+    if (fields.isEmpty()) {
+        emit cryptoError("Invalid encrypted data");
+    }
+    return fields;
+}
+
+/**
+ * @brief 批量加密记录信封
+ * @param records 每条记录的字段明文
+ * @return 二进制密文列表，顺序与输入一致
+ */
+QList<QByteArray> CryptoManager::encryptRecords(const QList<QStringList> &records)
+{
+    if (!m_initialized) {
+        emit cryptoError("CryptoManager not initialized");
+        return QList<QByteArray>();
+    }
+
+    // 按值捕获密钥，工作线程不访问成员状态
+    const QByteArray key = m_recordKey;
+    auto encryptOne = [key](const QStringList &fields) {
+        return sealRecordWithKey(key, fields);
+    };
+
+    if (records.size() < PARALLEL_DECRYPT_THRESHOLD) {
+        QList<QByteArray> results;
+        results.reserve(records.size());
+        for (const QStringList &fields : records) {
+            results.append(encryptOne(fields));
+        }
+        return results;
+    }
+
+    return QtConcurrent::blockingMapped<QList<QByteArray>>(records, encryptOne);
+}
+
+/**
+ * @brief 批量解密记录信封
+ * @param envelopes 二进制密文列表
+ * @return 每条记录的字段明文，顺序与输入一致
+ */
+QList<QStringList> CryptoManager::decryptRecords(const QList<QByteArray> &envelopes)
+{
+    if (!m_initialized) {
+        emit cryptoError("CryptoManager not initialized");
+        return QList<QStringList>();
+    }
+
+    // 按值捕获密钥，工作线程不访问成员状态
+    const QByteArray key = m_recordKey;
+    auto decryptOne = [key](const QByteArray &envelope) {
+        return openRecordWithKey(key, envelope);
+    };
+
+    if (envelopes.size() < PARALLEL_DECRYPT_THRESHOLD) {
+        QList<QStringList> results;
+        results.reserve(envelopes.size());
+        for (const QByteArray &envelope : envelopes) {
+            results.append(decryptOne(envelope));
+        }
+        return results;
+    }
+
+    return QtConcurrent::blockingMapped<QList<QStringList>>(envelopes, decryptOne);
+}
+
+/**
+ * @brief 在缓冲区末尾写入变长编码的长度（每字节7位，低位在前）
+ * @param buffer 缓冲区
+ * @param length 长度
+ */
+static void appendLength(QByteArray &buffer, quint32 length)
+{
+    while (length >= 0x80) {
+        buffer.append(static_cast<char>((length & 0x7f) | 0x80));
+        length >>= 7;
+    }
+    buffer.append(static_cast<char>(length));
+}
+
+/**
+ * @brief 读取变长编码的长度
+ * @param data 数据
+ * @param offset 读取位置，成功时移到长度之后
+ * @param length 输出参数，读到的长度
+ * @return 编码完整且不超过32位时返回true
+ */
+static bool readLength(QByteArrayView data, qsizetype &offset, quint32 &length)
+{
+    length = 0;
+    for (int shift = 0; shift < 32 && offset < data.size(); shift += 7) {
+        const auto byte = static_cast<quint8>(data[offset++]);
+        length |= quint32(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 使用指定密钥打包并加密一条记录
+ *
+ * 明文格式：依次为每个字段的长度（变长编码）和UTF-8内容，
+ * 三个典型字段的打包开销只有3个字节
+ * @param key 记录信封密钥
+ * @param fields 字段明文
+ * @return 二进制密文
+ */
+QByteArray CryptoManager::sealRecordWithKey(const QByteArray &key, const QStringList &fields)
+{
+    if (key.isEmpty()) {
+        return QByteArray();
+    }
+
+    QByteArray packed;
+    for (const QString &field : fields) {
+        QByteArray bytes = field.toUtf8();
+        appendLength(packed, static_cast<quint32>(bytes.size()));
+        packed.append(bytes);
+        bytes.fill('\0');
+    }
+
+    QByteArray sealed;
+    const bool ok = FieldCipher::seal(key, packed, sealed);
+    packed.fill('\0');
+    return ok ? sealed : QByteArray();
+}
+
+/**
+ * @brief 使用指定密钥解密并拆分一条记录
+ * @param key 记录信封密钥
+ * @param envelope 二进制密文
+ * @return 字段明文，失败时返回空列表
+ */
+QStringList CryptoManager::openRecordWithKey(const QByteArray &key, QByteArrayView envelope)
+{
+    QByteArray packed;
+    if (key.isEmpty() || !FieldCipher::open(key, envelope, packed)) {
+        return QStringList();
+    }
+
+    QStringList fields;
+    qsizetype offset = 0;
+    while (offset < packed.size()) {
+        quint32 length = 0;
+        if (!readLength(packed, offset, length) || length > quint64(packed.size() - offset)) {
+            fields.clear();
+            break;
+        }
+        fields.append(QString::fromUtf8(packed.constData() + offset, length));
+        offset += length;
+    }
+    packed.fill('\0');
+    return fields;
+}
+
+/**
+ * @brief 使用指定密钥加密
+ * @param key 字段密钥
+ * @param plaintext 明文字符串
+ * @return 二进制密文
+ */
+QByteArray CryptoManager::sealWithKey(const QByteArray &key, const QString &plaintext)
+{
+    if (plaintext.isEmpty() || key.isEmpty()) {
+        return QByteArray();
+    }
+
+    QByteArray plaintextBytes = plaintext.toUtf8();
+    QByteArray sealed;
+    const bool ok = FieldCipher::seal(key, plaintextBytes, sealed);
+    plaintextBytes.fill('\0');
+    return ok ? sealed : QByteArray();
+}
+
+/**
+ * @brief 使用指定密钥解密
+ * @param key 字段密钥
+ * @param ciphertext 二进制密文
+ * @param ok 输出参数，数据为空或认证通过时为true
+ * @return 解密后的明文字符串，失败时为空字符串
+ */
+QString CryptoManager::openWithKey(const QByteArray &key, QByteArrayView ciphertext, bool *ok)
+{
+    if (ok) {
+        *ok = true;
+    }
     if (ciphertext.isEmpty()) {
         return QString();
     }
 
-    try {
-        // 解码Base64数据
-        QByteArray encryptedData = QByteArray::fromBase64(ciphertext.toUtf8());
-        
-        if (encryptedData.size() < IV_SIZE) {
-            emit cryptoError("Invalid encrypted data");
-            return QString();
+    // 认证失败就是数据被篡改或密钥错误，不再当作旧格式解释
+    QByteArray decryptedData;
+    if (key.isEmpty() || !FieldCipher::open(key, ciphertext, decryptedData)) {
+        if (ok) {
+            *ok = false;
         }
-        
-        // 读取IV
-        QByteArray iv = encryptedData.left(IV_SIZE);
-        QByteArray ciphertextBytes = encryptedData.mid(IV_SIZE);
-        
-        // 创建解密数据流
-        QByteArray decryptedData;
-        QBuffer buffer(&ciphertextBytes);
-        buffer.open(QIODevice::ReadOnly);
-        
-        // 简单的XOR解密
-        for (int i = 0; i < ciphertextBytes.size(); ++i) {
-            char decryptedByte = ciphertextBytes[i] ^ m_encryptionKey[i % m_encryptionKey.size()];
-            decryptedData.append(decryptedByte);
+        return QString();
+    }
+
+    QString plaintext = QString::fromUtf8(decryptedData);
+    decryptedData.fill('\0');
+    return plaintext;
+}
+
+/**
+ * @brief 使用主密钥解密旧的XOR格式数据
+ * @param legacyKey 主密钥
+ * @param ciphertext 二进制密文
+ * @param ok 输出参数，数据为空或长度有效时为true
+ * @return 解密后的明文字符串
+ */
+QString CryptoManager::openLegacyWithKey(const QByteArray &legacyKey, QByteArrayView ciphertext, bool *ok)
+{
+    if (ok) {
+        *ok = true;
+    }
+    if (ciphertext.isEmpty()) {
+        return QString();
+    }
+
+    // 旧版本写入的数据：16字节IV后是与主密钥异或的明文，没有认证
+    if (ciphertext.size() < LEGACY_IV_SIZE || legacyKey.isEmpty()) {
+        if (ok) {
+            *ok = false;
         }
-        
-        buffer.close();
-        
-        // 返回解密后的字符串
-        return QString::fromUtf8(decryptedData);
-        
-    } catch (const std::exception &e) {
-        QString error = QString("Decryption failed: %1").arg(e.what());
-        emit cryptoError(error);
         return QString();
     }
+
+    QByteArray decryptedData;
+    decryptedData.resize(ciphertext.size() - LEGACY_IV_SIZE);
+    for (int i = 0; i < decryptedData.size(); ++i) {
+        decryptedData[i] = ciphertext[LEGACY_IV_SIZE + i] ^ legacyKey[i % legacyKey.size()];
+    }
+
+    QString plaintext = QString::fromUtf8(decryptedData);
+    decryptedData.fill('\0');
+    return plaintext;
 }
 
 /**
@@ -204,42 +615,76 @@ bool CryptoManager::verifyMasterPassword(const QString &masterPassword)
         return false;
     }
 
+    return verifyDerivedKey(deriveKey(masterPassword));
+}
+
+/**
+ * @brief 异步验证主密码
+ * @param masterPassword 要验证的主密码
+ * @return 验证结果的future
+ */
+QFuture<bool> CryptoManager::verifyMasterPasswordAsync(const QString &masterPassword)
+{
+    if (masterPassword.isEmpty()) {
+        emit verificationFinished(false);
+        return QtFuture::makeReadyValueFuture(false);
+    }
+
+    if (m_salt.isEmpty() && !loadSalt()) {
+        m_salt = generateSalt();
+        saveSalt();
+    }
+
+    return deriveKeyAsync(masterPassword).then(this, [this](const QByteArray &key) {
+        bool success = verifyDerivedKey(key);
+        emit verificationFinished(success);
+        return success;
+    });
+}
+
+/**
+ * @brief 检查派生密钥能否解密验证数据
+ * @param key 派生密钥
+ * @return 密钥是否正确
+ */
+bool CryptoManager::verifyDerivedKey(const QByteArray &key)
+{
+    const QByteArray fieldKey = expandKey(key, FIELD_KEY_LABEL);
+
     // 从设置中读取测试数据
     QString testData = m_settings.value("test_data").toString();
     if (testData.isEmpty()) {
         // 如果没有测试数据，创建一个
-        QString testString = "test_verification_string";
-        QByteArray testKey = deriveKey(masterPassword);
-        
-        // 临时加密测试字符串
-        QByteArray tempKey = m_encryptionKey;
-        m_encryptionKey = testKey;
-        
-        QString encrypted = encryptString(testString);
-        m_settings.setValue("test_data", encrypted);
-        
-        m_encryptionKey = tempKey;
+        const QByteArray sealed = sealWithKey(fieldKey, "test_verification_string");
+        m_settings.setValue("test_data", QString::fromLatin1(sealed.toBase64()));
         return true;
     }
 
-    // 尝试解密测试数据
-    QByteArray testKey = deriveKey(masterPassword);
-    QByteArray tempKey = m_encryptionKey;
-    m_encryptionKey = testKey;
-    
-    QString decrypted = decryptString(testData);
-    m_encryptionKey = tempKey;
-    
-    return decrypted == "test_verification_string";
+    // 尝试解密测试数据，新格式在密钥错误时认证失败
+    const QByteArray sealedTestData = QByteArray::fromBase64(testData.toLatin1());
+    if (openWithKey(fieldKey, sealedTestData) == "test_verification_string") {
+        return true;
+    }
+
+    // 旧版本保存的测试数据是XOR格式，只有解出完整的验证字符串才算通过，
+    // 通过后改写为新格式，以后不再走这个分支
+    if (openLegacyWithKey(key, sealedTestData) != "test_verification_string") {
+        return false;
+    }
+    const QByteArray sealed = sealWithKey(fieldKey, "test_verification_string");
+    m_settings.setValue("test_data", QString::fromLatin1(sealed.toBase64()));
+    return true;
 }
 
 /**
  * @brief 更改主密码
  * @param oldPassword 旧主密码
  * @param newPassword 新主密码
+ * @param commit 接收新旧密钥的回调，返回false时放弃更改
  * @return 更改是否成功
  */
-bool CryptoManager::changeMasterPassword(const QString &oldPassword, const QString &newPassword)
+bool CryptoManager::changeMasterPassword(const QString &oldPassword, const QString &newPassword,
+                                         const std::function<bool(const CiphertextRekeyer &)> &commit)
 {
     if (!verifyMasterPassword(oldPassword)) {
         emit cryptoError("Old password is incorrect");
@@ -251,10 +696,40 @@ bool CryptoManager::changeMasterPassword(const QString &oldPassword, const QStri
         return false;
     }
 
-    // 生成新的盐值和密钥
-    m_salt = generateSalt();
-    m_encryptionKey = deriveKey(newPassword);
-    
+    // 生成新的盐值和密钥，同时应用新设置的迭代次数
+    const QByteArray newSalt = generateSalt();
+    const int newIterations = qMax(MIN_ITERATIONS, m_settings.value("kdf_target_iterations", m_iterations).toInt());
+    QByteArray newKey = deriveKey(newPassword, newSalt, newIterations);
+
+    // 旧子密钥移交给rekeyer，本对象在提交期间已使用新的子密钥，
+    // 回调中按新密钥解密（例如重建搜索索引）也能成功
+    CiphertextRekeyer rekeyer;
+    rekeyer.m_oldDatabaseKey = std::exchange(m_databaseKey, expandKey(newKey, DATABASE_KEY_LABEL));
+    rekeyer.m_oldFieldKey = std::exchange(m_fieldKey, expandKey(newKey, FIELD_KEY_LABEL));
+    rekeyer.m_oldRecordKey = std::exchange(m_recordKey, expandKey(newKey, RECORD_KEY_LABEL));
+    rekeyer.m_newDatabaseKey = m_databaseKey;
+    rekeyer.m_newFieldKey = m_fieldKey;
+    rekeyer.m_newRecordKey = m_recordKey;
+
+    // 数据库换成新密钥并改写全部密文，失败时恢复旧的子密钥，旧盐值仍然有效
+    if (commit && !commit(rekeyer)) {
+        // 新的子密钥只剩rekeyer持有，由它在析构时清零
+        newKey.fill('\0');
+        m_databaseKey = rekeyer.m_oldDatabaseKey;
+        m_fieldKey = rekeyer.m_oldFieldKey;
+        m_recordKey = rekeyer.m_oldRecordKey;
+        emit cryptoError("Failed to rekey database");
+        return false;
+    }
+
+    m_salt = newSalt;
+    m_iterations = newIterations;
+    // 旧盐值对应的缓存密钥已失效
+    m_keyCache.clear();
+    m_keyCache.insert(newPassword, m_salt, m_iterations, newKey);
+    m_encryptionKey.fill('\0');
+    m_encryptionKey = newKey;
+
     // 保存新的盐值
     saveSalt();
     
@@ -267,16 +742,109 @@ bool CryptoManager::changeMasterPassword(const QString &oldPassword, const QStri
     return true;
 }
 
+// CiphertextRekeyer实现
+
+CiphertextRekeyer::~CiphertextRekeyer()
+{
+    for (QByteArray *key : {&m_oldDatabaseKey, &m_newDatabaseKey, &m_oldFieldKey,
+                            &m_newFieldKey, &m_oldRecordKey, &m_newRecordKey}) {
+        // 仍被CryptoManager共享的密钥由它自己负责清零
+        if (key->isDetached()) {
+            key->fill('\0');
+        }
+        key->clear();
+    }
+}
+
+/**
+ * @brief 把单独加密的字段密文改写为新的字段密钥
+ * @param ciphertexts 密文列表
+ * @return 是否全部成功
+ */
+bool CiphertextRekeyer::resealFields(QList<QByteArray> &ciphertexts) const
+{
+    return reseal(m_oldFieldKey, m_newFieldKey, ciphertexts);
+}
+
+/**
+ * @brief 把记录信封改写为新的记录信封密钥
+ * @param envelopes 信封列表
+ * @return 是否全部成功
+ */
+bool CiphertextRekeyer::resealRecords(QList<QByteArray> &envelopes) const
+{
+    // 信封的打包格式与密钥无关，只需要整体解开再加密，不必拆分字段
+    return reseal(m_oldRecordKey, m_newRecordKey, envelopes);
+}
+
+/**
+ * @brief 用旧密钥解开每个密文，再用新密钥重新加密
+ * @param oldKey 旧密钥
+ * @param newKey 新密钥
+ * @param ciphertexts 密文列表
+ * @return 是否全部成功
+ */
+bool CiphertextRekeyer::reseal(const QByteArray &oldKey, const QByteArray &newKey,
+                               QList<QByteArray> &ciphertexts)
+{
+    QList<QByteArray> resealed;
+    resealed.reserve(ciphertexts.size());
+    QByteArray plaintext;
+    for (const QByteArray &ciphertext : ciphertexts) {
+        if (ciphertext.isEmpty()) {
+            resealed.append(QByteArray());
+            continue;
+        }
+        // 认证失败说明数据已损坏，不能用新密钥把它“修好”，整体放弃
+        QByteArray sealed;
+        const bool ok = FieldCipher::open(oldKey, ciphertext, plaintext)
+                        && FieldCipher::seal(newKey, plaintext, sealed);
+        plaintext.fill('\0');
+        if (!ok) {
+            return false;
+        }
+        resealed.append(sealed);
+    }
+    ciphertexts = std::move(resealed);
+    return true;
+}
+
 /**
  * @brief 清除加密状态
  */
 void CryptoManager::clear()
 {
+    m_encryptionKey.fill('\0');
     m_encryptionKey.clear();
+    m_databaseKey.fill('\0');
+    m_databaseKey.clear();
+    m_fieldKey.fill('\0');
+    m_fieldKey.clear();
+    m_recordKey.fill('\0');
+    m_recordKey.clear();
+    m_keyCache.clear();
     m_salt.clear();
     m_initialized = false;
 }
 
+/**
+ * @brief 获取当前使用的密钥派生迭代次数
+ * @return 迭代次数
+ */
+int CryptoManager::kdfIterations() const
+{
+    return m_iterations;
+}
+
+/**
+ * @brief 设置密钥派生迭代次数（下次更改主密码时生效）
+ * @param iterations 迭代次数
+ */
+void CryptoManager::setKdfIterations(int iterations)
+{
+    m_settings.setValue("kdf_target_iterations", qMax(MIN_ITERATIONS, iterations));
+}
+
 /**
  * @brief 从主密码生成加密密钥
  * @param masterPassword 主密码
@@ -284,18 +852,80 @@ void CryptoManager::clear()
  */
 QByteArray CryptoManager::deriveKey(const QString &masterPassword)
 {
-    // 使用PBKDF2算法从主密码和盐值生成密钥
-    QByteArray passwordBytes = masterPassword.toUtf8();
-    QByteArray key = QCryptographicHash::hash(passwordBytes + m_salt, QCryptographicHash::Sha256);
-    
-    // 多次迭代以增加安全性
-    for (int i = 1; i < ITERATIONS; ++i) {
-        key = QCryptographicHash::hash(key + passwordBytes + m_salt, QCryptographicHash::Sha256);
+    QByteArray key = m_keyCache.lookup(masterPassword, m_salt, m_iterations);
+    if (key.isEmpty()) {
+        key = deriveKey(masterPassword, m_salt, m_iterations);
+        m_keyCache.insert(masterPassword, m_salt, m_iterations, key);
     }
-    
     return key;
 }
 
+/**
+ * @brief 在后台线程中使用当前盐值和迭代次数生成加密密钥
+ * @param masterPassword 主密码
+ * @return 密钥的future，缓存命中时立即就绪
+ */
+QFuture<QByteArray> CryptoManager::deriveKeyAsync(const QString &masterPassword)
+{
+    const QByteArray salt = m_salt;
+    const int iterations = m_iterations;
+
+    QByteArray cached = m_keyCache.lookup(masterPassword, salt, iterations);
+    if (!cached.isEmpty()) {
+        return QtFuture::makeReadyValueFuture(cached);
+    }
+
+    return QtConcurrent::run([masterPassword, salt, iterations]() {
+        return deriveKey(masterPassword, salt, iterations);
+    }).then(this, [this, masterPassword, salt, iterations](const QByteArray &key) {
+        // 缓存只在本对象所在线程访问
+        m_keyCache.insert(masterPassword, salt, iterations, key);
+        return key;
+    });
+}
+
+/**
+ * @brief 设置派生密钥缓存的有效期
+ * @param timeToLiveMs 有效期（毫秒），0表示不缓存
+ */
+void CryptoManager::setKeyCacheTimeToLive(int timeToLiveMs)
+{
+    m_keyCache.setTimeToLive(timeToLiveMs);
+}
+
+/**
+ * @brief 从主密码生成加密密钥
+ * @param masterPassword 主密码
+ * @param salt 盐值
+ * @param iterations 迭代次数
+ * @return 生成的密钥
+ */
+QByteArray CryptoManager::deriveKey(const QString &masterPassword, const QByteArray &salt, int iterations)
+{
+    QByteArray passwordBytes = masterPassword.toUtf8();
+    std::array<char, KEY_SIZE> key;
+
+    // 第一轮：SHA-256(密码 + 盐值)
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(passwordBytes);
+    hash.addData(salt);
+    std::memcpy(key.data(), hash.resultView().data(), KEY_SIZE);
+
+    // 后续每轮：SHA-256(上一轮结果 + 密码 + 盐值)，复用同一个哈希对象和缓冲区
+    for (int i = 1; i < iterations; ++i) {
+        hash.reset();
+        hash.addData(QByteArrayView(key.data(), KEY_SIZE));
+        hash.addData(passwordBytes);
+        hash.addData(salt);
+        std::memcpy(key.data(), hash.resultView().data(), KEY_SIZE);
+    }
+
+    QByteArray result(key.data(), KEY_SIZE);
+    key.fill(0);
+    passwordBytes.fill('\0');
+    return result;
+}
+
 /**
  * @brief 生成随机盐值
  * @return 随机盐值
@@ -311,6 +941,7 @@ QByteArray CryptoManager::generateSalt()
 void CryptoManager::saveSalt()
 {
     m_settings.setValue("salt", m_salt.toBase64());
+    m_settings.setValue("kdf_iterations", m_iterations);
 }
 
 /**
@@ -325,6 +956,8 @@ bool CryptoManager::loadSalt()
     }
     
     m_salt = QByteArray::fromBase64(saltString.toUtf8());
+    // 旧版本没有保存迭代次数，使用默认值
+    m_iterations = m_settings.value("kdf_iterations", ITERATIONS).toInt();
     return m_salt.size() == SALT_SIZE;
 }
 
@@ -4,14 +4,81 @@
 #include <QObject>
 #include <QString>
 #include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QStringList>
+#include <QFuture>
 #include <QCryptographicHash>
 #include <QSettings>
+#include <functional>
+#include "DerivedKeyCache.h"
+
+/**
+ * @brief 更改主密码时把已有密文从旧子密钥改写为新子密钥
+ *
+ * 由CryptoManager::changeMasterPassword()创建并交给提交回调，同时持有新旧两组
+ * 子密钥，销毁时清零。密文只在内部解开后立即用新密钥重新加密，明文不会交给调用方
+ */
+class CiphertextRekeyer
+{
+public:
+    ~CiphertextRekeyer();
+
+    /**
+     * @brief 获取新的原始数据库密钥
+     * @return 32字节密钥
+     */
+    QByteArray databaseKey() const { return m_newDatabaseKey; }
+
+    /**
+     * @brief 获取更改前的原始数据库密钥，用于在失败时把数据库改回原密钥
+     * @return 32字节密钥
+     */
+    QByteArray previousDatabaseKey() const { return m_oldDatabaseKey; }
+
+    /**
+     * @brief 把单独加密的字段密文改写为新的字段密钥
+     * @param ciphertexts 密文列表，成功时原地替换，空密文保持为空
+     * @return 全部认证通过并重新加密时返回true，否则列表保持不变
+     */
+    bool resealFields(QList<QByteArray> &ciphertexts) const;
+
+    /**
+     * @brief 把记录信封改写为新的记录信封密钥
+     * @param envelopes 信封列表，成功时原地替换，空信封保持为空
+     * @return 全部认证通过并重新加密时返回true，否则列表保持不变
+     */
+    bool resealRecords(QList<QByteArray> &envelopes) const;
+
+private:
+    friend class CryptoManager;
+    CiphertextRekeyer() = default;
+    Q_DISABLE_COPY(CiphertextRekeyer)
+
+    /**
+     * @brief 用旧密钥解开每个密文，再用新密钥重新加密
+     * @param oldKey 旧密钥
+     * @param newKey 新密钥
+     * @param ciphertexts 密文列表
+     * @return 是否全部成功
+     */
+    static bool reseal(const QByteArray &oldKey, const QByteArray &newKey, QList<QByteArray> &ciphertexts);
+
+    QByteArray m_oldDatabaseKey;       // 更改前的数据库密钥
+    QByteArray m_newDatabaseKey;       // 新的数据库密钥
+    QByteArray m_oldFieldKey;          // 更改前的字段加密密钥
+    QByteArray m_newFieldKey;          // 新的字段加密密钥
+    QByteArray m_oldRecordKey;         // 更改前的记录信封密钥
+    QByteArray m_newRecordKey;         // 新的记录信封密钥
+};
 
 /**
  * @brief 加密管理器类
  * 
  * 负责处理密码数据的加密和解密操作
- * 使用AES-256-GCM加密算法，提供安全的密码存储
+ * 字段使用AES-256-GCM加密（见FieldCipher），密钥由主密钥按用途扩展得到；
+ * 旧版本写入的XOR格式数据只在升级版本1数据库时通过resealLegacyFields()改写，
+ * 运行时的解密只接受新格式
  */
 class CryptoManager : public QObject
 {
@@ -31,12 +98,31 @@ public:
      */
     bool initialize(const QString &masterPassword);
 
+    /**
+     * @brief 异步初始化加密管理器
+     *
+     * 密钥派生在Qt Concurrent线程池中执行，完成后在本对象所在线程
+     * 设置密钥并发出initializationFinished信号，调用线程不会被阻塞
+     * @param masterPassword 主密码
+     * @return 初始化结果的future
+     */
+    QFuture<bool> initializeAsync(const QString &masterPassword);
+
     /**
      * @brief 检查是否已初始化
      * @return 如果已初始化则返回true
      */
     bool isInitialized() const;
 
+    /**
+     * @brief 获取SQLCipher使用的原始数据库密钥
+     *
+     * 由主密钥经HMAC-SHA256按用途扩展得到，与字段加密密钥互相独立。
+     * 数据库直接使用该密钥，不再对口令执行SQLCipher自己的PBKDF2
+     * @return 32字节密钥，未初始化时为空
+     */
+    QByteArray databaseKey() const;
+
     /**
      * @brief 加密字符串
      * @param plaintext 明文字符串
@@ -51,6 +137,84 @@ public:
      */
     QString decryptString(const QString &ciphertext);
 
+    /**
+     * @brief 加密单个字段
+     * @param plaintext 明文字符串
+     * @return 二进制密文（直接存入BLOB列），明文为空或失败时返回空QByteArray
+     */
+    QByteArray encryptField(const QString &plaintext);
+
+    /**
+     * @brief 解密单个字段
+     * @param ciphertext 二进制密文
+     * @return 解密后的明文字符串，失败返回空字符串
+     */
+    QString decryptField(const QByteArray &ciphertext);
+
+    /**
+     * @brief 批量解密字段
+     *
+     * 数量较多时使用Qt Concurrent在全局线程池中并行解密，
+     * 结果顺序与输入一致，解密失败的位置为空字符串
+     * @param ciphertexts 二进制密文列表
+     * @return 解密后的明文列表
+     */
+    QStringList decryptFields(const QList<QByteArray> &ciphertexts);
+
+    /**
+     * @brief 批量加密字段
+     *
+     * 数量较多时在全局线程池中并行加密，结果顺序与输入一致
+     * @param plaintexts 明文列表
+     * @return 二进制密文列表
+     */
+    QList<QByteArray> encryptFields(const QStringList &plaintexts);
+
+    /**
+     * @brief 把版本1数据库中的字段密文改写为当前格式
+     *
+     * 只用于升级版本1的数据库，其中既有旧的XOR格式，也可能有已经是当前格式的密文。
+     * 能通过认证的密文原样保留，其余按XOR格式解密后重新加密，无法解密的字段变为空
+     * @param ciphertexts 版本1中读出的二进制密文
+     * @return 当前格式的二进制密文列表，顺序与输入一致
+     */
+    QList<QByteArray> resealLegacyFields(const QList<QByteArray> &ciphertexts);
+
+    /**
+     * @brief 把一条记录的全部敏感字段打包后一次加密（记录信封）
+     *
+     * 各字段按UTF-8长度前缀依次拼接，只使用一个nonce和认证标签，
+     * 密钥与单字段加密的密钥互相独立
+     * @param fields 字段明文，顺序由调用方约定
+     * @return 二进制密文，失败时返回空QByteArray
+     */
+    QByteArray encryptRecord(const QStringList &fields);
+
+    /**
+     * @brief 解密记录信封
+     * @param envelope encryptRecord()生成的密文
+     * @return 字段明文，顺序与加密时一致；失败时返回空列表
+     */
+    QStringList decryptRecord(const QByteArray &envelope);
+
+    /**
+     * @brief 批量加密记录信封
+     *
+     * 数量较多时在全局线程池中并行加密，结果顺序与输入一致
+     * @param records 每条记录的字段明文
+     * @return 二进制密文列表
+     */
+    QList<QByteArray> encryptRecords(const QList<QStringList> &records);
+
+    /**
+     * @brief 批量解密记录信封
+     *
+     * 数量较多时在全局线程池中并行解密，结果顺序与输入一致，失败的位置为空列表
+     * @param envelopes 二进制密文列表
+     * @return 每条记录的字段明文
+     */
+    QList<QStringList> decryptRecords(const QList<QByteArray> &envelopes);
+
     /**
      * @brief 验证主密码
      * @param masterPassword 要验证的主密码
@@ -58,13 +222,51 @@ public:
      */
     bool verifyMasterPassword(const QString &masterPassword);
 
+    /**
+     * @brief 异步验证主密码
+     *
+     * 密钥派生在后台线程执行，完成后发出verificationFinished信号
+     * @param masterPassword 要验证的主密码
+     * @return 验证结果的future
+     */
+    QFuture<bool> verifyMasterPasswordAsync(const QString &masterPassword);
+
+    /**
+     * @brief 获取当前使用的密钥派生迭代次数
+     * @return 迭代次数
+     */
+    int kdfIterations() const;
+
+    /**
+     * @brief 设置密钥派生迭代次数
+     *
+     * 新的迭代次数在下次更改主密码时生效，之前的数据仍使用原迭代次数
+     * @param iterations 迭代次数
+     */
+    void setKdfIterations(int iterations);
+
+    /**
+     * @brief 设置派生密钥缓存的有效期
+     *
+     * 缓存使解锁后的验证和更改主密码不必重复执行密钥派生
+     * @param timeToLiveMs 有效期（毫秒），0表示不缓存
+     */
+    void setKeyCacheTimeToLive(int timeToLiveMs);
+
     /**
      * @brief 更改主密码
+     *
+     * 字段密钥和记录信封密钥都由主密钥扩展得到，更改主密码后已保存的密文必须
+     * 重新加密。新密钥派生完成后，本对象先切换到新的子密钥，再调用commit，调用方
+     * 在其中用新的数据库密钥重新加密数据库，并通过rekeyer改写所有已保存的密文；
+     * commit返回false时恢复旧的子密钥，原有状态保持不变
      * @param oldPassword 旧主密码
      * @param newPassword 新主密码
+     * @param commit 接收新旧密钥的回调，可为空
      * @return 更改是否成功
      */
-    bool changeMasterPassword(const QString &oldPassword, const QString &newPassword);
+    bool changeMasterPassword(const QString &oldPassword, const QString &newPassword,
+                              const std::function<bool(const CiphertextRekeyer &)> &commit = {});
 
     /**
      * @brief 清除加密状态
@@ -78,24 +280,132 @@ signals:
      */
     void cryptoError(const QString &error);
 
+    /**
+     * @brief 异步初始化完成信号
+     * @param success 是否成功
+     */
+    void initializationFinished(bool success);
+
+    /**
+     * @brief 异步验证完成信号
+     * @param success 密码是否正确
+     */
+    void verificationFinished(bool success);
+
 private:
     explicit CryptoManager(QObject *parent = nullptr);
     ~CryptoManager() override;
 
     static CryptoManager *s_instance;  // 单例实例
 
-    QByteArray m_encryptionKey;        // 加密密钥
+    QByteArray m_encryptionKey;        // 主密钥，只用于迁移版本1数据库
+    QByteArray m_fieldKey;             // 从主密钥扩展出的字段加密密钥
+    QByteArray m_recordKey;            // 从主密钥扩展出的记录信封密钥
+    QByteArray m_databaseKey;          // 从主密钥扩展出的数据库密钥
     QByteArray m_salt;                 // 盐值
+    int m_iterations;                  // 与盐值配套的密钥派生迭代次数
     bool m_initialized;                // 是否已初始化
     QSettings m_settings;              // 设置存储
+    DerivedKeyCache m_keyCache;        // 短期派生密钥缓存
 
     /**
-     * @brief 从主密码生成加密密钥
+     * @brief 使用当前盐值和迭代次数从主密码生成加密密钥，优先使用缓存
      * @param masterPassword 主密码
      * @return 生成的密钥
      */
     QByteArray deriveKey(const QString &masterPassword);
 
+    /**
+     * @brief 从主密码生成加密密钥（不访问成员状态，可在工作线程中调用）
+     *
+     * 每轮计算SHA-256(上一轮结果 + 密码 + 盐值)，中间结果保存在定长缓冲区中，
+     * 循环内不分配内存
+     * @param masterPassword 主密码
+     * @param salt 盐值
+     * @param iterations 迭代次数
+     * @return 生成的密钥
+     */
+    static QByteArray deriveKey(const QString &masterPassword, const QByteArray &salt, int iterations);
+
+    /**
+     * @brief 在后台线程中使用当前盐值和迭代次数生成加密密钥
+     *
+     * 先查询派生密钥缓存，未命中时在Qt Concurrent线程池中派生，
+     * 结果在本对象所在线程写入缓存
+     * @param masterPassword 主密码
+     * @return 密钥的future
+     */
+    QFuture<QByteArray> deriveKeyAsync(const QString &masterPassword);
+
+    /**
+     * @brief 按用途从主密钥扩展出子密钥（HMAC-SHA256）
+     * @param masterKey 主密钥
+     * @param label 用途标签
+     * @return 32字节子密钥
+     */
+    static QByteArray expandKey(const QByteArray &masterKey, const QByteArray &label);
+
+    /**
+     * @brief 使用派生好的密钥完成初始化
+     * @param key 派生密钥
+     * @return 初始化是否成功
+     */
+    bool finishInitialization(const QByteArray &key);
+
+    /**
+     * @brief 检查派生密钥能否解密验证数据
+     * @param key 派生密钥
+     * @return 密钥是否正确
+     */
+    bool verifyDerivedKey(const QByteArray &key);
+
+    /**
+     * @brief 使用指定密钥解密（不访问成员状态，可在工作线程中调用）
+     *
+     * 只接受AES-256-GCM格式，格式不对或认证失败时返回失败
+     * @param key 字段密钥
+     * @param ciphertext 二进制密文
+     * @param ok 输出参数，数据为空或认证通过时为true
+     * @return 解密后的明文字符串，失败时为空字符串
+     */
+    static QString openWithKey(const QByteArray &key, QByteArrayView ciphertext, bool *ok = nullptr);
+
+    /**
+     * @brief 使用主密钥解密旧的XOR格式数据（不访问成员状态，可在工作线程中调用）
+     *
+     * 旧格式没有认证，任何输入都能“解密”，只能用于确定是旧格式的数据
+     * @param legacyKey 主密钥
+     * @param ciphertext 二进制密文
+     * @param ok 输出参数，数据为空或长度有效时为true
+     * @return 解密后的明文字符串
+     */
+    static QString openLegacyWithKey(const QByteArray &legacyKey, QByteArrayView ciphertext,
+                                     bool *ok = nullptr);
+
+    /**
+     * @brief 使用指定密钥加密（不访问成员状态，可在工作线程中调用）
+     * @param key 字段密钥
+     * @param plaintext 明文字符串
+     * @return 二进制密文，明文为空时返回空QByteArray
+     */
+    static QByteArray sealWithKey(const QByteArray &key, const QString &plaintext);
+
+    /**
+     * @brief 使用指定密钥打包并加密一条记录（不访问成员状态，可在工作线程中调用）
+     * @param key 记录信封密钥
+     * @param fields 字段明文
+     * @return 二进制密文，失败时返回空QByteArray
+     */
+    static QByteArray sealRecordWithKey(const QByteArray &key, const QStringList &fields);
+
+    /**
+     * @brief 使用指定密钥解密并拆分一条记录（不访问成员状态，可在工作线程中调用）
+     * @param key 记录信封密钥
+     * @param envelope 二进制密文
+     * @return 字段明文，认证失败或格式错误时返回空列表
+     */
+    static QStringList openRecordWithKey(const QByteArray &key, QByteArrayView envelope);
+
     /**
      * @brief 生成随机盐值
      * @return 随机盐值
@@ -118,7 +428,7 @@ private:
      * @param length 字节长度
      * @return 随机字节数组
      */
-    QByteArray generateRandomBytes(int length);
+    static QByteArray generateRandomBytes(int length);
 };
 
 #endif // CRYPTOMANAGER_H 
\ No newline at end of file
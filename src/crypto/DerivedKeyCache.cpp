@@ -0,0 +1,252 @@
+#include "DerivedKeyCache.h"
+#include <QDebug>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <cstring>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#endif
+
+/**
+ * @brief 清零内存，使用volatile指针防止被编译器优化掉
+ * @param data 内存地址
+ * @param size 字节数
+ */
+static void secureZero(void *data, size_t size)
+{
+    volatile char *p = static_cast<volatile char *>(data);
+    while (size--) {
+        *p++ = 0;
+    }
+}
+
+/**
+ * @brief 常量时间比较两段内存，避免通过比较耗时泄露摘要
+ * @return 内容相同返回true
+ */
+static bool constantTimeEquals(const char *a, const char *b, size_t size)
+{
+    unsigned char diff = 0;
+    for (size_t i = 0; i < size; ++i) {
+        diff |= static_cast<unsigned char>(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+/**
+ * @brief 构造函数，分配并锁定条目内存
+ * @param timeToLiveMs 条目有效期（毫秒）
+ */
+DerivedKeyCache::DerivedKeyCache(int timeToLiveMs)
+    : m_entries(new Entry[CAPACITY])
+    , m_secret(KEY_SIZE, Qt::Uninitialized)
+    , m_timeToLiveMs(timeToLiveMs)
+    , m_memoryLocked(false)
+{
+    for (int i = 0; i < CAPACITY; ++i) {
+        wipeEntry(m_entries[i]);
+    }
+
+    m_purgeTimer.setSingleShot(true);
+    QObject::connect(&m_purgeTimer, &QTimer::timeout, [this]() {
+        purgeExpired();
+    });
+
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32 *>(m_secret.data()),
+                                          KEY_SIZE / sizeof(quint32));
+
+#if defined(Q_OS_WIN)
+    m_memoryLocked = VirtualLock(m_entries, sizeof(Entry) * CAPACITY) != 0;
+#elif defined(Q_OS_UNIX)
+    m_memoryLocked = mlock(m_entries, sizeof(Entry) * CAPACITY) == 0;
+#endif
+
+    if (!m_memoryLocked) {
+        qWarning() << "Failed to lock derived key cache memory, keys may be swapped to disk";
+    }
+}
+
+/**
+ * @brief 析构函数，清零并释放条目内存
+ */
+DerivedKeyCache::~DerivedKeyCache()
+{
+    clear();
+    secureZero(m_secret.data(), m_secret.size());
+
+#if defined(Q_OS_WIN)
+    if (m_memoryLocked) {
+        VirtualUnlock(m_entries, sizeof(Entry) * CAPACITY);
+    }
+#elif defined(Q_OS_UNIX)
+    if (m_memoryLocked) {
+        munlock(m_entries, sizeof(Entry) * CAPACITY);
+    }
+#endif
+
+    delete[] m_entries;
+}
+
+/**
+ * @brief 查找缓存的派生密钥
+ * @param password 主密码
+ * @param salt 盐值
+ * @param iterations 迭代次数
+ * @return 命中时返回密钥，否则返回空QByteArray
+ */
+QByteArray DerivedKeyCache::lookup(const QString &password, const QByteArray &salt, int iterations)
+{
+    purgeExpired();
+
+    QByteArray tag = computeTag(password, salt, iterations);
+    QByteArray result;
+    for (int i = 0; i < CAPACITY; ++i) {
+        const Entry &entry = m_entries[i];
+        if (entry.used && constantTimeEquals(entry.tag.data(), tag.constData(), KEY_SIZE)) {
+            result = QByteArray(entry.key.data(), KEY_SIZE);
+            break;
+        }
+    }
+
+    secureZero(tag.data(), tag.size());
+    return result;
+}
+
+/**
+ * @brief 缓存派生密钥
+ * @param password 主密码
+ * @param salt 盐值
+ * @param iterations 迭代次数
+ * @param key 派生密钥
+ */
+void DerivedKeyCache::insert(const QString &password, const QByteArray &salt, int iterations, const QByteArray &key)
+{
+    if (m_timeToLiveMs <= 0 || key.size() != KEY_SIZE) {
+        return;
+    }
+
+    purgeExpired();
+
+    QByteArray tag = computeTag(password, salt, iterations);
+
+    // 优先复用相同键或空闲的条目，否则替换最早过期的条目
+    Entry *slot = nullptr;
+    for (int i = 0; i < CAPACITY && !slot; ++i) {
+        Entry &entry = m_entries[i];
+        if (entry.used && constantTimeEquals(entry.tag.data(), tag.constData(), KEY_SIZE)) {
+            slot = &entry;
+        }
+    }
+    for (int i = 0; i < CAPACITY && !slot; ++i) {
+        if (!m_entries[i].used) {
+            slot = &m_entries[i];
+        }
+    }
+    if (!slot) {
+        slot = &m_entries[0];
+        for (int i = 1; i < CAPACITY; ++i) {
+            if (m_entries[i].expiry < slot->expiry) {
+                slot = &m_entries[i];
+            }
+        }
+    }
+
+    std::memcpy(slot->tag.data(), tag.constData(), KEY_SIZE);
+    std::memcpy(slot->key.data(), key.constData(), KEY_SIZE);
+    slot->expiry = QDeadlineTimer(m_timeToLiveMs);
+    slot->used = true;
+
+    secureZero(tag.data(), tag.size());
+    schedulePurge();
+}
+
+/**
+ * @brief 清零并清空所有条目
+ */
+void DerivedKeyCache::clear()
+{
+    m_purgeTimer.stop();
+    for (int i = 0; i < CAPACITY; ++i) {
+        wipeEntry(m_entries[i]);
+    }
+}
+
+/**
+ * @brief 设置条目有效期
+ * @param timeToLiveMs 有效期（毫秒）
+ */
+void DerivedKeyCache::setTimeToLive(int timeToLiveMs)
+{
+    m_timeToLiveMs = timeToLiveMs;
+    if (m_timeToLiveMs <= 0) {
+        clear();
+    }
+}
+
+/**
+ * @brief 计算(盐值, 迭代次数, 密码)的摘要
+ * @return 32字节摘要
+ */
+QByteArray DerivedKeyCache::computeTag(const QString &password, const QByteArray &salt, int iterations) const
+{
+    QByteArray passwordBytes = password.toUtf8();
+    const qint32 iterationsValue = iterations;
+
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, m_secret);
+    mac.addData(salt);
+    mac.addData(QByteArrayView(reinterpret_cast<const char *>(&iterationsValue), sizeof(iterationsValue)));
+    mac.addData(passwordBytes);
+
+    secureZero(passwordBytes.data(), passwordBytes.size());
+    return mac.result();
+}
+
+/**
+ * @brief 清零过期的条目
+ */
+void DerivedKeyCache::purgeExpired()
+{
+    for (int i = 0; i < CAPACITY; ++i) {
+        Entry &entry = m_entries[i];
+        if (entry.used && entry.expiry.hasExpired()) {
+            wipeEntry(entry);
+        }
+    }
+    schedulePurge();
+}
+
+/**
+ * @brief 把清理定时器设置到最早的过期时间
+ */
+void DerivedKeyCache::schedulePurge()
+{
+    const QDeadlineTimer *earliest = nullptr;
+    for (int i = 0; i < CAPACITY; ++i) {
+        const Entry &entry = m_entries[i];
+        if (entry.used && (!earliest || entry.expiry < *earliest)) {
+            earliest = &entry.expiry;
+        }
+    }
+
+    if (!earliest) {
+        m_purgeTimer.stop();
+        return;
+    }
+    // 定时器提前触发时没有条目过期，purgeExpired()会重新设置定时器
+    m_purgeTimer.start(static_cast<int>(earliest->remainingTime()) + 1);
+}
+
+/**
+ * @brief 清零单个条目
+ * @param entry 要清零的条目
+ */
+void DerivedKeyCache::wipeEntry(Entry &entry)
+{
+    secureZero(entry.tag.data(), entry.tag.size());
+    secureZero(entry.key.data(), entry.key.size());
+    entry.expiry = QDeadlineTimer();
+    entry.used = false;
+}
@@ -0,0 +1,105 @@
+#ifndef DERIVEDKEYCACHE_H
+#define DERIVEDKEYCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QDeadlineTimer>
+#include <QTimer>
+#include <array>
+
+/**
+ * @brief 派生密钥缓存类
+ *
+ * 短时间缓存由主密码派生出的密钥，避免解锁、验证和更改主密码时重复执行
+ * 耗时的密钥派生。条目以(盐值, 迭代次数, 密码摘要)为键，密码摘要使用
+ * 进程内随机密钥计算HMAC-SHA256，缓存中不保存明文密码。
+ * 条目存放在锁定的内存页中（不会被换出到磁盘），clear()时清零。
+ * 过期的条目由单次定时器在最早的过期时间到达时清零，不必等到下一次查找。
+ * 该类不是线程安全的，只应在CryptoManager所在线程中使用。
+ */
+class DerivedKeyCache
+{
+public:
+    static constexpr int KEY_SIZE = 32;          // 派生密钥长度
+    static constexpr int CAPACITY = 4;           // 最多缓存的条目数
+    static constexpr int DEFAULT_TTL_MS = 120000; // 默认有效期（毫秒）
+
+    explicit DerivedKeyCache(int timeToLiveMs = DEFAULT_TTL_MS);
+    ~DerivedKeyCache();
+
+    DerivedKeyCache(const DerivedKeyCache &) = delete;
+    DerivedKeyCache &operator=(const DerivedKeyCache &) = delete;
+
+    /**
+     * @brief 查找缓存的派生密钥
+     * @param password 主密码
+     * @param salt 盐值
+     * @param iterations 迭代次数
+     * @return 命中时返回密钥，未命中或已过期返回空QByteArray
+     */
+    QByteArray lookup(const QString &password, const QByteArray &salt, int iterations);
+
+    /**
+     * @brief 缓存派生密钥，缓存已满时替换最早过期的条目
+     * @param password 主密码
+     * @param salt 盐值
+     * @param iterations 迭代次数
+     * @param key 派生密钥，长度必须为KEY_SIZE
+     */
+    void insert(const QString &password, const QByteArray &salt, int iterations, const QByteArray &key);
+
+    /**
+     * @brief 清零并清空所有条目
+     */
+    void clear();
+
+    /**
+     * @brief 设置条目有效期，只影响之后插入的条目
+     * @param timeToLiveMs 有效期（毫秒），0表示不缓存
+     */
+    void setTimeToLive(int timeToLiveMs);
+
+    /**
+     * @brief 缓存内存是否已成功锁定
+     * @return 如果已锁定则返回true
+     */
+    bool isMemoryLocked() const { return m_memoryLocked; }
+
+private:
+    struct Entry {
+        std::array<char, KEY_SIZE> tag;     // 密码摘要
+        std::array<char, KEY_SIZE> key;     // 派生密钥
+        QDeadlineTimer expiry;              // 过期时间
+        bool used;                          // 条目是否有效
+    };
+
+    Entry *m_entries;              // 锁定内存中的条目数组
+    QByteArray m_secret;           // 计算密码摘要使用的随机密钥
+    int m_timeToLiveMs;            // 条目有效期
+    bool m_memoryLocked;           // 条目内存是否已锁定
+    QTimer m_purgeTimer;           // 在最早的过期时间触发purgeExpired()
+
+    /**
+     * @brief 计算(盐值, 迭代次数, 密码)的摘要
+     * @return 32字节摘要
+     */
+    QByteArray computeTag(const QString &password, const QByteArray &salt, int iterations) const;
+
+    /**
+     * @brief 清零过期的条目
+     */
+    void purgeExpired();
+
+    /**
+     * @brief 把清理定时器设置到最早的过期时间，没有条目时停止
+     */
+    void schedulePurge();
+
+    /**
+     * @brief 清零单个条目
+     * @param entry 要清零的条目
+     */
+    static void wipeEntry(Entry &entry);
+};
+
+#endif // DERIVEDKEYCACHE_H
@@ -0,0 +1,207 @@
+#include "FieldCipher.h"
+#include <QDebug>
+#include <QtGlobal>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <array>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief 获取AES-256-GCM算法
+ *
+ * OpenSSL 3在每次初始化时都会隐式查找EVP_aes_256_gcm()对应的实现，
+ * 这里只查找一次并一直持有
+ * @return 算法句柄
+ */
+const EVP_CIPHER *aeadCipher()
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static EVP_CIPHER *cipher = EVP_CIPHER_fetch(nullptr, "AES-256-GCM", nullptr);
+    return cipher;
+#else
+    return EVP_aes_256_gcm();
+#endif
+}
+
+/**
+ * @brief 每个线程复用的加解密上下文
+ *
+ * 记住上次使用的密钥和方向，相同时只需重新设置nonce
+ */
+struct CipherContext
+{
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    std::array<unsigned char, FieldCipher::KEY_SIZE> key{};
+    int direction = -1;    // 1加密，0解密，-1未初始化
+    std::array<unsigned char, FieldCipher::NONCE_SIZE> nonceBase{};
+    quint64 nonceCounter = 0;
+    bool nonceSeeded = false;
+
+    ~CipherContext()
+    {
+        EVP_CIPHER_CTX_free(ctx);
+        OPENSSL_cleanse(key.data(), key.size());
+    }
+
+    /**
+     * @brief 生成下一个nonce
+     *
+     * 每个线程首次使用时取一个随机的96位起点，之后与递增的计数器异或。
+     * 同一线程内nonce不会重复，不同线程的起点随机，重叠的概率可以忽略；
+     * 避免每个字段都调用一次RAND_bytes（其耗时是加密本身的数倍）
+     * @param nonce 输出缓冲区
+     * @return 是否成功
+     */
+    bool nextNonce(unsigned char *nonce)
+    {
+        if (!nonceSeeded) {
+            if (RAND_bytes(nonceBase.data(), static_cast<int>(nonceBase.size())) != 1) {
+                return false;
+            }
+            nonceSeeded = true;
+        }
+
+        std::memcpy(nonce, nonceBase.data(), nonceBase.size());
+        const quint64 counter = nonceCounter++;
+        for (int i = 0; i < 8; ++i) {
+            nonce[FieldCipher::NONCE_SIZE - 1 - i] ^= static_cast<unsigned char>(counter >> (8 * i));
+        }
+        return true;
+    }
+
+    /**
+     * @brief 按密钥、方向和nonce准备上下文
+     * @return 是否成功
+     */
+    bool prepare(const QByteArray &newKey, int newDirection, const unsigned char *nonce)
+    {
+        if (!ctx) {
+            return false;
+        }
+
+        const auto *keyData = reinterpret_cast<const unsigned char *>(newKey.constData());
+        if (direction != newDirection || CRYPTO_memcmp(key.data(), keyData, key.size()) != 0) {
+            direction = -1;
+            if (EVP_CipherInit_ex(ctx, aeadCipher(), nullptr, nullptr, nullptr, newDirection) != 1
+                || EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, FieldCipher::NONCE_SIZE, nullptr) != 1
+                || EVP_CipherInit_ex(ctx, nullptr, nullptr, keyData, nullptr, newDirection) != 1) {
+                return false;
+            }
+            std::memcpy(key.data(), keyData, key.size());
+            direction = newDirection;
+        }
+
+        // 复用已展开的轮密钥，只重置nonce和GCM状态
+        return EVP_CipherInit_ex(ctx, nullptr, nullptr, nullptr, nonce, newDirection) == 1;
+    }
+};
+
+CipherContext &threadContext()
+{
+    thread_local CipherContext context;
+    return context;
+}
+
+} // namespace
+
+/**
+ * @brief 加密并认证一段数据
+ * @param key 32字节密钥
+ * @param plaintext 明文
+ * @param out 输出参数，成功时为完整的密文
+ * @return 是否成功
+ */
+bool FieldCipher::seal(const QByteArray &key, QByteArrayView plaintext, QByteArray &out)
+{
+    if (key.size() != KEY_SIZE) {
+        return false;
+    }
+
+    // 一次分配最终大小，nonce、密文和标签都直接写入
+    out.resize(OVERHEAD + plaintext.size());
+    auto *data = reinterpret_cast<unsigned char *>(out.data());
+    unsigned char *nonce = data + 1;
+    unsigned char *body = nonce + NONCE_SIZE;
+    unsigned char *tag = body + plaintext.size();
+
+    data[0] = static_cast<unsigned char>(FORMAT_VERSION);
+
+    CipherContext &context = threadContext();
+    int length = 0;
+    const bool ok = context.nextNonce(nonce)
+        && context.prepare(key, 1, nonce)
+        && EVP_EncryptUpdate(context.ctx, nullptr, &length, data, 1) == 1
+        && EVP_EncryptUpdate(context.ctx, body, &length,
+                             reinterpret_cast<const unsigned char *>(plaintext.data()),
+                             static_cast<int>(plaintext.size())) == 1
+        && EVP_EncryptFinal_ex(context.ctx, body + length, &length) == 1
+        && EVP_CIPHER_CTX_ctrl(context.ctx, EVP_CTRL_GCM_GET_TAG, TAG_SIZE, tag) == 1;
+    if (!ok) {
+        qWarning() << "AES-256-GCM encryption failed";
+        out.clear();
+    }
+    return ok;
+}
+
+/**
+ * @brief 验证并解密一段数据
+ * @param key 32字节密钥
+ * @param sealed 密文
+ * @param out 输出参数，成功时为明文
+ * @return 格式正确且认证通过返回true
+ */
+bool FieldCipher::open(const QByteArray &key, QByteArrayView sealed, QByteArray &out)
+{
+    if (key.size() != KEY_SIZE || !looksSealed(sealed)) {
+        return false;
+    }
+
+    const auto *data = reinterpret_cast<const unsigned char *>(sealed.data());
+    const unsigned char *nonce = data + 1;
+    const unsigned char *body = nonce + NONCE_SIZE;
+    const int bodySize = static_cast<int>(sealed.size()) - OVERHEAD;
+    // EVP_CTRL_GCM_SET_TAG的参数不是const，复制一份标签
+    std::array<unsigned char, TAG_SIZE> tag;
+    std::memcpy(tag.data(), body + bodySize, TAG_SIZE);
+
+    out.resize(bodySize);
+    auto *plain = reinterpret_cast<unsigned char *>(out.data());
+
+    CipherContext &context = threadContext();
+    int length = 0;
+    const bool ok = context.prepare(key, 0, nonce)
+        && EVP_DecryptUpdate(context.ctx, nullptr, &length, data, 1) == 1
+        && EVP_DecryptUpdate(context.ctx, plain, &length, body, bodySize) == 1
+        && EVP_CIPHER_CTX_ctrl(context.ctx, EVP_CTRL_GCM_SET_TAG, TAG_SIZE, tag.data()) == 1
+        && EVP_DecryptFinal_ex(context.ctx, plain + length, &length) == 1;
+    if (!ok) {
+        // 认证失败时不能留下未经验证的明文
+        OPENSSL_cleanse(out.data(), out.size());
+        out.clear();
+    }
+    return ok;
+}
+
+/**
+ * @brief 检查数据是否可能是本格式的密文
+ * @param data 数据
+ * @return 可能是本格式时返回true
+ */
+bool FieldCipher::looksSealed(QByteArrayView data)
+{
+    return data.size() >= OVERHEAD && data.front() == FORMAT_VERSION;
+}
+
+/**
+ * @brief 生成密码学安全的随机字节
+ * @param data 输出缓冲区
+ * @param size 字节数
+ * @return 是否成功
+ */
+bool FieldCipher::randomBytes(char *data, int size)
+{
+    return RAND_bytes(reinterpret_cast<unsigned char *>(data), size) == 1;
+}
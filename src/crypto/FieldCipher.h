@@ -0,0 +1,63 @@
+#ifndef FIELDCIPHER_H
+#define FIELDCIPHER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+/**
+ * @brief 字段加密引擎（AES-256-GCM）
+ *
+ * 使用SQLCipher已经链接的OpenSSL libcrypto，CPU支持时自动走AES-NI和
+ * PCLMULQDQ（CLMUL）路径。每个字段使用唯一的96位nonce，并带16字节认证标签，
+ * 数据被篡改或密钥错误时解密失败而不是返回乱码。
+ *
+ * 密文格式：版本(1字节) | nonce(12字节) | 密文 | 标签(16字节)，
+ * 版本字节同时作为附加认证数据。nonce由每个线程的随机起点和计数器生成。
+ * 输出缓冲区按最终大小一次分配，加解密直接写入其中。每个线程复用一个
+ * EVP上下文，密钥不变时不重复计算轮密钥，可以在Qt Concurrent的工作线程中
+ * 并行调用。
+ */
+class FieldCipher
+{
+public:
+    static constexpr int KEY_SIZE = 32;      // 密钥长度
+    static constexpr int NONCE_SIZE = 12;    // nonce长度
+    static constexpr int TAG_SIZE = 16;      // 认证标签长度
+    static constexpr char FORMAT_VERSION = 0x01;                  // 密文格式版本
+    static constexpr int OVERHEAD = 1 + NONCE_SIZE + TAG_SIZE;    // 每个字段的额外字节数
+
+    /**
+     * @brief 加密并认证一段数据
+     * @param key 32字节密钥
+     * @param plaintext 明文
+     * @param out 输出参数，成功时为完整的密文
+     * @return 是否成功
+     */
+    static bool seal(const QByteArray &key, QByteArrayView plaintext, QByteArray &out);
+
+    /**
+     * @brief 验证并解密一段数据
+     * @param key 32字节密钥
+     * @param sealed seal()生成的密文
+     * @param out 输出参数，成功时为明文
+     * @return 格式正确且认证通过返回true
+     */
+    static bool open(const QByteArray &key, QByteArrayView sealed, QByteArray &out);
+
+    /**
+     * @brief 检查数据是否可能是本格式的密文（只检查版本和长度）
+     * @param data 数据
+     * @return 可能是本格式时返回true
+     */
+    static bool looksSealed(QByteArrayView data);
+
+    /**
+     * @brief 生成密码学安全的随机字节
+     * @param data 输出缓冲区
+     * @param size 字节数
+     * @return 是否成功
+     */
+    static bool randomBytes(char *data, int size);
+};
+
+#endif // FIELDCIPHER_H
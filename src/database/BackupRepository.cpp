@@ -0,0 +1,319 @@
+#include "BackupRepository.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <array>
+
+// 清单文件的扩展名
+static const QString MANIFEST_SUFFIX = QStringLiteral("manifest");
+
+/**
+ * @brief 获取Gear滚动哈希使用的随机表
+ *
+ * 由固定种子经splitmix64生成，保证不同版本、不同机器切出的边界一致
+ * @return 256项随机表
+ */
+static const std::array<quint64, 256> &gearTable()
+{
+    static const std::array<quint64, 256> table = [] {
+        std::array<quint64, 256> values{};
+        quint64 state = 0x5EC2E7700100CDCull;
+        for (quint64 &value : values) {
+            state += 0x9E3779B97F4A7C15ull;
+            quint64 z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            value = z ^ (z >> 31);
+        }
+        return values;
+    }();
+    return table;
+}
+
+/**
+ * @brief 计算数据的十六进制SHA-256
+ */
+static QByteArray sha256Hex(const char *data, qsizetype length)
+{
+    return QCryptographicHash::hash(QByteArrayView(data, length), QCryptographicHash::Sha256).toHex();
+}
+
+/**
+ * @brief 构造函数
+ * @param rootPath 仓库根目录
+ */
+BackupRepository::BackupRepository(const QString &rootPath)
+    : m_rootPath(rootPath)
+{
+}
+
+/**
+ * @brief 创建仓库目录
+ * @return 是否成功
+ */
+bool BackupRepository::initialize()
+{
+    QDir root(m_rootPath);
+    if (!root.mkpath(QStringLiteral("chunks")) || !root.mkpath(QStringLiteral("snapshots"))) {
+        m_errorString = QStringLiteral("无法创建备份仓库目录: %1").arg(m_rootPath);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 为指定文件创建一个快照
+ * @param filePath 要备份的文件
+ * @param stats 输出统计信息
+ * @return 新清单的路径，失败时返回空字符串
+ */
+QString BackupRepository::createSnapshot(const QString &filePath, BackupSnapshotStats *stats)
+{
+    if (!initialize()) {
+        return QString();
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = QStringLiteral("无法读取数据库文件: %1").arg(file.errorString());
+        return QString();
+    }
+
+    // 优先映射整个文件，映射失败时一次性读入
+    const qint64 size = file.size();
+    QByteArray fallback;
+    const uchar *data = size > 0 ? file.map(0, size) : nullptr;
+    if (!data) {
+        fallback = file.readAll();
+        data = reinterpret_cast<const uchar *>(fallback.constData());
+    }
+
+    BackupSnapshotStats snapshotStats;
+    snapshotStats.totalBytes = size;
+    QCryptographicHash fileHash(QCryptographicHash::Sha256);
+    QJsonArray chunks;
+    for (qint64 offset = 0; offset < size;) {
+        const qsizetype length = nextChunkLength(data + offset, size - offset);
+        const char *chunk = reinterpret_cast<const char *>(data + offset);
+        const QByteArray hash = sha256Hex(chunk, length);
+        fileHash.addData(QByteArrayView(chunk, length));
+
+        bool written = false;
+        if (!storeChunk(hash, chunk, length, &written)) {
+            return QString();
+        }
+        if (written) {
+            ++snapshotStats.storedChunks;
+            snapshotStats.storedBytes += length;
+        }
+        ++snapshotStats.chunkCount;
+
+        QJsonObject entry;
+        entry["hash"] = QString::fromLatin1(hash);
+        entry["size"] = static_cast<qint64>(length);
+        chunks.append(entry);
+        offset += length;
+    }
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    QJsonObject manifest;
+    manifest["format"] = FORMAT_VERSION;
+    manifest["created_at"] = now.toString(Qt::ISODateWithMs);
+    manifest["size"] = size;
+    manifest["sha256"] = QString::fromLatin1(fileHash.result().toHex());
+    manifest["chunks"] = chunks;
+
+    // 同一毫秒内的多次快照追加序号，避免覆盖
+    const QString baseName = now.toString(QStringLiteral("yyyyMMdd'T'HHmmsszzz"));
+    QString manifestPath = QDir(m_rootPath).filePath(QStringLiteral("snapshots/%1.%2").arg(baseName, MANIFEST_SUFFIX));
+    for (int i = 1; QFile::exists(manifestPath); ++i) {
+        manifestPath = QDir(m_rootPath).filePath(
+            QStringLiteral("snapshots/%1-%2.%3").arg(baseName).arg(i).arg(MANIFEST_SUFFIX));
+    }
+
+    QSaveFile manifestFile(manifestPath);
+    if (!manifestFile.open(QIODevice::WriteOnly)
+        || manifestFile.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact)) < 0
+        || !manifestFile.commit()) {
+        m_errorString = QStringLiteral("无法写入快照清单: %1").arg(manifestFile.errorString());
+        return QString();
+    }
+
+    if (stats) {
+        *stats = snapshotStats;
+    }
+    qInfo() << "Backup snapshot" << manifestPath << "chunks" << snapshotStats.chunkCount
+            << "new" << snapshotStats.storedChunks << "bytes" << snapshotStats.storedBytes;
+    return manifestPath;
+}
+
+/**
+ * @brief 把快照还原为文件
+ * @param manifestPath 快照清单路径
+ * @param destPath 目标文件路径
+ * @return 是否成功
+ */
+bool BackupRepository::restoreSnapshot(const QString &manifestPath, const QString &destPath)
+{
+    QFile manifestFile(manifestPath);
+    if (!manifestFile.open(QIODevice::ReadOnly)) {
+        m_errorString = QStringLiteral("无法读取快照清单: %1").arg(manifestFile.errorString());
+        return false;
+    }
+    const QJsonObject manifest = QJsonDocument::fromJson(manifestFile.readAll()).object();
+    if (manifest["format"].toInt() != FORMAT_VERSION || !manifest["chunks"].isArray()) {
+        m_errorString = QStringLiteral("快照清单格式错误");
+        return false;
+    }
+
+    QSaveFile dest(destPath);
+    if (!dest.open(QIODevice::WriteOnly)) {
+        m_errorString = QStringLiteral("无法创建恢复文件: %1").arg(dest.errorString());
+        return false;
+    }
+
+    QCryptographicHash fileHash(QCryptographicHash::Sha256);
+    const QJsonArray chunks = manifest["chunks"].toArray();
+    for (const QJsonValue &value : chunks) {
+        const QJsonObject entry = value.toObject();
+        const QByteArray hash = entry["hash"].toString().toLatin1();
+        QFile chunkFile(chunkPath(hash));
+        if (!chunkFile.open(QIODevice::ReadOnly)) {
+            m_errorString = QStringLiteral("备份块缺失: %1").arg(QString::fromLatin1(hash));
+            dest.cancelWriting();
+            return false;
+        }
+        const QByteArray chunk = chunkFile.readAll();
+        if (chunk.size() != entry["size"].toInteger() || sha256Hex(chunk.constData(), chunk.size()) != hash) {
+            m_errorString = QStringLiteral("备份块已损坏: %1").arg(QString::fromLatin1(hash));
+            dest.cancelWriting();
+            return false;
+        }
+        fileHash.addData(chunk);
+        if (dest.write(chunk) != chunk.size()) {
+            m_errorString = QStringLiteral("写入恢复文件失败: %1").arg(dest.errorString());
+            dest.cancelWriting();
+            return false;
+        }
+    }
+
+    if (fileHash.result().toHex() != manifest["sha256"].toString().toLatin1()) {
+        m_errorString = QStringLiteral("快照校验失败");
+        dest.cancelWriting();
+        return false;
+    }
+    if (!dest.commit()) {
+        m_errorString = QStringLiteral("写入恢复文件失败: %1").arg(dest.errorString());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 列出仓库中的快照
+ * @return 清单路径列表，按时间从旧到新排列
+ */
+QStringList BackupRepository::snapshots() const
+{
+    const QDir dir(QDir(m_rootPath).filePath(QStringLiteral("snapshots")));
+    QStringList paths;
+    const QStringList names = dir.entryList({QStringLiteral("*.") + MANIFEST_SUFFIX}, QDir::Files, QDir::Name);
+    for (const QString &name : names) {
+        paths.append(dir.filePath(name));
+    }
+    return paths;
+}
+
+/**
+ * @brief 判断路径是否为备份仓库中的快照清单
+ * @param path 文件路径
+ * @return 是快照清单时返回true
+ */
+bool BackupRepository::isSnapshotManifest(const QString &path)
+{
+    const QFileInfo info(path);
+    return info.suffix() == MANIFEST_SUFFIX
+        && info.dir().dirName() == QStringLiteral("snapshots")
+        && QFileInfo(repositoryForManifest(path) + QStringLiteral("/chunks")).isDir();
+}
+
+/**
+ * @brief 由快照清单路径得到仓库根目录
+ * @param manifestPath 快照清单路径
+ * @return 仓库根目录
+ */
+QString BackupRepository::repositoryForManifest(const QString &manifestPath)
+{
+    QDir dir = QFileInfo(manifestPath).absoluteDir();
+    dir.cdUp();
+    return dir.absolutePath();
+}
+
+/**
+ * @brief 计算下一个块的长度
+ *
+ * 跳过最小块长度后开始滚动哈希，哈希高位的AVERAGE_CHUNK_BITS位全为0时切分，
+ * 边界只取决于附近的内容，插入或修改数据只影响相邻的块
+ * @param data 剩余数据
+ * @param length 剩余数据长度
+ * @return 块长度
+ */
+qsizetype BackupRepository::nextChunkLength(const uchar *data, qsizetype length)
+{
+    if (length <= MIN_CHUNK_SIZE) {
+        return length;
+    }
+    const std::array<quint64, 256> &gear = gearTable();
+    const quint64 mask = ((quint64(1) << AVERAGE_CHUNK_BITS) - 1) << (64 - AVERAGE_CHUNK_BITS);
+    const qsizetype limit = qMin(length, MAX_CHUNK_SIZE);
+    quint64 hash = 0;
+    for (qsizetype i = MIN_CHUNK_SIZE; i < limit; ++i) {
+        hash = (hash << 1) + gear[data[i]];
+        if ((hash & mask) == 0) {
+            return i + 1;
+        }
+    }
+    return limit;
+}
+
+/**
+ * @brief 获取块文件的路径
+ * @param hash 十六进制SHA-256
+ * @return 块文件路径
+ */
+QString BackupRepository::chunkPath(const QByteArray &hash) const
+{
+    const QString name = QString::fromLatin1(hash);
+    return QDir(m_rootPath).filePath(QStringLiteral("chunks/%1/%2").arg(name.left(2), name));
+}
+
+/**
+ * @brief 保存一个块，已存在时跳过
+ * @return 是否成功
+ */
+bool BackupRepository::storeChunk(const QByteArray &hash, const char *data, qsizetype length, bool *written)
+{
+    *written = false;
+    const QString path = chunkPath(hash);
+    if (QFileInfo(path).size() == length) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile chunkFile(path);
+    if (!chunkFile.open(QIODevice::WriteOnly)
+        || chunkFile.write(data, length) != length
+        || !chunkFile.commit()) {
+        m_errorString = QStringLiteral("无法写入备份块: %1").arg(chunkFile.errorString());
+        return false;
+    }
+    *written = true;
+    return true;
+}
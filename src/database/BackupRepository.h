@@ -0,0 +1,126 @@
+#ifndef BACKUPREPOSITORY_H
+#define BACKUPREPOSITORY_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+/**
+ * @brief 一次快照的统计信息
+ */
+struct BackupSnapshotStats
+{
+    qint64 totalBytes = 0;   // 快照对应的数据库文件大小
+    qint64 storedBytes = 0;  // 本次新写入的块大小
+    int chunkCount = 0;      // 快照包含的块数
+    int storedChunks = 0;    // 本次新写入的块数
+};
+
+/**
+ * @brief 去重的增量备份仓库
+ *
+ * 数据库文件按内容定义的边界（Gear滚动哈希）切分成2KB到64KB、平均约8KB的块，
+ * 每个块以SHA-256命名，只在chunks/目录下保存一份；每次快照在snapshots/目录下
+ * 写一个JSON清单，按顺序列出块的哈希和大小。SQLCipher按页加密，未修改的页
+ * 密文不变，所以相邻快照的绝大多数块可以复用，备份耗时和占用的空间取决于
+ * 改动的多少而不是数据库的大小。
+ *
+ * 目录结构：
+ *   <仓库>/chunks/<哈希前两位>/<哈希>
+ *   <仓库>/snapshots/<时间>.manifest
+ *
+ * 恢复时按清单拼接各块，并校验每块和整个文件的SHA-256。
+ */
+class BackupRepository
+{
+public:
+    static constexpr qsizetype MIN_CHUNK_SIZE = 2 * 1024;    // 最小块大小
+    static constexpr qsizetype MAX_CHUNK_SIZE = 64 * 1024;   // 最大块大小
+    static constexpr int AVERAGE_CHUNK_BITS = 13;            // 平均块大小为2^13字节
+    static constexpr int FORMAT_VERSION = 1;                 // 清单格式版本
+
+    /**
+     * @brief 构造函数
+     * @param rootPath 仓库根目录
+     */
+    explicit BackupRepository(const QString &rootPath);
+
+    /**
+     * @brief 创建仓库目录（已存在时直接返回成功）
+     * @return 是否成功
+     */
+    bool initialize();
+
+    /**
+     * @brief 为指定文件创建一个快照
+     * @param filePath 要备份的文件，调用方需保证读取期间文件不被修改
+     * @param stats 输出本次快照的统计信息，可为nullptr
+     * @return 新清单的路径，失败时返回空字符串
+     */
+    QString createSnapshot(const QString &filePath, BackupSnapshotStats *stats = nullptr);
+
+    /**
+     * @brief 把快照还原为文件
+     * @param manifestPath 快照清单路径
+     * @param destPath 目标文件路径
+     * @return 是否成功，任一块缺失或校验失败都会返回false
+     */
+    bool restoreSnapshot(const QString &manifestPath, const QString &destPath);
+
+    /**
+     * @brief 列出仓库中的快照
+     * @return 清单路径列表，按时间从旧到新排列
+     */
+    QStringList snapshots() const;
+
+    /**
+     * @brief 获取最后的错误信息
+     * @return 错误信息
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief 判断路径是否为备份仓库中的快照清单
+     * @param path 文件路径
+     * @return 是快照清单时返回true
+     */
+    static bool isSnapshotManifest(const QString &path);
+
+    /**
+     * @brief 由快照清单路径得到仓库根目录
+     * @param manifestPath 快照清单路径
+     * @return 仓库根目录
+     */
+    static QString repositoryForManifest(const QString &manifestPath);
+
+private:
+    QString m_rootPath;      // 仓库根目录
+    QString m_errorString;   // 最后的错误信息
+
+    /**
+     * @brief 计算下一个块的长度
+     * @param data 剩余数据
+     * @param length 剩余数据长度
+     * @return 块长度
+     */
+    static qsizetype nextChunkLength(const uchar *data, qsizetype length);
+
+    /**
+     * @brief 获取块文件的路径
+     * @param hash 十六进制SHA-256
+     * @return 块文件路径
+     */
+    QString chunkPath(const QByteArray &hash) const;
+
+    /**
+     * @brief 保存一个块，已存在时跳过
+     * @param hash 十六进制SHA-256
+     * @param data 块内容
+     * @param length 块长度
+     * @param written 输出是否新写入了文件
+     * @return 是否成功
+     */
+    bool storeChunk(const QByteArray &hash, const char *data, qsizetype length, bool *written);
+};
+
+#endif // BACKUPREPOSITORY_H
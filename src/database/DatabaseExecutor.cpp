@@ -0,0 +1,44 @@
+#include "DatabaseExecutor.h"
+#include <QThread>
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+DatabaseExecutor::DatabaseExecutor(QObject *parent)
+    : QObject(parent)
+{
+    // 只保留一个线程且永不回收，任务严格按提交顺序串行执行
+    m_pool.setMaxThreadCount(1);
+    m_pool.setExpiryTimeout(-1);
+    m_pool.setObjectName(QStringLiteral("DatabaseExecutor"));
+}
+
+/**
+ * @brief 析构函数，等待剩余任务完成
+ */
+DatabaseExecutor::~DatabaseExecutor()
+{
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief 等待队列中的所有任务执行完毕
+ */
+void DatabaseExecutor::waitForIdle()
+{
+    // 在数据库线程中等待自身会死锁
+    if (isExecutorThread()) {
+        return;
+    }
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief 检查当前是否在数据库线程中执行
+ * @return 在数据库线程中返回true
+ */
+bool DatabaseExecutor::isExecutorThread() const
+{
+    return m_pool.contains(QThread::currentThread());
+}
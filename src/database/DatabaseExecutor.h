@@ -0,0 +1,121 @@
+#ifndef DATABASEEXECUTOR_H
+#define DATABASEEXECUTOR_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief 数据库专用的串行执行线程
+ *
+ * 内部是只有一个常驻线程的线程池，提交的任务按先后顺序排队、依次执行，
+ * 结果通过QFuture返回，调用方用then(context, ...)在自己的线程中处理。
+ * VACUUM、完整性检查、备份、导入导出等耗时任务通过submitLongRunning()异步执行，
+ * 不阻塞界面线程。单个条目的写操作通过run()在这里同步执行，与其他任务串行，
+ * 写事务不会交错；run()会等待排在前面的任务，因此有耗时任务排队或执行时
+ * （hasLongRunningTasks()），调用方应直接以“忙”拒绝写操作，而不是在界面线程中等待。
+ *
+ * 注意数据库连接并不由本线程独占：界面线程仍在同一连接上读取（如分批加载
+ * 列表的游标），由SQLCipherWrapper的连接锁和SQLite的串行模式保证安全。
+ * VACUUM等要求连接上没有未完成语句的任务，提交前需先结束界面线程的游标。
+ */
+class DatabaseExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DatabaseExecutor(QObject *parent = nullptr);
+    ~DatabaseExecutor() override;
+
+    /**
+     * @brief 提交任务到数据库线程
+     * @param function 在数据库线程中执行的可调用对象
+     * @return 任务结果的future
+     */
+    template <typename Function>
+    QFuture<std::invoke_result_t<std::decay_t<Function>>> submit(Function &&function)
+    {
+        return QtConcurrent::run(&m_pool, std::forward<Function>(function));
+    }
+
+    /**
+     * @brief 提交耗时任务到数据库线程
+     *
+     * 任务从提交起到执行结束都计入hasLongRunningTasks()，
+     * 在future的后续处理运行之前就已经不再计入
+     * @param function 在数据库线程中执行的可调用对象
+     * @return 任务结果的future
+     */
+    template <typename Function>
+    QFuture<std::invoke_result_t<std::decay_t<Function>>> submitLongRunning(Function &&function)
+    {
+        m_longRunningTasks.fetch_add(1);
+        return submit([this, function = std::forward<Function>(function)]() mutable {
+            const LongRunningScope scope{m_longRunningTasks};
+            return function();
+        });
+    }
+
+    /**
+     * @brief 检查是否有耗时任务在排队或执行
+     *
+     * 此时run()要等它们全部结束才能执行，界面线程的写操作应直接拒绝
+     * @return 有耗时任务时返回true
+     */
+    bool hasLongRunningTasks() const { return m_longRunningTasks.load() > 0; }
+
+    /**
+     * @brief 在数据库线程中执行任务并等待结果
+     *
+     * 用于单个条目的写操作：与已排队的任务串行执行，不会与它们的事务交错。
+     * 会一直等到排在前面的任务结束，调用前应先检查hasLongRunningTasks()。
+     * 已在数据库线程中调用时直接执行
+     * @param function 在数据库线程中执行的可调用对象
+     * @return 任务结果
+     */
+    template <typename Function>
+    std::invoke_result_t<std::decay_t<Function>> run(Function &&function)
+    {
+        if (isExecutorThread()) {
+            return function();
+        }
+        auto future = submit(std::forward<Function>(function));
+        if constexpr (std::is_void_v<std::invoke_result_t<std::decay_t<Function>>>) {
+            future.waitForFinished();
+        } else {
+            return future.result();
+        }
+    }
+
+    /**
+     * @brief 等待队列中的所有任务执行完毕
+     *
+     * 关闭数据库连接前调用，保证没有任务仍在使用连接
+     */
+    void waitForIdle();
+
+    /**
+     * @brief 检查当前是否在数据库线程中执行
+     * @return 在数据库线程中返回true
+     */
+    bool isExecutorThread() const;
+
+private:
+    /**
+     * @brief 耗时任务结束时减少计数（包括抛出异常时）
+     */
+    struct LongRunningScope
+    {
+        std::atomic<int> &count;
+        ~LongRunningScope() { count.fetch_sub(1); }
+    };
+
+    QThreadPool m_pool;                      // 单线程线程池，任务按提交顺序执行
+    std::atomic<int> m_longRunningTasks{0};  // 已提交但尚未结束的耗时任务数
+};
+
+#endif // DATABASEEXECUTOR_H
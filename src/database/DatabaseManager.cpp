@@ -4,16 +4,97 @@
 #include <QDebug>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
 #include <QFile>
 #include <QDateTime>
 #include <QVariant>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QCryptographicHash>
 #include "../crypto/CryptoManager.h"
+#include "BackupRepository.h"
 
 // 静态成员初始化
 DatabaseManager* DatabaseManager::s_instance = nullptr;
 
 // 数据库版本常量
-static const int DATABASE_VERSION = 1;
+// 版本2：密文存为BLOB，时间戳存为UTC毫秒整数
+// 版本3：增加secrets列，保存打包加密的记录信封
+static const int DATABASE_VERSION = 3;
+
+// 是否以记录信封写入新条目的设置项
+static const QString RECORD_ENVELOPE_SETTINGS_KEY = QStringLiteral("database/record_envelope");
+
+// 数据库已使用原始密钥的标记，存在时不再尝试旧的口令密钥。
+// 每个数据库文件一个标记，键名后接规范路径的哈希
+static const QString RAW_KEY_SETTINGS_GROUP = QStringLiteral("database/raw_key_files/");
+
+// 版本1升级到版本2时每个事务转换的行数
+static const int MIGRATION_BATCH_SIZE = 500;
+
+// 数据库文件的页大小（SQLCipher 4的默认值），新建数据库一律使用
+static const int CIPHER_PAGE_SIZE = 4096;
+
+// 重建全文搜索索引时每批读取的行数
+static const int SEARCH_INDEX_BATCH_SIZE = 256;
+
+// trigram分词器能匹配的最短搜索词长度
+static const int SEARCH_TRIGRAM_LENGTH = 3;
+
+// 批量导入时每个事务写入的行数
+static const int IMPORT_CHUNK_SIZE = 1000;
+
+// 导出时每批解密的记录数
+static const int EXPORT_BATCH_SIZE = 256;
+
+// 在线备份每步复制的页数
+static const int BACKUP_PAGES_PER_STEP = 256;
+
+// 导入结果中最多收集的记录数，超过后改为由调用方重新加载列表
+static const int IMPORT_COLLECT_LIMIT = 10000;
+
+// 数据库主文件和WAL模式下的附属文件，替换数据库时要一起移动
+static const QStringList DATABASE_FILE_SUFFIXES = {QString(), QStringLiteral("-wal"), QStringLiteral("-shm")};
+
+// 读取密码项目时使用的列，顺序与PasswordColumn一致
+static const QString PASSWORD_SELECT = QStringLiteral(
+    "SELECT id, title, username, password, website, notes, category, "
+    "created_at, updated_at, is_favorite, secrets FROM passwords");
+
+// 密码表定义，%1为表名；敏感字段为二进制密文，时间为UTC毫秒时间戳。
+// 使用记录信封的条目三个敏感字段列为空，密文在secrets列中
+static const QString PASSWORDS_TABLE = QStringLiteral(R"(
+        CREATE TABLE IF NOT EXISTS %1 (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL,
+            username BLOB,
+            password BLOB NOT NULL,
+            website TEXT,
+            notes BLOB,
+            category TEXT,
+            created_at INTEGER NOT NULL,
+            updated_at INTEGER NOT NULL,
+            is_favorite INTEGER DEFAULT 0,
+            secrets BLOB
+        )
+    )");
+
+/**
+ * @brief PASSWORD_SELECT结果中各列的索引
+ */
+enum PasswordColumn {
+    ColumnId = 0,
+    ColumnTitle,
+    ColumnUsername,
+    ColumnPassword,
+    ColumnWebsite,
+    ColumnNotes,
+    ColumnCategory,
+    ColumnCreatedAt,
+    ColumnUpdatedAt,
+    ColumnIsFavorite,
+    ColumnSecrets
+};
 
 /**
  * @brief 获取数据库管理器的单例实例
@@ -34,7 +115,10 @@ DatabaseManager* DatabaseManager::instance()
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
     , m_sqlcipher(new SQLCipherWrapper(this))
+    , m_executor(new DatabaseExecutor(this))
     , m_isEncrypted(false)
+    , m_searchIndexReady(false)
+    , m_recordEnvelope(QSettings().value(RECORD_ENVELOPE_SETTINGS_KEY, false).toBool())
 {
     // 在构造函数中不进行数据库初始化，等待调用initialize()
     
@@ -65,6 +149,8 @@ bool DatabaseManager::initialize(const QString &databasePath)
 
 bool DatabaseManager::openDatabase(const QString &databasePath)
 {
+    m_searchIndexReady = false;
+    m_executor->waitForIdle();
     if (m_sqlcipher->isConnected()) {
         m_sqlcipher->closeDatabase();
     }
@@ -74,17 +160,23 @@ bool DatabaseManager::openDatabase(const QString &databasePath)
 
 /**
  * @brief 关闭数据库连接
+ * @return 连接是否已干净地关闭
  */
-void DatabaseManager::closeDatabase()
+bool DatabaseManager::closeDatabase()
 {
+    m_searchIndexReady = false;
+    // 等待数据库线程中的任务结束后再关闭连接
+    m_executor->waitForIdle();
+    bool closed = true;
     if (m_sqlcipher->isConnected()) {
-        m_sqlcipher->closeDatabase();
+        closed = m_sqlcipher->closeDatabase();
         qInfo() << "SQLCipher database closed";
     }
     if (m_database.isOpen()) {
         m_database.close();
         QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
     }
+    return closed;
 }
 
 /**
@@ -96,6 +188,108 @@ bool DatabaseManager::isConnected() const
     return m_sqlcipher->isConnected();
 }
 
+/**
+ * @brief 获取指定数据库文件的原始密钥标记在设置中的键名
+ *
+ * 同一文件经不同写法（相对路径、符号链接）打开时得到同一个键
+ * @param databasePath 数据库文件路径
+ * @return 设置键名
+ */
+static QString rawKeySettingsKey(const QString &databasePath)
+{
+    const QFileInfo info(databasePath);
+    const QString canonical = info.canonicalFilePath();
+    const QString path = canonical.isEmpty() ? info.absoluteFilePath() : canonical;
+    return RAW_KEY_SETTINGS_GROUP
+           + QString::fromLatin1(QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Sha256).toHex());
+}
+
+/**
+ * @brief 移动数据库主文件及其-wal、-shm附属文件
+ *
+ * 不存在的文件跳过，目标位置已有的同名文件先删除
+ * @param from 源数据库路径
+ * @param to 目标数据库路径
+ * @return 是否全部移动成功
+ */
+static bool moveDatabaseFiles(const QString &from, const QString &to)
+{
+    for (const QString &suffix : DATABASE_FILE_SUFFIXES) {
+        if (!QFile::exists(from + suffix)) {
+            continue;
+        }
+        QFile::remove(to + suffix);
+        if (!QFile::rename(from + suffix, to + suffix)) {
+            qCritical() << "Failed to move" << from + suffix << "to" << to + suffix;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 删除数据库主文件及其-wal、-shm附属文件
+ * @param path 数据库路径
+ */
+static void removeDatabaseFiles(const QString &path)
+{
+    for (const QString &suffix : DATABASE_FILE_SUFFIXES) {
+        QFile::remove(path + suffix);
+    }
+}
+
+/**
+ * @brief 绑定secrets列，分别加密的条目写入NULL
+ * @param stmt 语句
+ * @param index 参数位置
+ * @param envelope 记录信封密文，为空表示不使用信封
+ */
+static void bindEnvelope(SQLCipherStatement &stmt, int index, const QByteArray &envelope)
+{
+    if (envelope.isEmpty()) {
+        stmt.bindNull(index);
+    } else {
+        stmt.bindBlob(index, envelope);
+    }
+}
+
+/**
+ * @brief 把刚写入的密文记入记录副本，副本中不保留明文
+ * @param record 记录副本
+ * @param username 用户名密文
+ * @param password 密码密文
+ * @param notes 备注密文
+ * @param envelope 记录信封密文，为空表示三个字段分别加密
+ */
+static void sealStoredRecord(PasswordRecord &record, const QByteArray &username,
+                             const QByteArray &password, const QByteArray &notes,
+                             const QByteArray &envelope)
+{
+    if (!envelope.isEmpty()) {
+        record.sealSecretEnvelope(envelope);
+        return;
+    }
+    record.username.seal(username);
+    record.password.seal(password);
+    record.notes.seal(notes);
+}
+
+/**
+ * @brief 有耗时任务在数据库线程中排队或执行时拒绝同步写操作
+ *
+ * 同步写操作要排在这些任务之后，在界面线程中等待会卡住界面直到任务结束
+ * @return 需要拒绝时返回true，并发出databaseError信号
+ */
+bool DatabaseManager::rejectWhileBusy()
+{
+    if (m_executor->isExecutorThread() || !m_executor->hasLongRunningTasks()) {
+        return false;
+    }
+    qWarning() << "Database is busy with a maintenance task, write rejected";
+    emit databaseError("Database is busy with a maintenance task");
+    return true;
+}
+
 /**
  * @brief 保存密码项目到数据库
  * @param item 要保存的密码项目
@@ -103,7 +297,7 @@ bool DatabaseManager::isConnected() const
  */
 int DatabaseManager::savePasswordItem(PasswordItem *item)
 {
-    if (!item || !isConnected()) {
+    if (!item || !isConnected() || rejectWhileBusy()) {
         return -1;
     }
 
@@ -114,32 +308,59 @@ int DatabaseManager::savePasswordItem(PasswordItem *item)
         return -1;
     }
 
-    // 加密敏感字段
-    QString encryptedPassword = crypto->encryptString(item->password());
-    QString encryptedUsername = crypto->encryptString(item->username());
-    QString encryptedNotes = crypto->encryptString(item->notes());
-
-    QString sql = QString(R"(
-        INSERT INTO passwords (title, username, password, website, notes, category, created_at, updated_at, is_favorite)
-        VALUES ('%1', '%2', '%3', '%4', '%5', '%6', '%7', '%8', %9)
-    )")
-        .arg(item->title().replace("'", "''"))
-        .arg(encryptedUsername.replace("'", "''"))
-        .arg(encryptedPassword.replace("'", "''"))
-        .arg(item->website().replace("'", "''"))
-        .arg(encryptedNotes.replace("'", "''"))
-        .arg(item->category().replace("'", "''"))
-        .arg(item->createdAt().toString(Qt::ISODate))
-        .arg(item->updatedAt().toString(Qt::ISODate))
-        .arg(item->isFavorite() ? 1 : 0);
-    if (!m_sqlcipher->execute(sql)) {
-        emit databaseError(m_sqlcipher->lastError());
+    // 加密敏感字段：记录信封只加密一次，否则三个字段分别加密
+    QByteArray encryptedPassword;
+    QByteArray encryptedUsername;
+    QByteArray encryptedNotes;
+    QByteArray envelope;
+    if (m_recordEnvelope) {
+        envelope = crypto->encryptRecord(item->record().secretPlaintexts());
+        if (envelope.isEmpty()) {
+            return -1;
+        }
+    } else {
+        encryptedPassword = crypto->encryptField(item->password());
+        encryptedUsername = crypto->encryptField(item->username());
+        encryptedNotes = crypto->encryptField(item->notes());
+    }
+
+    // 写操作在数据库线程中执行，与导入等任务串行，不会混入它们的事务
+    PasswordRecord record = item->record();
+    const qint64 newId = m_executor->run([&]() -> qint64 {
+        SQLCipherStatement stmt = m_sqlcipher->prepare(R"(
+            INSERT INTO passwords (title, username, password, website, notes, category, created_at, updated_at, is_favorite, secrets)
+            VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+        )");
+        if (!stmt.isValid()) {
+            return -1;
+        }
+        stmt.bindText(1, record.title);
+        stmt.bindBlob(2, encryptedUsername);
+        stmt.bindBlob(3, encryptedPassword);
+        stmt.bindText(4, record.website);
+        stmt.bindBlob(5, encryptedNotes);
+        stmt.bindText(6, record.category);
+        stmt.bindInt64(7, record.createdAt);
+        stmt.bindInt64(8, record.updatedAt);
+        stmt.bindInt64(9, record.isFavorite ? 1 : 0);
+        bindEnvelope(stmt, 10, envelope);
+        const qint64 id = stmt.execInsert();
+        if (id > 0) {
+            record.id = static_cast<int>(id);
+            indexPasswordRecord(record);
+        }
+        return id;
+    });
+    if (newId <= 0) {
         return -1;
     }
-    int newId = m_sqlcipher->lastInsertId();
-    item->setId(newId);
+    item->setId(static_cast<int>(newId));
     emit passwordItemSaved(item);
-    return newId;
+
+    PasswordRecord stored = item->record();
+    sealStoredRecord(stored, encryptedUsername, encryptedPassword, encryptedNotes, envelope);
+    emit passwordRecordStored(stored);
+    return static_cast<int>(newId);
 }
 
 /**
@@ -149,7 +370,7 @@ int DatabaseManager::savePasswordItem(PasswordItem *item)
  */
 bool DatabaseManager::updatePasswordItem(PasswordItem *item)
 {
-    if (!item || !isConnected() || item->id() <= 0) {
+    if (!item || !isConnected() || item->id() <= 0 || rejectWhileBusy()) {
         return false;
     }
     CryptoManager *crypto = CryptoManager::instance();
@@ -158,27 +379,54 @@ bool DatabaseManager::updatePasswordItem(PasswordItem *item)
         emit databaseError("Encryption not initialized");
         return false;
     }
-    QString encryptedPassword = crypto->encryptString(item->password());
-    QString encryptedUsername = crypto->encryptString(item->username());
-    QString encryptedNotes = crypto->encryptString(item->notes());
-    QString sql = QString(R"(
-        UPDATE passwords SET title='%1', username='%2', password='%3', website='%4', notes='%5', category='%6', updated_at='%7', is_favorite=%8 WHERE id=%9
-    )")
-        .arg(item->title().replace("'", "''"))
-        .arg(encryptedUsername.replace("'", "''"))
-        .arg(encryptedPassword.replace("'", "''"))
-        .arg(item->website().replace("'", "''"))
-        .arg(encryptedNotes.replace("'", "''"))
-        .arg(item->category().replace("'", "''"))
-        .arg(QDateTime::currentDateTime().toString(Qt::ISODate))
-        .arg(item->isFavorite() ? 1 : 0)
-        .arg(item->id());
-    if (!m_sqlcipher->execute(sql)) {
-        emit databaseError(m_sqlcipher->lastError());
+    QByteArray encryptedPassword;
+    QByteArray encryptedUsername;
+    QByteArray encryptedNotes;
+    QByteArray envelope;
+    if (m_recordEnvelope) {
+        envelope = crypto->encryptRecord(item->record().secretPlaintexts());
+        if (envelope.isEmpty()) {
+            return false;
+        }
+    } else {
+        encryptedPassword = crypto->encryptField(item->password());
+        encryptedUsername = crypto->encryptField(item->username());
+        encryptedNotes = crypto->encryptField(item->notes());
+    }
+    QDateTime now = QDateTime::currentDateTime();
+    const PasswordRecord record = item->record();
+    const bool updated = m_executor->run([&]() {
+        SQLCipherStatement stmt = m_sqlcipher->prepare(R"(
+            UPDATE passwords SET title=?, username=?, password=?, website=?, notes=?, category=?, updated_at=?, is_favorite=?, secrets=? WHERE id=?
+        )");
+        if (!stmt.isValid()) {
+            return false;
+        }
+        stmt.bindText(1, record.title);
+        stmt.bindBlob(2, encryptedUsername);
+        stmt.bindBlob(3, encryptedPassword);
+        stmt.bindText(4, record.website);
+        stmt.bindBlob(5, encryptedNotes);
+        stmt.bindText(6, record.category);
+        stmt.bindInt64(7, now.toMSecsSinceEpoch());
+        stmt.bindInt64(8, record.isFavorite ? 1 : 0);
+        bindEnvelope(stmt, 9, envelope);
+        stmt.bindInt64(10, record.id);
+        if (!stmt.exec()) {
+            return false;
+        }
+        indexPasswordRecord(record);
+        return true;
+    });
+    if (!updated) {
         return false;
     }
-    item->setUpdatedAt(QDateTime::currentDateTime());
+    item->setUpdatedAt(now);
     emit passwordItemUpdated(item);
+
+    PasswordRecord stored = item->record();
+    sealStoredRecord(stored, encryptedUsername, encryptedPassword, encryptedNotes, envelope);
+    emit passwordRecordStored(stored);
     return true;
 }
 
@@ -189,12 +437,19 @@ bool DatabaseManager::updatePasswordItem(PasswordItem *item)
  */
 bool DatabaseManager::deletePasswordItem(int id)
 {
-    if (!isConnected() || id <= 0) {
+    if (!isConnected() || id <= 0 || rejectWhileBusy()) {
         return false;
     }
-    QString sql = QString("DELETE FROM passwords WHERE id=%1").arg(id);
-    if (!m_sqlcipher->execute(sql)) {
-        emit databaseError(m_sqlcipher->lastError());
+    const bool deleted = m_executor->run([this, id]() {
+        SQLCipherStatement stmt = m_sqlcipher->prepare("DELETE FROM passwords WHERE id=?");
+        stmt.bindInt64(1, id);
+        if (!stmt.exec()) {
+            return false;
+        }
+        removeFromSearchIndex(id);
+        return true;
+    });
+    if (!deleted) {
         return false;
     }
     emit passwordItemDeleted(id);
@@ -211,10 +466,11 @@ PasswordItem* DatabaseManager::getPasswordItem(int id)
     if (!isConnected() || id <= 0) {
         return nullptr;
     }
-    QString sql = QString("SELECT * FROM passwords WHERE id=%1").arg(id);
-    QList<QVariantMap> results = m_sqlcipher->query(sql);
-    if (!results.isEmpty()) {
-        return createPasswordItemFromMap(results.first());
+    SQLCipherStatement stmt = m_sqlcipher->prepare(PASSWORD_SELECT + " WHERE id=?");
+    stmt.bindInt64(1, id);
+    SQLCipherResultSet rows = stmt.fetch(1);
+    if (rows.rowCount() > 0) {
+        return createPasswordItemFromRow(rows, 0);
     }
     return nullptr;
 }
@@ -225,18 +481,114 @@ PasswordItem* DatabaseManager::getPasswordItem(int id)
  */
 QList<PasswordItem*> DatabaseManager::getAllPasswordItems()
 {
-    QList<PasswordItem*> items;
     if (!isConnected()) {
-        return items;
-    }
-    QList<QVariantMap> results = m_sqlcipher->query("SELECT * FROM passwords ORDER BY updated_at DESC");
-    for (const QVariantMap &row : results) {
-        PasswordItem *item = createPasswordItemFromMap(row);
-        if (item) items.append(item);
+        return QList<PasswordItem*>();
     }
+    SQLCipherStatement stmt = m_sqlcipher->prepare(PASSWORD_SELECT + " ORDER BY updated_at DESC");
+    QList<PasswordItem*> items = fetchPasswordItems(stmt);
+    // 整库读取的调用方（如导出）需要全部明文，一次性并行解密
+    decryptPasswordItems(items);
     return items;
 }
 
+/**
+ * @brief 打开按更新时间倒序遍历所有密码记录的游标
+ * @return 密码记录游标，失败时isValid()为false
+ */
+PasswordRecordCursor DatabaseManager::openPasswordCursor()
+{
+    if (!isConnected()) {
+        return PasswordRecordCursor();
+    }
+    return PasswordRecordCursor(this, m_sqlcipher->prepare(PASSWORD_SELECT + " ORDER BY updated_at DESC"));
+}
+
+/**
+ * @brief 在一个只读事务中遍历所有密码记录
+ * @param visitor 对每条记录调用，返回false时停止遍历
+ * @param decryptSecrets 是否解密敏感字段
+ * @return 遍历完所有记录返回true
+ */
+bool DatabaseManager::forEachPasswordRecord(const std::function<bool(const PasswordRecord &)> &visitor,
+                                            bool decryptSecrets)
+{
+    if (!isConnected()) {
+        return false;
+    }
+
+    // 在单独的只读连接上开启读事务：得到一致的快照（WAL模式下不阻塞写入），
+    // 主连接的锁不会在整个遍历期间被占用，界面线程的读取照常进行
+    SQLCipherWrapper reader;
+    if (!reader.openReadOnly(*m_sqlcipher) || !reader.beginTransaction()) {
+        emit databaseError(reader.lastError());
+        return false;
+    }
+
+    bool completed = true;
+    {
+        PasswordRecordCursor cursor(this, reader.prepare(PASSWORD_SELECT + " ORDER BY updated_at DESC"));
+        completed = cursor.isValid();
+        while (completed && !cursor.atEnd()) {
+            QList<PasswordRecord> records = cursor.fetchBatch(EXPORT_BATCH_SIZE);
+            if (decryptSecrets) {
+                decryptPasswordRecords(records);
+            }
+            for (PasswordRecord &record : records) {
+                completed = completed && visitor(record);
+                record.wipeSecrets();
+            }
+        }
+    }
+
+    reader.commitTransaction();
+    reader.closeDatabase();
+    return completed;
+}
+
+/**
+ * @brief 并行解密一组密码项目中尚未解密的敏感字段
+ * @param items 密码项目列表
+ */
+void DatabaseManager::decryptPasswordItems(const QList<PasswordItem*> &items)
+{
+    QList<EncryptedField*> fields;
+    for (PasswordItem *item : items) {
+        fields.append(item->pendingSecretFields());
+    }
+    EncryptedField::decryptAll(fields);
+}
+
+/**
+ * @brief 并行解密一组密码记录中尚未解密的敏感字段
+ * @param records 密码记录列表
+ */
+void DatabaseManager::decryptPasswordRecords(QList<PasswordRecord> &records)
+{
+    QList<EncryptedField*> fields;
+    for (PasswordRecord &record : records) {
+        fields.append(record.pendingSecretFields());
+    }
+    EncryptedField::decryptAll(fields);
+}
+
+/**
+ * @brief 获取所有非空分类
+ * @return 按名称排序的分类列表
+ */
+QStringList DatabaseManager::getCategories()
+{
+    QStringList categories;
+    if (!isConnected()) {
+        return categories;
+    }
+    SQLCipherStatement stmt = m_sqlcipher->prepare(
+        "SELECT DISTINCT category FROM passwords WHERE category IS NOT NULL AND category != '' ORDER BY category");
+    while (stmt.next()) {
+        categories.append(stmt.columnText(0));
+    }
+    return categories;
+}
+
 /**
  * @brief 搜索密码项目
  * @param searchTerm 搜索词
@@ -244,59 +596,252 @@ QList<PasswordItem*> DatabaseManager::getAllPasswordItems()
  */
 QList<PasswordItem*> DatabaseManager::searchPasswordItems(const QString &searchTerm)
 {
-    QList<PasswordItem*> items;
-    if (!isConnected() || searchTerm.isEmpty()) {
-        return items;
-    }
-    QString escapedSearchTerm = searchTerm;
-    escapedSearchTerm.replace("'", "''");
-    QString sql = QString(R"(SELECT * FROM passwords WHERE title LIKE '%%1%' OR username LIKE '%%1%' OR website LIKE '%%1%' OR notes LIKE '%%1%' OR category LIKE '%%1%' ORDER BY updated_at DESC)").arg(escapedSearchTerm);
-    QList<QVariantMap> results = m_sqlcipher->query(sql);
-    for (const QVariantMap &row : results) {
-        PasswordItem *item = createPasswordItemFromMap(row);
-        if (item) items.append(item);
+    if (!isConnected() || searchTerm.trimmed().isEmpty()) {
+        return QList<PasswordItem*>();
     }
-    return items;
+    if (m_searchIndexReady && isIndexSearchable(searchTerm)) {
+        SQLCipherStatement stmt = m_sqlcipher->prepare(PASSWORD_SELECT + R"(
+            WHERE id IN (SELECT rowid FROM passwords_fts WHERE passwords_fts MATCH ?1)
+            ORDER BY updated_at DESC
+        )");
+        stmt.bindText(1, buildFtsQuery(searchTerm));
+        return fetchPasswordItems(stmt);
+    }
+
+    // 没有全文索引时回退为全表扫描，用户名和备注为密文无法匹配
+    SQLCipherStatement stmt = m_sqlcipher->prepare(PASSWORD_SELECT + R"(
+        WHERE title LIKE ?1 OR username LIKE ?1 OR website LIKE ?1 OR notes LIKE ?1 OR category LIKE ?1
+        ORDER BY updated_at DESC
+    )");
+    stmt.bindText(1, "%" + searchTerm + "%");
+    return fetchPasswordItems(stmt);
 }
 
 /**
- * @brief 根据分类获取密码项目
+ * @brief 根据分类获取密码记录
  * @param category 分类名称
- * @return 指定分类的密码项目列表
+ * @return 指定分类的密码记录列表
  */
-QList<PasswordItem*> DatabaseManager::getPasswordItemsByCategory(const QString &category)
+QList<PasswordRecord> DatabaseManager::getPasswordRecordsByCategory(const QString &category)
 {
-    QList<PasswordItem*> items;
     if (!isConnected()) {
-        return items;
-    }
-    QString escapedCategory = category;
-    escapedCategory.replace("'", "''");
-    QString sql = QString("SELECT * FROM passwords WHERE category='%1' ORDER BY title").arg(escapedCategory);
-    QList<QVariantMap> results = m_sqlcipher->query(sql);
-    for (const QVariantMap &row : results) {
-        PasswordItem *item = createPasswordItemFromMap(row);
-        if (item) items.append(item);
+        return QList<PasswordRecord>();
     }
-    return items;
+    SQLCipherStatement stmt = m_sqlcipher->prepare(PASSWORD_SELECT + " WHERE category=? ORDER BY title");
+    stmt.bindText(1, category);
+    return fetchPasswordRecords(stmt);
 }
 
 /**
- * @brief 获取收藏的密码项目
- * @return 收藏的密码项目列表
+ * @brief 获取收藏的密码记录
+ * @return 收藏的密码记录列表
  */
-QList<PasswordItem*> DatabaseManager::getFavoritePasswordItems()
+QList<PasswordRecord> DatabaseManager::getFavoritePasswordRecords()
 {
-    QList<PasswordItem*> items;
     if (!isConnected()) {
-        return items;
+        return QList<PasswordRecord>();
     }
-    QList<QVariantMap> results = m_sqlcipher->query("SELECT * FROM passwords WHERE is_favorite = 1 ORDER BY title");
-    for (const QVariantMap &row : results) {
-        PasswordItem *item = createPasswordItemFromMap(row);
-        if (item) items.append(item);
+    SQLCipherStatement stmt = m_sqlcipher->prepare(PASSWORD_SELECT + " WHERE is_favorite = 1 ORDER BY title");
+    return fetchPasswordRecords(stmt);
+}
+
+/**
+ * @brief 生成判断导入条目是否重复的键
+ * @param title 标题
+ * @param website 网址
+ * @return 重复判断键
+ */
+static QString importKey(const QString &title, const QString &website)
+{
+    return title + QChar(u'\x1f') + website;
+}
+
+/**
+ * @brief 获取导入条目的时间戳，无效时使用当前时间
+ * @param msecs 毫秒时间戳
+ * @return 毫秒时间戳
+ */
+static qint64 importTimestamp(qint64 msecs)
+{
+    return msecs > 0 ? msecs : QDateTime::currentMSecsSinceEpoch();
+}
+
+/**
+ * @brief 批量导入密码记录
+ * @param reader 导入数据源
+ * @param overwrite 是否覆盖重复的已有条目
+ * @param progress 进度回调，返回false时取消
+ * @return 导入结果
+ */
+PasswordImportResult DatabaseManager::importPasswordRecords(PasswordRecordReader &reader, bool overwrite,
+                                                            const std::function<bool(qint64, qint64)> &progress)
+{
+    PasswordImportResult result;
+    if (!isConnected()) {
+        result.error = QStringLiteral("数据库未连接");
+        return result;
     }
-    return items;
+    CryptoManager *crypto = CryptoManager::instance();
+    if (!crypto->isInitialized()) {
+        qCritical() << "CryptoManager not initialized";
+        emit databaseError("Encryption not initialized");
+        result.error = QStringLiteral("加密未初始化");
+        return result;
+    }
+
+    // 标题和网址不加密，一次读出全部已有条目用于判断重复
+    QHash<QString, int> existing;
+    {
+        SQLCipherStatement stmt = m_sqlcipher->prepare("SELECT id, title, website FROM passwords");
+        while (stmt.next()) {
+            existing.insert(importKey(stmt.columnText(1), stmt.columnText(2)),
+                            static_cast<int>(stmt.columnInt64(0)));
+        }
+    }
+
+    SQLCipherStatement insertStmt = m_sqlcipher->prepare(R"(
+        INSERT INTO passwords (title, username, password, website, notes, category, created_at, updated_at, is_favorite, secrets)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    )");
+    SQLCipherStatement updateStmt = m_sqlcipher->prepare(R"(
+        UPDATE passwords SET title=?1, username=?2, password=?3, website=?4, notes=?5, category=?6,
+                             created_at=?7, updated_at=?8, is_favorite=?9, secrets=?10
+        WHERE id=?11
+    )");
+    const bool useEnvelope = m_recordEnvelope;
+    if (!insertStmt.isValid() || !updateStmt.isValid()) {
+        result.error = m_sqlcipher->lastError();
+        return result;
+    }
+
+    QList<PasswordRecord> records;
+    records.reserve(IMPORT_CHUNK_SIZE);
+    for (;;) {
+        records.clear();
+        PasswordRecord next;
+        while (records.size() < IMPORT_CHUNK_SIZE && reader.readNext(next)) {
+            records.append(std::move(next));
+            next = PasswordRecord();
+        }
+        if (records.isEmpty()) {
+            break;
+        }
+        const int count = records.size();
+
+        // 整批并行加密：记录信封每行一个密文，否则每行依次为用户名、密码、备注
+        QList<QByteArray> envelopes;
+        QList<QByteArray> ciphertexts;
+        if (useEnvelope) {
+            QList<QStringList> secrets;
+            secrets.reserve(count);
+            for (const PasswordRecord &record : std::as_const(records)) {
+                secrets.append(record.secretPlaintexts());
+            }
+            envelopes = crypto->encryptRecords(secrets);
+        } else {
+            QStringList plaintexts;
+            plaintexts.reserve(count * 3);
+            for (const PasswordRecord &record : std::as_const(records)) {
+                plaintexts << record.secretPlaintexts();
+            }
+            ciphertexts = crypto->encryptFields(plaintexts);
+        }
+        if (useEnvelope ? envelopes.size() != count : ciphertexts.size() != count * 3) {
+            result.failed += count;
+            break;
+        }
+
+        if (!beginTransaction()) {
+            result.failed += count;
+            break;
+        }
+
+        const int chunkFirstRecord = result.records.size();
+        PasswordImportResult chunk;
+        for (int i = 0; i < count; ++i) {
+            PasswordRecord &record = records[i];
+            const QString key = importKey(record.title, record.website);
+            const int existingId = existing.value(key, -1);
+            if (existingId > 0 && !overwrite) {
+                ++chunk.skipped;
+                continue;
+            }
+
+            SQLCipherStatement &stmt = existingId > 0 ? updateStmt : insertStmt;
+            const int offset = i * 3;
+            const QByteArray envelope = useEnvelope ? envelopes.at(i) : QByteArray();
+            stmt.bindText(1, record.title);
+            stmt.bindBlob(2, useEnvelope ? QByteArray() : ciphertexts.at(offset));
+            stmt.bindBlob(3, useEnvelope ? QByteArray() : ciphertexts.at(offset + 1));
+            stmt.bindText(4, record.website);
+            stmt.bindBlob(5, useEnvelope ? QByteArray() : ciphertexts.at(offset + 2));
+            stmt.bindText(6, record.category);
+            stmt.bindInt64(7, importTimestamp(record.createdAt));
+            stmt.bindInt64(8, importTimestamp(record.updatedAt));
+            stmt.bindInt64(9, record.isFavorite ? 1 : 0);
+            bindEnvelope(stmt, 10, envelope);
+            if (existingId > 0) {
+                stmt.bindInt64(11, existingId);
+            }
+            const qint64 rowId = existingId > 0 ? (stmt.exec() ? existingId : -1) : stmt.execInsert();
+            if (rowId <= 0) {
+                ++chunk.failed;
+                continue;
+            }
+
+            record.id = static_cast<int>(rowId);
+            if (existingId > 0) {
+                ++chunk.updated;
+            } else {
+                existing.insert(key, record.id);
+                ++chunk.imported;
+            }
+            indexPasswordRecord(record);
+
+            // 写入后只保留密文，列表模型需要时再解密
+            if (useEnvelope) {
+                record.sealSecretEnvelope(envelope);
+            } else {
+                record.username.seal(ciphertexts.at(offset));
+                record.password.seal(ciphertexts.at(offset + 1));
+                record.notes.seal(ciphertexts.at(offset + 2));
+            }
+            if (!result.reloadRequired) {
+                result.records.append(std::move(record));
+            }
+        }
+
+        if (!commitTransaction()) {
+            rollbackTransaction();
+            result.records.resize(chunkFirstRecord);
+            result.failed += count;
+            break;
+        }
+        result.imported += chunk.imported;
+        result.updated += chunk.updated;
+        result.skipped += chunk.skipped;
+        result.failed += chunk.failed;
+
+        // 写入条目过多时不再收集，保持内存占用与导入规模无关
+        if (!result.reloadRequired && result.records.size() > IMPORT_COLLECT_LIMIT) {
+            result.reloadRequired = true;
+            result.records.clear();
+            result.records.squeeze();
+        }
+
+        if (progress && !progress(reader.progressValue(), reader.progressMaximum())) {
+            result.cancelled = true;
+            break;
+        }
+    }
+
+    if (reader.hasError()) {
+        result.error = reader.errorString();
+        qWarning() << "Import source error:" << result.error;
+    }
+    qInfo() << "Imported" << result.imported << "updated" << result.updated
+            << "skipped" << result.skipped << "failed" << result.failed;
+    return result;
 }
 
 /**
@@ -305,16 +850,241 @@ QList<PasswordItem*> DatabaseManager::getFavoritePasswordItems()
  */
 bool DatabaseManager::clearAllPasswords()
 {
-    if (!isConnected()) {
+    if (!isConnected() || rejectWhileBusy()) {
         return false;
     }
+    if (!m_executor->isExecutorThread()) {
+        return m_executor->run([this]() { return clearAllPasswords(); });
+    }
     if (!m_sqlcipher->execute("DELETE FROM passwords")) {
         emit databaseError(m_sqlcipher->lastError());
         return false;
     }
+    if (m_searchIndexReady && !m_sqlcipher->execute(
+            "INSERT INTO passwords_fts (passwords_fts) VALUES ('delete-all')")) {
+        qWarning() << "Failed to clear search index:" << m_sqlcipher->lastError();
+    }
     return true;
 }
 
+/**
+ * @brief 通过全文搜索索引查找匹配的密码项目ID
+ * @param searchTerm 搜索词
+ * @return 匹配的ID列表
+ */
+QList<int> DatabaseManager::searchPasswordIds(const QString &searchTerm)
+{
+    QList<int> ids;
+    if (!isConnected() || !m_searchIndexReady || !isIndexSearchable(searchTerm)) {
+        return ids;
+    }
+    SQLCipherStatement stmt = m_sqlcipher->prepare(
+        "SELECT rowid FROM passwords_fts WHERE passwords_fts MATCH ?1");
+    stmt.bindText(1, buildFtsQuery(searchTerm));
+    while (stmt.next()) {
+        ids.append(static_cast<int>(stmt.columnInt64(0)));
+    }
+    return ids;
+}
+
+/**
+ * @brief 在数据库线程中通过全文搜索索引查找匹配的密码项目ID
+ * @param searchTerm 搜索词
+ * @return 匹配ID列表的future
+ */
+QFuture<QList<int>> DatabaseManager::searchPasswordIdsAsync(const QString &searchTerm)
+{
+    return m_executor->submit([this, searchTerm]() {
+        return searchPasswordIds(searchTerm);
+    });
+}
+
+/**
+ * @brief 确保全文搜索索引存在且与密码表一致
+ * @return 索引是否可用
+ */
+bool DatabaseManager::ensureSearchIndex()
+{
+    // 重建索引会开启写事务，必须与导入等写任务串行
+    if (!m_executor->isExecutorThread()) {
+        return m_executor->run([this]() { return ensureSearchIndex(); });
+    }
+    m_searchIndexReady = false;
+    if (!isConnected() || !CryptoManager::instance()->isInitialized()) {
+        return false;
+    }
+
+    // 旧版本的索引使用unicode61分词并保存内容，删除后按新结构重建
+    SQLCipherStatement existing = m_sqlcipher->prepare(
+        "SELECT sql FROM sqlite_master WHERE type='table' AND name='passwords_fts'");
+    const bool outdated = existing.next() && !existing.columnText(0).contains("contentless_delete");
+    existing.reset();
+    if (outdated && !m_sqlcipher->execute("DROP TABLE passwords_fts")) {
+        qWarning() << "Failed to drop outdated search index:" << m_sqlcipher->lastError();
+        return false;
+    }
+
+    // trigram分词支持任意子串和中文匹配；索引不保存内容（contentless），
+    // 只有分词后的倒排列表，明文用户名和备注不会以原文留在表中。
+    // contentless_delete需要SQLite 3.43以上，不支持时回退为普通搜索
+    QString createSearchTable = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS passwords_fts USING fts5(
+            title, username, website, notes, category,
+            content = '',
+            contentless_delete = 1,
+            tokenize = 'trigram'
+        )
+    )";
+    if (!m_sqlcipher->execute(createSearchTable)) {
+        qWarning() << "FTS5 unavailable, falling back to LIKE search:" << m_sqlcipher->lastError();
+        return false;
+    }
+
+    SQLCipherStatement stmt = m_sqlcipher->prepare(
+        "SELECT (SELECT COUNT(*) FROM passwords), (SELECT COUNT(*) FROM passwords_fts)");
+    if (!stmt.next()) {
+        return false;
+    }
+    bool inSync = stmt.columnInt64(0) == stmt.columnInt64(1);
+    stmt.reset();
+
+    m_searchIndexReady = true;
+    if (!inSync && !rebuildSearchIndex()) {
+        m_searchIndexReady = false;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 清空并重建全文搜索索引
+ * @return 重建是否成功
+ */
+bool DatabaseManager::rebuildSearchIndex()
+{
+    qInfo() << "Rebuilding search index";
+
+    if (!beginTransaction()) {
+        return false;
+    }
+    if (!fillSearchIndex()) {
+        rollbackTransaction();
+        return false;
+    }
+    return commitTransaction();
+}
+
+/**
+ * @brief 在当前事务中清空并重新填充全文搜索索引
+ * @return 填充是否成功
+ */
+bool DatabaseManager::fillSearchIndex()
+{
+    if (!m_sqlcipher->execute("INSERT INTO passwords_fts (passwords_fts) VALUES ('delete-all')")) {
+        qCritical() << "Failed to clear search index:" << m_sqlcipher->lastError();
+        return false;
+    }
+
+    PasswordRecordCursor cursor = openPasswordCursor();
+    if (!cursor.isValid()) {
+        return false;
+    }
+    while (!cursor.atEnd()) {
+        QList<PasswordRecord> records = cursor.fetchBatch(SEARCH_INDEX_BATCH_SIZE);
+        decryptPasswordRecords(records);
+        bool ok = true;
+        for (PasswordRecord &record : records) {
+            ok = ok && indexPasswordRecord(record);
+            record.wipeSecrets();
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 将密码记录写入全文搜索索引
+ * @param record 密码记录
+ * @return 写入是否成功
+ */
+bool DatabaseManager::indexPasswordRecord(const PasswordRecord &record)
+{
+    if (!m_searchIndexReady) {
+        return false;
+    }
+
+    removeFromSearchIndex(record.id);
+
+    SQLCipherStatement stmt = m_sqlcipher->prepare(R"(
+        INSERT INTO passwords_fts (rowid, title, username, website, notes, category)
+        VALUES (?, ?, ?, ?, ?, ?)
+    )");
+    if (!stmt.isValid()) {
+        return false;
+    }
+    stmt.bindInt64(1, record.id);
+    stmt.bindText(2, record.title);
+    stmt.bindText(3, record.secret(PasswordRecord::SecretUsername));
+    stmt.bindText(4, record.website);
+    stmt.bindText(5, record.secret(PasswordRecord::SecretNotes));
+    stmt.bindText(6, record.category);
+    return stmt.exec();
+}
+
+/**
+ * @brief 从全文搜索索引中删除密码项目
+ * @param id 密码项目ID
+ */
+void DatabaseManager::removeFromSearchIndex(int id)
+{
+    if (!m_searchIndexReady) {
+        return;
+    }
+    SQLCipherStatement stmt = m_sqlcipher->prepare("DELETE FROM passwords_fts WHERE rowid=?");
+    stmt.bindInt64(1, id);
+    stmt.exec();
+}
+
+/**
+ * @brief 检查搜索词能否使用全文搜索索引
+ * @param searchTerm 搜索词
+ * @return 每个词都不短于trigram长度时返回true
+ */
+bool DatabaseManager::isIndexSearchable(const QString &searchTerm)
+{
+    const QStringList words = searchTerm.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+    if (words.isEmpty()) {
+        return false;
+    }
+    for (const QString &word : words) {
+        if (word.size() < SEARCH_TRIGRAM_LENGTH) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 将用户输入转换为FTS5子串查询表达式
+ * @param searchTerm 搜索词
+ * @return FTS5 MATCH表达式
+ */
+QString DatabaseManager::buildFtsQuery(const QString &searchTerm)
+{
+    // 每个词作为带引号的字符串，trigram分词下即为子串匹配，
+    // 同时避免用户输入被解析为FTS5语法
+    QStringList terms;
+    const QStringList words = searchTerm.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+    for (const QString &word : words) {
+        QString escaped = word;
+        escaped.replace('"', QLatin1String("\"\""));
+        terms.append('"' + escaped + '"');
+    }
+    return terms.join(' ');
+}
+
 /**
  * @brief 获取数据库统计信息
  * @return 包含统计信息的QVariantMap
@@ -325,12 +1095,17 @@ QVariantMap DatabaseManager::getDatabaseStats()
     if (!isConnected()) {
         return stats;
     }
-    QList<QVariantMap> result = m_sqlcipher->query("SELECT COUNT(*) as totalPasswords FROM passwords");
-    if (!result.isEmpty()) stats["totalPasswords"] = result.first().value("totalPasswords").toInt();
-    result = m_sqlcipher->query("SELECT COUNT(*) as favoritePasswords FROM passwords WHERE is_favorite = 1");
-    if (!result.isEmpty()) stats["favoritePasswords"] = result.first().value("favoritePasswords").toInt();
-    result = m_sqlcipher->query("SELECT COUNT(DISTINCT category) as categoriesCount FROM passwords WHERE category IS NOT NULL AND category != ''");
-    if (!result.isEmpty()) stats["categoriesCount"] = result.first().value("categoriesCount").toInt();
+    SQLCipherStatement stmt = m_sqlcipher->prepare(R"(
+        SELECT COUNT(*),
+               SUM(is_favorite = 1),
+               COUNT(DISTINCT CASE WHEN category != '' THEN category END)
+        FROM passwords
+    )");
+    if (stmt.next()) {
+        stats["totalPasswords"] = static_cast<int>(stmt.columnInt64(0));
+        stats["favoritePasswords"] = static_cast<int>(stmt.columnInt64(1));
+        stats["categoriesCount"] = static_cast<int>(stmt.columnInt64(2));
+    }
     QFileInfo fileInfo(m_databasePath);
     stats["databaseSize"] = fileInfo.size();
     stats["databasePath"] = m_databasePath;
@@ -340,32 +1115,81 @@ QVariantMap DatabaseManager::getDatabaseStats()
 /**
  * @brief 备份数据库到指定路径
  * @param backupPath 备份文件路径
+ * @param progress 进度回调，返回false时取消
  * @return 备份是否成功
  */
-bool DatabaseManager::backupDatabase(const QString &backupPath)
+bool DatabaseManager::backupDatabase(const QString &backupPath, const std::function<bool(int, int)> &progress)
+{
+    if (!isConnected() || backupPath.isEmpty()) {
+        return false;
+    }
+
+    // 确保备份目录存在
+    QFileInfo fileInfo(backupPath);
+    QDir dir = fileInfo.absoluteDir();
+    if (!dir.exists()) {
+        if (!dir.mkpath(dir.absolutePath())) {
+            qCritical() << "Failed to create backup directory:" << dir.absolutePath();
+            return false;
+        }
+    }
+
+    // 通过在线备份接口分步复制，连接保持可用且结果是一致的快照
+    if (m_sqlcipher->backupTo(backupPath, BACKUP_PAGES_PER_STEP, progress)) {
+        qInfo() << "Database backed up to:" << backupPath;
+        return true;
+    } else {
+        qCritical() << "Failed to backup database to:" << backupPath << m_sqlcipher->lastError();
+        return false;
+    }
+}
+
+/**
+ * @brief 在备份仓库中创建数据库的增量快照
+ * @param repositoryPath 备份仓库目录
+ * @return 快照是否创建成功
+ */
+bool DatabaseManager::createBackupSnapshot(const QString &repositoryPath)
 {
-    if (!isConnected() || backupPath.isEmpty()) {
+    if (!isConnected() || repositoryPath.isEmpty()) {
         return false;
     }
 
-    // 确保备份目录存在
-    QFileInfo fileInfo(backupPath);
-    QDir dir = fileInfo.absoluteDir();
-    if (!dir.exists()) {
-        if (!dir.mkpath(dir.absolutePath())) {
-            qCritical() << "Failed to create backup directory:" << dir.absolutePath();
-            return false;
+    // 先得到一份一致的副本，分块和写入仓库都在副本上进行，不持有任何锁
+    const QString copyPath = m_databasePath + QStringLiteral(".snapshot-copy");
+    QFile::remove(copyPath);
+
+    // WAL完全合并回主文件（或不是WAL模式）时，主文件本身就是一致的：写操作都在
+    // 本线程中串行执行，复制期间不会改变。直接复制字节保留未改动页面原有的密文，
+    // 仓库只需保存变化的块。合并不完整（如其他连接仍持有旧快照）时改用在线备份
+    // 接口复制，得到的副本同样一致，但所有页面都会重新加密
+    bool copied = false;
+    SQLCipherStatement checkpoint = m_sqlcipher->prepare("PRAGMA wal_checkpoint(TRUNCATE)");
+    if (checkpoint.next()) {
+        const bool complete = checkpoint.columnInt64(0) == 0
+                              && checkpoint.columnInt64(1) == checkpoint.columnInt64(2);
+        checkpoint.reset();
+        copied = complete && QFile::copy(m_databasePath, copyPath);
+        if (!complete) {
+            qInfo() << "WAL checkpoint incomplete, copying database through the backup API";
         }
     }
+    checkpoint = SQLCipherStatement();
+    if (!copied && !m_sqlcipher->backupTo(copyPath, BACKUP_PAGES_PER_STEP)) {
+        qCritical() << "Failed to copy database for snapshot:" << m_sqlcipher->lastError();
+        QFile::remove(copyPath);
+        return false;
+    }
 
-    // 复制数据库文件
-    if (QFile::copy(m_databasePath, backupPath)) {
-        qInfo() << "Database backed up to:" << backupPath;
-        return true;
-    } else {
-        qCritical() << "Failed to backup database to:" << backupPath;
+    BackupRepository repository(repositoryPath);
+    const QString manifestPath = repository.createSnapshot(copyPath);
+    QFile::remove(copyPath);
+
+    if (manifestPath.isEmpty()) {
+        qCritical() << "Failed to create backup snapshot:" << repository.errorString();
         return false;
     }
+    return true;
 }
 
 /**
@@ -380,40 +1204,58 @@ bool DatabaseManager::restoreDatabase(const QString &backupPath)
         return false;
     }
 
-    // 关闭当前数据库连接
-    closeDatabase();
+    // 增量备份仓库中的快照先拼接成完整的数据库文件
+    if (BackupRepository::isSnapshotManifest(backupPath)) {
+        const QString snapshotFile = m_databasePath + ".snapshot";
+        BackupRepository repository(BackupRepository::repositoryForManifest(backupPath));
+        if (!repository.restoreSnapshot(backupPath, snapshotFile)) {
+            qCritical() << "Failed to assemble backup snapshot:" << repository.errorString();
+            return false;
+        }
+        const bool restored = restoreDatabase(snapshotFile);
+        QFile::remove(snapshotFile);
+        return restored;
+    }
 
-    // 备份当前数据库文件
-    QString currentBackup = m_databasePath + ".backup";
-    QFile::copy(m_databasePath, currentBackup);
+    // 关闭当前数据库连接，连接未释放时不能替换文件
+    if (!closeDatabase()) {
+        qCritical() << "Cannot restore database: the current connection did not close cleanly";
+        return false;
+    }
 
-    // 删除当前数据库文件
-    QFile::remove(m_databasePath);
+    // 标记键名取自规范路径，要在移走文件之前计算
+    const QString rawKeyKey = rawKeySettingsKey(m_databasePath);
 
-    // 复制备份文件到数据库位置
-    if (QFile::copy(backupPath, m_databasePath)) {
-        // 重新初始化数据库
-        if (initialize(m_databasePath)) {
-            QFile::remove(currentBackup); // 删除临时备份
-            qInfo() << "Database restored from:" << backupPath;
-            return true;
-        } else {
-            // 恢复失败，还原原数据库
-            QFile::remove(m_databasePath);
-            QFile::copy(currentBackup, m_databasePath);
-            QFile::remove(currentBackup);
-            initialize(m_databasePath);
-            qCritical() << "Failed to restore database, reverted to original";
-            return false;
-        }
-    } else {
-        // 复制失败，还原原数据库
-        QFile::copy(currentBackup, m_databasePath);
-        QFile::remove(currentBackup);
-        initialize(m_databasePath);
-        qCritical() << "Failed to copy backup file, reverted to original";
+    // 当前数据库文件连同WAL附属文件一起移到一旁，旧的-wal不能留给恢复后的文件
+    const QString currentBackup = m_databasePath + ".backup";
+    removeDatabaseFiles(currentBackup);
+    if (!moveDatabaseFiles(m_databasePath, currentBackup)) {
+        moveDatabaseFiles(currentBackup, m_databasePath);
+        qCritical() << "Failed to move current database aside, restore aborted";
         return false;
     }
+
+    // 备份可能早于原始密钥迁移，清除标记，下次解锁时重新判断
+    QSettings settings;
+    const QVariant rawKeyFlag = settings.value(rawKeyKey);
+    settings.remove(rawKeyKey);
+
+    // 复制备份文件到数据库位置并重新初始化
+    if (QFile::copy(backupPath, m_databasePath) && initialize(m_databasePath)) {
+        removeDatabaseFiles(currentBackup); // 删除临时备份
+        qInfo() << "Database restored from:" << backupPath;
+        return true;
+    }
+
+    // 恢复失败，还原原数据库及其附属文件和标记
+    removeDatabaseFiles(m_databasePath);
+    moveDatabaseFiles(currentBackup, m_databasePath);
+    if (rawKeyFlag.isValid()) {
+        settings.setValue(rawKeyKey, rawKeyFlag);
+    }
+    initialize(m_databasePath);
+    qCritical() << "Failed to restore database, reverted to original";
+    return false;
 }
 
 /**
@@ -437,11 +1279,56 @@ bool DatabaseManager::checkIntegrity()
     if (!isConnected()) {
         return false;
     }
-    QList<QVariantMap> result = m_sqlcipher->query("PRAGMA integrity_check");
-    if (!result.isEmpty() && result.first().values().contains("ok")) {
-        return true;
-    }
-    return false;
+    SQLCipherStatement stmt = m_sqlcipher->prepare("PRAGMA integrity_check");
+    return stmt.next() && stmt.columnText(0) == QLatin1String("ok");
+}
+
+/**
+ * @brief 在数据库线程中备份数据库
+ * @param backupPath 备份文件路径
+ * @param progress 进度回调
+ * @return 备份结果的future
+ */
+QFuture<bool> DatabaseManager::backupDatabaseAsync(const QString &backupPath,
+                                                  const std::function<bool(int, int)> &progress)
+{
+    return m_executor->submitLongRunning([this, backupPath, progress]() {
+        return backupDatabase(backupPath, progress);
+    });
+}
+
+/**
+ * @brief 在数据库线程中创建增量快照
+ * @param repositoryPath 备份仓库目录
+ * @return 结果的future
+ */
+QFuture<bool> DatabaseManager::createBackupSnapshotAsync(const QString &repositoryPath)
+{
+    return m_executor->submitLongRunning([this, repositoryPath]() {
+        return createBackupSnapshot(repositoryPath);
+    });
+}
+
+/**
+ * @brief 在数据库线程中压缩数据库
+ * @return 压缩结果的future
+ */
+QFuture<bool> DatabaseManager::compactDatabaseAsync()
+{
+    return m_executor->submitLongRunning([this]() {
+        return compactDatabase();
+    });
+}
+
+/**
+ * @brief 在数据库线程中检查数据库完整性
+ * @return 检查结果的future
+ */
+QFuture<bool> DatabaseManager::checkIntegrityAsync()
+{
+    return m_executor->submitLongRunning([this]() {
+        return checkIntegrity();
+    });
 }
 
 /**
@@ -454,7 +1341,7 @@ bool DatabaseManager::beginTransaction()
         return false;
     }
 
-    return m_database.transaction();
+    return m_sqlcipher->beginTransaction();
 }
 
 /**
@@ -467,7 +1354,7 @@ bool DatabaseManager::commitTransaction()
         return false;
     }
 
-    return m_database.commit();
+    return m_sqlcipher->commitTransaction();
 }
 
 /**
@@ -480,7 +1367,7 @@ bool DatabaseManager::rollbackTransaction()
         return false;
     }
 
-    return m_database.rollback();
+    return m_sqlcipher->rollbackTransaction();
 }
 
 // 私有方法实现
@@ -492,22 +1379,7 @@ bool DatabaseManager::rollbackTransaction()
 bool DatabaseManager::createTables()
 {
     // 创建密码表
-    QString createPasswordsTable = R"(
-        CREATE TABLE IF NOT EXISTS passwords (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            title TEXT NOT NULL,
-            username TEXT,
-            password TEXT NOT NULL,
-            website TEXT,
-            notes TEXT,
-            category TEXT,
-            created_at DATETIME NOT NULL,
-            updated_at DATETIME NOT NULL,
-            is_favorite BOOLEAN DEFAULT 0
-        )
-    )";
-
-    if (!m_sqlcipher->execute(createPasswordsTable)) {
+    if (!m_sqlcipher->execute(PASSWORDS_TABLE.arg("passwords"))) {
         qCritical() << "Failed to create passwords table:" << m_sqlcipher->lastError();
         return false;
     }
@@ -552,8 +1424,12 @@ bool DatabaseManager::upgradeDatabase()
     int currentVersion = getDatabaseVersion();
     
     if (currentVersion == -1) {
-        // 新数据库，设置当前版本
-        return setDatabaseVersion(DATABASE_VERSION);
+        if (!tableExists("passwords")) {
+            // 新数据库，设置当前版本
+            return setDatabaseVersion(DATABASE_VERSION);
+        }
+        // 有密码表但没有版本记录，是最早的版本1格式
+        currentVersion = 1;
     }
     
     if (currentVersion == DATABASE_VERSION) {
@@ -566,12 +1442,191 @@ bool DatabaseManager::upgradeDatabase()
         return true; // 向下兼容
     }
     
-    // 这里可以添加数据库升级逻辑
-    // 目前只有版本1，所以暂时不需要升级逻辑
+    if (currentVersion < 2 && !migrateToVersion2()) {
+        qCritical() << "Failed to upgrade database to version 2:" << m_sqlcipher->lastError();
+        return false;
+    }
+
+    if (currentVersion < 3 && !migrateToVersion3()) {
+        qCritical() << "Failed to upgrade database to version 3:" << m_sqlcipher->lastError();
+        return false;
+    }
     
     return setDatabaseVersion(DATABASE_VERSION);
 }
 
+/**
+ * @brief 读取版本1中以Base64文本保存的密文
+ * @param rows 使用PASSWORD_SELECT列顺序的结果集
+ * @param row 行索引
+ * @param column 列索引
+ * @return 二进制密文
+ */
+static QByteArray legacyCiphertext(const SQLCipherResultSet &rows, int row, int column)
+{
+    return QByteArray::fromBase64(rows.bytes(row, column).toByteArray());
+}
+
+/**
+ * @brief 读取版本1中以ISO 8601文本保存的时间
+ * @param rows 使用PASSWORD_SELECT列顺序的结果集
+ * @param row 行索引
+ * @param column 列索引
+ * @return 毫秒时间戳，无法解析时为0
+ */
+static qint64 legacyTimestamp(const SQLCipherResultSet &rows, int row, int column)
+{
+    const QDateTime time = QDateTime::fromString(rows.string(row, column), Qt::ISODate);
+    return time.isValid() ? time.toMSecsSinceEpoch() : 0;
+}
+
+/**
+ * @brief 把密码表从版本1转换为版本2
+ * @return 转换是否成功
+ */
+bool DatabaseManager::migrateToVersion2()
+{
+    // 旧的XOR格式只在这里解密，升级后的读取只接受当前格式
+    CryptoManager *crypto = CryptoManager::instance();
+    if (!crypto->isInitialized()) {
+        qCritical() << "CryptoManager not initialized";
+        return false;
+    }
+
+    if (!m_sqlcipher->execute(PASSWORDS_TABLE.arg("passwords_v2"))) {
+        return false;
+    }
+
+    // 上次中断时已复制的行保留在passwords_v2中，从其中最大的id之后继续
+    qint64 lastId = 0;
+    {
+        SQLCipherStatement stmt = m_sqlcipher->prepare("SELECT IFNULL(MAX(id), 0) FROM passwords_v2");
+        if (!stmt.next()) {
+            return false;
+        }
+        lastId = stmt.columnInt64(0);
+    }
+    qInfo() << "Migrating passwords table to schema version 2, resuming after id" << lastId;
+
+    // 版本1的表没有secrets列，只读取PasswordColumn中其余各列
+    SQLCipherStatement selectStmt = m_sqlcipher->prepare(
+        "SELECT id, title, username, password, website, notes, category, "
+        "created_at, updated_at, is_favorite FROM passwords WHERE id > ? ORDER BY id LIMIT ?");
+    SQLCipherStatement insertStmt = m_sqlcipher->prepare(R"(
+        INSERT INTO passwords_v2 (id, title, username, password, website, notes, category, created_at, updated_at, is_favorite)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    )");
+    if (!selectStmt.isValid() || !insertStmt.isValid()) {
+        return false;
+    }
+
+    qint64 migrated = 0;
+    for (;;) {
+        if (!beginTransaction()) {
+            return false;
+        }
+
+        selectStmt.bindInt64(1, lastId);
+        selectStmt.bindInt64(2, MIGRATION_BATCH_SIZE);
+        const SQLCipherResultSet rows = selectStmt.fetch();
+        selectStmt.reset();
+
+        // 整批一起改写为当前格式，数量多时并行解密和加密
+        QList<QByteArray> ciphertexts;
+        ciphertexts.reserve(rows.rowCount() * 3);
+        for (int row = 0; row < rows.rowCount(); ++row) {
+            ciphertexts.append(legacyCiphertext(rows, row, ColumnUsername));
+            ciphertexts.append(legacyCiphertext(rows, row, ColumnPassword));
+            ciphertexts.append(legacyCiphertext(rows, row, ColumnNotes));
+        }
+        const QList<QByteArray> sealed = crypto->resealLegacyFields(ciphertexts);
+
+        bool ok = sealed.size() == ciphertexts.size();
+        for (int row = 0; ok && row < rows.rowCount(); ++row) {
+            insertStmt.bindInt64(1, rows.int64(row, ColumnId));
+            insertStmt.bindText(2, rows.string(row, ColumnTitle));
+            insertStmt.bindBlob(3, sealed.at(row * 3));
+            insertStmt.bindBlob(4, sealed.at(row * 3 + 1));
+            insertStmt.bindText(5, rows.string(row, ColumnWebsite));
+            insertStmt.bindBlob(6, sealed.at(row * 3 + 2));
+            insertStmt.bindText(7, rows.string(row, ColumnCategory));
+            insertStmt.bindInt64(8, legacyTimestamp(rows, row, ColumnCreatedAt));
+            insertStmt.bindInt64(9, legacyTimestamp(rows, row, ColumnUpdatedAt));
+            insertStmt.bindInt64(10, rows.int64(row, ColumnIsFavorite) != 0 ? 1 : 0);
+            ok = insertStmt.exec();
+        }
+        if (!ok || !commitTransaction()) {
+            rollbackTransaction();
+            return false;
+        }
+
+        // 每批单独提交，中断后已提交的批次不需要重做
+        migrated += rows.rowCount();
+        if (rows.rowCount() < MIGRATION_BATCH_SIZE) {
+            break;
+        }
+        lastId = rows.int64(rows.rowCount() - 1, ColumnId);
+    }
+
+    // 在一个事务中替换旧表，同时保留自增序列，已删除条目的id不会被重用
+    if (!beginTransaction()) {
+        return false;
+    }
+    const bool swapped =
+        m_sqlcipher->execute(R"(
+            INSERT INTO sqlite_sequence (name, seq)
+            SELECT 'passwords_v2', 0
+            WHERE NOT EXISTS (SELECT 1 FROM sqlite_sequence WHERE name = 'passwords_v2')
+        )")
+        && m_sqlcipher->execute(R"(
+            UPDATE sqlite_sequence
+            SET seq = MAX(seq, IFNULL((SELECT seq FROM sqlite_sequence WHERE name = 'passwords'), 0))
+            WHERE name = 'passwords_v2'
+        )")
+        && m_sqlcipher->execute("DROP TABLE passwords")
+        && m_sqlcipher->execute("ALTER TABLE passwords_v2 RENAME TO passwords")
+        && createTables()
+        && setDatabaseVersion(2);
+    if (!swapped || !commitTransaction()) {
+        rollbackTransaction();
+        return false;
+    }
+
+    // 旧表释放的页面留在空闲列表中，整理一次使文件变小
+    if (!m_sqlcipher->execute("VACUUM")) {
+        qWarning() << "Failed to vacuum after migration:" << m_sqlcipher->lastError();
+    }
+
+    qInfo() << "Migrated" << migrated << "passwords to schema version 2";
+    return true;
+}
+
+/**
+ * @brief 为密码表增加版本3的secrets列
+ * @return 升级是否成功
+ */
+bool DatabaseManager::migrateToVersion3()
+{
+    // 从版本1升级时新表已按当前定义创建，secrets列已经存在
+    {
+        SQLCipherStatement stmt = m_sqlcipher->prepare(
+            "SELECT 1 FROM pragma_table_info('passwords') WHERE name = 'secrets'");
+        if (!stmt.isValid()) {
+            return false;
+        }
+        if (stmt.next()) {
+            return true;
+        }
+    }
+
+    // 只修改表定义，不改写已有的行
+    if (!m_sqlcipher->execute("ALTER TABLE passwords ADD COLUMN secrets BLOB")) {
+        return false;
+    }
+    qInfo() << "Added secrets column for record envelopes";
+    return true;
+}
+
 /**
  * @brief 检查表是否存在
  * @param tableName 表名
@@ -579,9 +1634,9 @@ bool DatabaseManager::upgradeDatabase()
  */
 bool DatabaseManager::tableExists(const QString &tableName)
 {
-    QString sql = QString("SELECT name FROM sqlite_master WHERE type='table' AND name='%1'").arg(tableName);
-    QList<QVariantMap> result = m_sqlcipher->query(sql);
-    return !result.isEmpty();
+    SQLCipherStatement stmt = m_sqlcipher->prepare("SELECT name FROM sqlite_master WHERE type='table' AND name=?");
+    stmt.bindText(1, tableName);
+    return stmt.next();
 }
 
 /**
@@ -594,9 +1649,9 @@ int DatabaseManager::getDatabaseVersion()
         return -1;
     }
     
-    QList<QVariantMap> result = m_sqlcipher->query("SELECT version FROM database_version LIMIT 1");
-    if (!result.isEmpty()) {
-        return result.first().value("version").toInt();
+    SQLCipherStatement stmt = m_sqlcipher->prepare("SELECT version FROM database_version LIMIT 1");
+    if (stmt.next()) {
+        return static_cast<int>(stmt.columnInt64(0));
     }
     
     return -1;
@@ -616,8 +1671,9 @@ bool DatabaseManager::setDatabaseVersion(int version)
     }
     
     // 插入新版本
-    QString insertSql = QString("INSERT INTO database_version (version) VALUES (%1)").arg(version);
-    if (!m_sqlcipher->execute(insertSql)) {
+    SQLCipherStatement stmt = m_sqlcipher->prepare("INSERT INTO database_version (version) VALUES (?)");
+    stmt.bindInt64(1, version);
+    if (!stmt.exec()) {
         qCritical() << "Failed to set database version:" << m_sqlcipher->lastError();
         return false;
     }
@@ -626,34 +1682,92 @@ bool DatabaseManager::setDatabaseVersion(int version)
 }
 
 /**
- * @brief 从QVariantMap组装PasswordItem
- * @param row 包含数据的QVariantMap
+ * @brief 从按列存储的结果集中组装PasswordItem
+ * @param rows 使用PASSWORD_SELECT列顺序的结果集
+ * @param row 行索引
  * @return 密码项目指针
  */
-PasswordItem* DatabaseManager::createPasswordItemFromMap(const QVariantMap &row)
+PasswordItem* DatabaseManager::createPasswordItemFromRow(const SQLCipherResultSet &rows, int row)
 {
-    CryptoManager *crypto = CryptoManager::instance();
-    if (!crypto->isInitialized()) {
-        qCritical() << "CryptoManager not initialized";
+    PasswordRecord record;
+    if (!createPasswordRecordFromRow(rows, row, record)) {
         return nullptr;
     }
     PasswordItem *item = new PasswordItem();
-    item->setId(row.value("id").toInt());
-    item->setTitle(row.value("title").toString());
-    QString decryptedUsername = crypto->decryptString(row.value("username").toString());
-    QString decryptedPassword = crypto->decryptString(row.value("password").toString());
-    QString decryptedNotes = crypto->decryptString(row.value("notes").toString());
-    item->setUsername(decryptedUsername);
-    item->setPassword(decryptedPassword);
-    item->setWebsite(row.value("website").toString());
-    item->setNotes(decryptedNotes);
-    item->setCategory(row.value("category").toString());
-    item->setCreatedAt(row.value("created_at").toDateTime());
-    item->setUpdatedAt(row.value("updated_at").toDateTime());
-    item->setIsFavorite(row.value("is_favorite").toBool());
+    item->setRecord(record);
     return item;
 }
 
+/**
+ * @brief 从按列存储的结果集中组装密码记录
+ * @param rows 使用PASSWORD_SELECT列顺序的结果集
+ * @param row 行索引
+ * @param record 输出的密码记录
+ * @return 加密管理器未初始化时返回false
+ */
+bool DatabaseManager::createPasswordRecordFromRow(const SQLCipherResultSet &rows, int row, PasswordRecord &record)
+{
+    CryptoManager *crypto = CryptoManager::instance();
+    if (!crypto->isInitialized()) {
+        qCritical() << "CryptoManager not initialized";
+        return false;
+    }
+    record.id = static_cast<int>(rows.int64(row, ColumnId));
+    record.title = rows.string(row, ColumnTitle);
+    // 敏感字段只保存密文（直接复制BLOB内容），首次读取时才解密；
+    // 记录信封只复制一次，三个字段共享
+    const QByteArrayView envelope = rows.bytes(row, ColumnSecrets);
+    if (!envelope.isEmpty()) {
+        record.setSecretEnvelope(envelope.toByteArray());
+    } else {
+        record.username.setCiphertext(rows.bytes(row, ColumnUsername).toByteArray());
+        record.password.setCiphertext(rows.bytes(row, ColumnPassword).toByteArray());
+        record.notes.setCiphertext(rows.bytes(row, ColumnNotes).toByteArray());
+    }
+    record.website = rows.string(row, ColumnWebsite);
+    record.category = rows.string(row, ColumnCategory);
+    record.createdAt = rows.int64(row, ColumnCreatedAt);
+    record.updatedAt = rows.int64(row, ColumnUpdatedAt);
+    record.isFavorite = rows.int64(row, ColumnIsFavorite) != 0;
+    return true;
+}
+
+/**
+ * @brief 逐行读取已绑定参数的查询语句并组装密码项目
+ * @param stmt 查询语句
+ * @return 密码项目列表
+ */
+QList<PasswordItem*> DatabaseManager::fetchPasswordItems(SQLCipherStatement &stmt)
+{
+    QList<PasswordItem*> items;
+    SQLCipherResultSet rows = stmt.fetch();
+    items.reserve(rows.rowCount());
+    for (int row = 0; row < rows.rowCount(); ++row) {
+        PasswordItem *item = createPasswordItemFromRow(rows, row);
+        if (item) items.append(item);
+    }
+    return items;
+}
+
+/**
+ * @brief 逐行读取已绑定参数的查询语句并组装密码记录
+ * @param stmt 查询语句
+ * @return 密码记录列表
+ */
+QList<PasswordRecord> DatabaseManager::fetchPasswordRecords(SQLCipherStatement &stmt)
+{
+    QList<PasswordRecord> records;
+    SQLCipherResultSet rows = stmt.fetch();
+    records.reserve(rows.rowCount());
+    for (int row = 0; row < rows.rowCount(); ++row) {
+        PasswordRecord record;
+        if (createPasswordRecordFromRow(rows, row, record)) {
+            records.append(std::move(record));
+        }
+    }
+    return records;
+}
+
 /**
  * @brief 记录数据库错误并发出信号
  * @param operation 操作名称
@@ -681,13 +1795,14 @@ QString DatabaseManager::getDefaultDatabasePath() const
 }
 
 /**
- * @brief 设置数据库密码（SQLCipher）
- * @param password 主密码
+ * @brief 使用原始密钥加密新数据库或打开已有数据库（SQLCipher）
+ * @param key 原始数据库密钥
+ * @param legacyPassword 主密码，仅用于迁移旧数据库
  * @return 设置是否成功
  */
-bool DatabaseManager::setDatabasePassword(const QString &password)
+bool DatabaseManager::setDatabaseKey(const QByteArray &key, const QString &legacyPassword)
 {
-    if (password.isEmpty()) {
+    if (key.isEmpty()) {
         return false;
     }
 
@@ -699,6 +1814,8 @@ bool DatabaseManager::setDatabasePassword(const QString &password)
         }
     }
 
+    preparePerformanceProfile();
+
     // 检查数据库是否为空（新数据库）
     // 对于新数据库，sqlite_master查询可能会失败，所以我们先尝试设置密码
     bool isEmpty = false;
@@ -711,11 +1828,12 @@ bool DatabaseManager::setDatabasePassword(const QString &password)
     }
     
     if (isEmpty) {
-        // 新数据库：设置密码并创建表
-        if (!m_sqlcipher->setPassword(password)) {
-            qCritical() << "Failed to set database password for new database:" << m_sqlcipher->lastError();
+        // 新数据库：设置密钥并创建表
+        if (!m_sqlcipher->setKey(key)) {
+            qCritical() << "Failed to set database key for new database:" << m_sqlcipher->lastError();
             return false;
         }
+        QSettings().setValue(rawKeySettingsKey(m_databasePath), true);
         
         // 创建表结构
         if (!createTables()) {
@@ -728,64 +1846,235 @@ bool DatabaseManager::setDatabasePassword(const QString &password)
             qCritical() << "Failed to set database version";
             return false;
         }
-    } else {
-        // 现有数据库：验证密码
-        if (!m_sqlcipher->verifyPassword(password)) {
-            qCritical() << "Failed to verify database password:" << m_sqlcipher->lastError();
-            return false;
-        }
+    } else if (!keyExistingDatabase(key, legacyPassword) || !upgradeDatabase()) {
+        // 现有数据库：验证密钥并升级到当前版本
+        return false;
     }
 
-    m_currentPassword = password;
     m_isEncrypted = true;
     
-    qInfo() << "Database password set successfully";
+    qInfo() << "Database key set successfully";
     return true;
 }
 
 /**
- * @brief 验证数据库密码（SQLCipher）
- * @param password 主密码
+ * @brief 设置密钥前准备页大小和性能配置
+ */
+void DatabaseManager::preparePerformanceProfile()
+{
+    const PerformanceProfile profile = PerformanceProfile::load();
+
+    // 页大小决定文件格式，不随性能配置变化。旧版本可能以其他页大小创建过数据库，
+    // 并把它记录在设置中，只有这种已有数据库沿用记录的值
+    const bool newDatabase = QFileInfo(m_databasePath).size() == 0;
+    if (newDatabase) {
+        PerformanceProfile::clearStoredCipherPageSize();
+    }
+    m_sqlcipher->setCipherPageSize(PerformanceProfile::storedCipherPageSize(CIPHER_PAGE_SIZE));
+    m_sqlcipher->applyPerformanceProfile(profile);
+}
+
+/**
+ * @brief 选择性能配置并保存，立即应用到当前连接
+ * @param name 配置名
+ * @return 应用是否成功
+ */
+bool DatabaseManager::setPerformanceProfile(const QString &name)
+{
+    const PerformanceProfile profile = PerformanceProfile::byName(name);
+    PerformanceProfile::save(profile.name);
+
+    // 切换日志模式不能在事务中进行，先等数据库线程中的任务结束；
+    // 有耗时任务时不等待，配置已保存，下次打开数据库时生效
+    if (rejectWhileBusy()) {
+        return false;
+    }
+    m_executor->waitForIdle();
+    return m_sqlcipher->applyPerformanceProfile(profile);
+}
+
+/**
+ * @brief 选择新写入条目的敏感字段格式并保存到设置中
+ * @param enabled 是否启用记录信封
+ */
+void DatabaseManager::setRecordEnvelopeEnabled(bool enabled)
+{
+    QSettings settings;
+    settings.setValue(RECORD_ENVELOPE_SETTINGS_KEY, enabled);
+    m_recordEnvelope = enabled;
+}
+
+/**
+ * @brief 使用原始密钥打开已有数据库（SQLCipher）
+ * @param key 原始数据库密钥
+ * @param legacyPassword 主密码，仅用于迁移旧数据库
  * @return 验证是否成功
  */
-bool DatabaseManager::verifyDatabasePassword(const QString &password)
+bool DatabaseManager::verifyDatabaseKey(const QByteArray &key, const QString &legacyPassword)
 {
-    if (!isConnected() || password.isEmpty()) {
+    if (!isConnected() || key.isEmpty()) {
         return false;
     }
 
-    if (!m_sqlcipher->verifyPassword(password)) {
-        qCritical() << "Failed to verify database password:" << m_sqlcipher->lastError();
+    preparePerformanceProfile();
+    if (!keyExistingDatabase(key, legacyPassword)) {
+        return false;
+    }
+
+    // 旧版本的数据库在解锁后立即升级，之后的读写都使用新格式
+    if (!upgradeDatabase()) {
         return false;
     }
 
-    m_currentPassword = password;
     m_isEncrypted = true;
     
-    qInfo() << "Database password verified successfully";
+    qInfo() << "Database key verified successfully";
+    return true;
+}
+
+/**
+ * @brief 用原始密钥打开已有数据库，必要时从口令密钥迁移
+ * @param key 原始数据库密钥
+ * @param legacyPassword 主密码
+ * @return 是否成功
+ */
+bool DatabaseManager::keyExistingDatabase(const QByteArray &key, const QString &legacyPassword)
+{
+    QSettings settings;
+    const QString rawKeyKey = rawKeySettingsKey(m_databasePath);
+    const bool rawKeyInUse = settings.value(rawKeyKey, false).toBool();
+
+    // 原始密钥不经过PBKDF2，密钥不对时很快就能失败
+    if (m_sqlcipher->verifyKey(key)) {
+        // 没有标记但原始密钥有效：之前的版本已完成迁移，补上标记
+        if (!rawKeyInUse) {
+            settings.setValue(rawKeyKey, true);
+        }
+        return true;
+    }
+
+    // 已标记为原始密钥的数据库验证失败就是主密码错误，不再按口令方式重试，
+    // 否则每次输错都要多做一次PBKDF2
+    if (rawKeyInUse || legacyPassword.isEmpty()) {
+        qCritical() << "Failed to verify database key:" << m_sqlcipher->lastError();
+        return false;
+    }
+
+    // 设置过错误密钥的连接不能再换密钥重试，重新打开后按旧的口令方式验证
+    if (!m_sqlcipher->openDatabase(m_databasePath) || !m_sqlcipher->verifyPassword(legacyPassword)) {
+        qCritical() << "Failed to verify database key:" << m_sqlcipher->lastError();
+        return false;
+    }
+
+    if (!m_sqlcipher->rekey(key)) {
+        qCritical() << "Failed to migrate database to raw key:" << m_sqlcipher->lastError();
+        return false;
+    }
+    settings.setValue(rawKeyKey, true);
+
+    qInfo() << "Database migrated from passphrase key to raw key";
     return true;
 }
 
 /**
- * @brief 更改数据库密码（SQLCipher）
- * @param oldPassword 旧密码
- * @param newPassword 新密码
+ * @brief 把数据库重新加密为新的原始密钥，并把已保存的密文改写为新的子密钥
+ * @param rekeyer 新旧密钥
  * @return 更改是否成功
  */
-bool DatabaseManager::changeDatabasePassword(const QString &oldPassword, const QString &newPassword)
+bool DatabaseManager::changeDatabaseKey(const CiphertextRekeyer &rekeyer)
 {
-    if (!isConnected() || oldPassword.isEmpty() || newPassword.isEmpty()) {
+    if (!isConnected() || rekeyer.databaseKey().isEmpty() || rejectWhileBusy()) {
         return false;
     }
 
-    if (!m_sqlcipher->changePassword(oldPassword, newPassword)) {
-        qCritical() << "Failed to change database password:" << m_sqlcipher->lastError();
+    // 与导入等写任务串行，改写期间不会有其他写入混进来
+    const bool changed = m_executor->run([this, &rekeyer]() {
+        // PRAGMA rekey自己提交，不能放进下面的事务，先执行，失败时再改回原密钥
+        if (!m_sqlcipher->rekey(rekeyer.databaseKey())) {
+            qCritical() << "Failed to change database key:" << m_sqlcipher->lastError();
+            return false;
+        }
+        if (resealPasswordRecords(rekeyer)) {
+            return true;
+        }
+        if (!m_sqlcipher->rekey(rekeyer.previousDatabaseKey())) {
+            qCritical() << "Failed to restore database key:" << m_sqlcipher->lastError();
+        }
+        return false;
+    });
+    if (!changed) {
+        emit databaseError("Failed to change database key");
         return false;
     }
 
-    m_currentPassword = newPassword;
-    
-    qInfo() << "Database password changed successfully";
+    qInfo() << "Database key changed successfully";
+    return true;
+}
+
+/**
+ * @brief 在一个事务中把所有条目的密文改写为新的子密钥，并重建搜索索引
+ * @param rekeyer 新旧密钥
+ * @return 全部改写成功时返回true，否则回滚
+ */
+bool DatabaseManager::resealPasswordRecords(const CiphertextRekeyer &rekeyer)
+{
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    SQLCipherStatement selectStmt = m_sqlcipher->prepare(
+        "SELECT id, username, password, notes, secrets FROM passwords WHERE id > ? ORDER BY id LIMIT ?");
+    SQLCipherStatement updateStmt = m_sqlcipher->prepare(
+        "UPDATE passwords SET username=?, password=?, notes=?, secrets=? WHERE id=?");
+    bool ok = selectStmt.isValid() && updateStmt.isValid();
+
+    qint64 lastId = 0;
+    qint64 resealed = 0;
+    while (ok) {
+        selectStmt.bindInt64(1, lastId);
+        selectStmt.bindInt64(2, MIGRATION_BATCH_SIZE);
+        const SQLCipherResultSet rows = selectStmt.fetch();
+        selectStmt.reset();
+
+        QList<QByteArray> fields;
+        QList<QByteArray> envelopes;
+        fields.reserve(rows.rowCount() * 3);
+        envelopes.reserve(rows.rowCount());
+        for (int row = 0; row < rows.rowCount(); ++row) {
+            fields.append(rows.bytes(row, 1).toByteArray());
+            fields.append(rows.bytes(row, 2).toByteArray());
+            fields.append(rows.bytes(row, 3).toByteArray());
+            envelopes.append(rows.bytes(row, 4).toByteArray());
+        }
+        ok = rekeyer.resealFields(fields) && rekeyer.resealRecords(envelopes);
+
+        for (int row = 0; ok && row < rows.rowCount(); ++row) {
+            updateStmt.bindBlob(1, fields.at(row * 3));
+            updateStmt.bindBlob(2, fields.at(row * 3 + 1));
+            updateStmt.bindBlob(3, fields.at(row * 3 + 2));
+            bindEnvelope(updateStmt, 4, envelopes.at(row));
+            updateStmt.bindInt64(5, rows.int64(row, 0));
+            ok = updateStmt.exec();
+        }
+
+        resealed += rows.rowCount();
+        if (rows.rowCount() < MIGRATION_BATCH_SIZE) {
+            break;
+        }
+        lastId = rows.int64(rows.rowCount() - 1, 0);
+    }
+
+    // 加密管理器此时已使用新的子密钥，按改写后的密文重建索引
+    if (ok && m_searchIndexReady) {
+        ok = fillSearchIndex();
+    }
+    if (!ok || !commitTransaction()) {
+        qCritical() << "Failed to re-encrypt stored passwords:" << m_sqlcipher->lastError();
+        rollbackTransaction();
+        return false;
+    }
+
+    qInfo() << "Re-encrypted" << resealed << "passwords with the new master key";
     return true;
 }
 
@@ -805,4 +2094,42 @@ bool DatabaseManager::isDatabaseEncrypted() const
 QString DatabaseManager::getDatabasePath() const
 {
     return m_databasePath;
-} 
\ No newline at end of file
+}
+
+// PasswordRecordCursor实现
+
+PasswordRecordCursor::PasswordRecordCursor(DatabaseManager *manager, SQLCipherStatement statement)
+    : m_manager(manager)
+    , m_statement(std::move(statement))
+    , m_atEnd(!m_statement.isValid())
+{
+}
+
+/**
+ * @brief 读取下一批密码记录
+ * @param batchSize 本批最多读取的行数
+ * @return 密码记录列表，读取完毕后返回空列表
+ */
+QList<PasswordRecord> PasswordRecordCursor::fetchBatch(int batchSize)
+{
+    QList<PasswordRecord> records;
+    if (m_atEnd || batchSize <= 0) {
+        return records;
+    }
+
+    SQLCipherResultSet rows = m_statement.fetch(batchSize);
+    records.reserve(rows.rowCount());
+    for (int row = 0; row < rows.rowCount(); ++row) {
+        PasswordRecord record;
+        if (m_manager->createPasswordRecordFromRow(rows, row, record)) {
+            records.append(std::move(record));
+        }
+    }
+
+    // 不足一批说明查询已结束，立即释放语句以结束读事务
+    if (rows.rowCount() < batchSize) {
+        m_atEnd = true;
+        m_statement = SQLCipherStatement();
+    }
+    return records;
+}
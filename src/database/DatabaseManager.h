@@ -7,10 +7,74 @@
 #include <QSqlError>
 #include <QString>
 #include <QList>
+#include <atomic>
+#include <functional>
 #include <QVariantMap>
 #include "models/PasswordItem.h"
 #include "crypto/CryptoManager.h"
 #include "SQLCipherWrapper.h"
+#include "DatabaseExecutor.h"
+#include "io/PasswordRecordReader.h"
+
+class DatabaseManager;
+
+/**
+ * @brief 批量导入的结果
+ */
+struct PasswordImportResult
+{
+    int imported = 0;                 // 新增的条目数
+    int updated = 0;                  // 覆盖的已有条目数
+    int skipped = 0;                  // 因已存在而跳过的条目数
+    int failed = 0;                   // 写入失败的条目数
+    bool cancelled = false;           // 是否被取消（已提交的批次保留）
+    bool reloadRequired = false;      // 写入条目过多，records未完整收集，调用方应重新加载列表
+    QString error;                    // 数据源的读取错误（已提交的批次保留）
+    QList<PasswordRecord> records;    // 已写入的记录，敏感字段只保存密文
+};
+
+/**
+ * @brief 密码记录游标
+ *
+ * 由DatabaseManager::openPasswordCursor()返回，持有一条进行中的查询，
+ * 每次fetchBatch()只读取并解密指定数量的行，调用方可以在两批之间
+ * 返回事件循环，从而逐步填充界面而不是一次性加载整个密码库。
+ * 游标只能移动不能复制，销毁时自动结束查询。
+ */
+class PasswordRecordCursor
+{
+public:
+    PasswordRecordCursor() = default;
+    PasswordRecordCursor(PasswordRecordCursor &&other) noexcept = default;
+    PasswordRecordCursor &operator=(PasswordRecordCursor &&other) noexcept = default;
+
+    /**
+     * @brief 检查游标是否有效
+     * @return 查询已成功开始则返回true
+     */
+    bool isValid() const { return m_statement.isValid(); }
+
+    /**
+     * @brief 检查是否已读取完所有行
+     * @return 没有更多行时返回true
+     */
+    bool atEnd() const { return m_atEnd; }
+
+    /**
+     * @brief 读取下一批密码记录
+     * @param batchSize 本批最多读取的行数
+     * @return 密码记录列表，敏感字段尚未解密，读取完毕后返回空列表
+     */
+    QList<PasswordRecord> fetchBatch(int batchSize);
+
+private:
+    friend class DatabaseManager;
+    PasswordRecordCursor(DatabaseManager *manager, SQLCipherStatement statement);
+
+    DatabaseManager *m_manager = nullptr;  ///< 所属的数据库管理器
+    SQLCipherStatement m_statement;        ///< 进行中的查询
+    bool m_atEnd = true;                   ///< 是否已读取完毕
+};
 
 /**
  * @brief 数据库管理类
@@ -37,26 +101,34 @@ public:
     bool initialize(const QString &databasePath = QString());
 
     /**
-     * @brief 设置数据库密码（SQLCipher）
-     * @param password 主密码
+     * @brief 使用原始密钥加密新数据库或打开已有数据库（SQLCipher）
+     * @param key 由主密码派生的原始数据库密钥
+     * @param legacyPassword 主密码，仅用于迁移以口令加密的旧数据库
      * @return 设置是否成功
      */
-    bool setDatabasePassword(const QString &password);
+    bool setDatabaseKey(const QByteArray &key, const QString &legacyPassword);
 
     /**
-     * @brief 验证数据库密码（SQLCipher）
-     * @param password 主密码
+     * @brief 使用原始密钥打开已有数据库（SQLCipher）
+     *
+     * 原始密钥无法打开时，用主密码按旧方式（口令PRAGMA key）再试一次，
+     * 成功后立即重新加密为原始密钥，之后的解锁不再经过SQLCipher的PBKDF2
+     * @param key 由主密码派生的原始数据库密钥
+     * @param legacyPassword 主密码，仅用于迁移以口令加密的旧数据库
      * @return 验证是否成功
      */
-    bool verifyDatabasePassword(const QString &password);
+    bool verifyDatabaseKey(const QByteArray &key, const QString &legacyPassword);
 
     /**
-     * @brief 更改数据库密码（SQLCipher）
-     * @param oldPassword 旧密码
-     * @param newPassword 新密码
+     * @brief 把数据库重新加密为新的原始密钥（SQLCipher），并改写已保存的密文
+     *
+     * 字段和记录信封密钥随主密码一起更换，所有条目的密文在一个事务中用旧密钥解开、
+     * 以新密钥重新加密，随后重建搜索索引。任何一步失败都回滚事务并把数据库改回原密钥。
+     * 应在加密管理器切换到新子密钥之后调用（见CryptoManager::changeMasterPassword）
+     * @param rekeyer 新旧密钥
      * @return 更改是否成功
      */
-    bool changeDatabasePassword(const QString &oldPassword, const QString &newPassword);
+    bool changeDatabaseKey(const CiphertextRekeyer &rekeyer);
 
     /**
      * @brief 检查数据库是否已加密
@@ -72,8 +144,9 @@ public:
 
     /**
      * @brief 关闭数据库连接
+     * @return 连接是否已干净地关闭，未打开时也返回true
      */
-    void closeDatabase();
+    bool closeDatabase();
 
     /**
      * @brief 检查数据库是否已连接
@@ -82,6 +155,8 @@ public:
     bool isConnected() const;
 
     // 密码项目数据库操作
+    // 写操作都在数据库线程中执行并等待完成，与其他数据库任务串行；
+    // 导入、压缩等耗时任务排队或执行时直接失败并发出databaseError，不等待
     /**
      * @brief 保存密码项目到数据库
      * @param item 要保存的密码项目
@@ -116,6 +191,43 @@ public:
      */
     QList<PasswordItem*> getAllPasswordItems();
 
+    /**
+     * @brief 在一个只读事务中按更新时间倒序遍历所有密码记录
+     *
+     * 每次只读取并解密一批记录，回调返回后立即清除明文，内存占用与密码库大小无关。
+     * 遍历使用单独的只读连接，看到的是一致的快照，不占用主连接的锁。
+     * 应在数据库线程中调用
+     * @param visitor 对每条记录调用，返回false时停止遍历
+     * @param decryptSecrets 是否解密敏感字段，不需要时记录中只有密文
+     * @return 遍历完所有记录返回true
+     */
+    bool forEachPasswordRecord(const std::function<bool(const PasswordRecord &)> &visitor,
+                               bool decryptSecrets = true);
+
+    /**
+     * @brief 打开按更新时间倒序遍历所有密码记录的游标
+     * @return 密码记录游标，失败时isValid()为false
+     */
+    PasswordRecordCursor openPasswordCursor();
+
+    /**
+     * @brief 并行解密一组密码项目中尚未解密的敏感字段
+     * @param items 密码项目列表
+     */
+    void decryptPasswordItems(const QList<PasswordItem*> &items);
+
+    /**
+     * @brief 并行解密一组密码记录中尚未解密的敏感字段
+     * @param records 密码记录列表
+     */
+    void decryptPasswordRecords(QList<PasswordRecord> &records);
+
+    /**
+     * @brief 获取所有非空分类
+     * @return 按名称排序的分类列表
+     */
+    QStringList getCategories();
+
     /**
      * @brief 搜索密码项目
      * @param searchTerm 搜索词
@@ -124,17 +236,74 @@ public:
     QList<PasswordItem*> searchPasswordItems(const QString &searchTerm);
 
     /**
-     * @brief 根据分类获取密码项目
+     * @brief 确保全文搜索索引存在且与密码表一致
+     *
+     * 索引保存在加密数据库内的FTS5表中，包含标题、网址、分类以及解密后的
+     * 用户名和备注，需要在加密管理器初始化后调用。索引行数与密码表不一致时
+     * 会重建索引；SQLCipher未编译FTS5时搜索回退为LIKE查询
+     * @return 索引是否可用
+     */
+    bool ensureSearchIndex();
+
+    /**
+     * @brief 全文搜索索引是否可用
+     * @return 可用返回true
+     */
+    bool hasSearchIndex() const { return m_searchIndexReady; }
+
+    /**
+     * @brief 在数据库线程中通过全文搜索索引查找匹配的密码项目ID
+     * @param searchTerm 搜索词
+     * @return 匹配ID列表的future
+     */
+    QFuture<QList<int>> searchPasswordIdsAsync(const QString &searchTerm);
+
+    /**
+     * @brief 通过全文搜索索引查找匹配的密码项目ID
+     *
+     * 只读取索引，不创建PasswordItem也不解密，可以在工作线程中调用
+     * @param searchTerm 搜索词
+     * @return 匹配的ID列表，索引不可用或搜索词过短时为空
+     */
+    QList<int> searchPasswordIds(const QString &searchTerm);
+
+    /**
+     * @brief 检查搜索词能否使用全文搜索索引
+     *
+     * 索引使用trigram分词，少于3个字符的词无法通过索引匹配，
+     * 此时应改用列表模型的内存索引
+     * @param searchTerm 搜索词
+     * @return 每个词都至少有3个字符时返回true
+     */
+    static bool isIndexSearchable(const QString &searchTerm);
+
+    /**
+     * @brief 根据分类获取密码记录
      * @param category 分类名称
-     * @return 指定分类的密码项目列表
+     * @return 指定分类的密码记录列表，敏感字段尚未解密
+     */
+    QList<PasswordRecord> getPasswordRecordsByCategory(const QString &category);
+
+    /**
+     * @brief 获取收藏的密码记录
+     * @return 收藏的密码记录列表，敏感字段尚未解密
      */
-    QList<PasswordItem*> getPasswordItemsByCategory(const QString &category);
+    QList<PasswordRecord> getFavoritePasswordRecords();
 
     /**
-     * @brief 获取收藏的密码项目
-     * @return 收藏的密码项目列表
+     * @brief 批量导入密码记录
+     *
+     * 从数据源每读出IMPORT_CHUNK_SIZE条记录写入一个事务，复用同一条预编译的
+     * 插入和更新语句，每批先并行加密再顺序写入，内存中只保留当前一批。
+     * 标题和网址相同的已有条目视为重复：overwrite为true时覆盖，否则跳过。
+     * 可在数据库线程中调用
+     * @param reader 导入数据源（敏感字段为明文）
+     * @param overwrite 是否覆盖重复的已有条目
+     * @param progress 每批提交后调用，参数为数据源的当前进度和总量，返回false时取消
+     * @return 导入结果
      */
-    QList<PasswordItem*> getFavoritePasswordItems();
+    PasswordImportResult importPasswordRecords(PasswordRecordReader &reader, bool overwrite,
+                                               const std::function<bool(qint64, qint64)> &progress = {});
 
     // 数据库维护操作
     /**
@@ -143,6 +312,30 @@ public:
      */
     bool clearAllPasswords();
 
+    /**
+     * @brief 选择性能配置并保存，立即应用到当前连接
+     *
+     * 页大小只对之后新建的数据库生效
+     * @param name 配置名
+     * @return 应用是否成功
+     */
+    bool setPerformanceProfile(const QString &name);
+
+    /**
+     * @brief 新写入的条目是否使用记录信封格式
+     * @return 启用时返回true
+     */
+    bool recordEnvelopeEnabled() const { return m_recordEnvelope; }
+
+    /**
+     * @brief 选择新写入条目的敏感字段格式并保存到设置中
+     *
+     * 启用时用户名、密码和备注打包为一个记录信封，只加密一次，存入secrets列；
+     * 关闭时三个字段分别加密。两种格式的条目都可以读取，已有条目在下次保存时改写
+     * @param enabled 是否启用记录信封
+     */
+    void setRecordEnvelopeEnabled(bool enabled);
+
     /**
      * @brief 获取数据库统计信息
      * @return 包含统计信息的QVariantMap
@@ -150,14 +343,31 @@ public:
     QVariantMap getDatabaseStats();
 
     /**
-     * @brief 备份数据库到指定路径
+     * @brief 使用在线备份接口把数据库复制到指定路径
+     *
+     * 每步复制BACKUP_PAGES_PER_STEP页，步与步之间其他线程可以继续读写
      * @param backupPath 备份文件路径
+     * @param progress 每步之后调用，参数为已复制页数和总页数，返回false时取消
      * @return 备份是否成功
      */
-    bool backupDatabase(const QString &backupPath);
+    bool backupDatabase(const QString &backupPath, const std::function<bool(int, int)> &progress = {});
+
+    /**
+     * @brief 在去重的增量备份仓库中创建数据库快照
+     *
+     * 只写入与已有快照不同的块，耗时和占用空间取决于改动的多少。
+     * 先在数据库目录中生成一致的临时副本，再对副本分块，分块期间不持有连接锁。
+     * 应在数据库线程中调用
+     * @param repositoryPath 备份仓库目录，不存在时创建
+     * @return 快照是否创建成功
+     */
+    bool createBackupSnapshot(const QString &repositoryPath);
 
     /**
      * @brief 从备份文件恢复数据库
+     *
+     * 也可以传入备份仓库snapshots目录下的快照清单（.manifest文件），
+     * 此时先按清单拼接并校验出完整的数据库文件
      * @param backupPath 备份文件路径
      * @return 恢复是否成功
      */
@@ -165,6 +375,8 @@ public:
 
     /**
      * @brief 压缩数据库（VACUUM操作）
+     *
+     * 连接上还有未读完的语句（如列表加载游标）时VACUUM会失败，调用前需先结束它们
      * @return 压缩是否成功
      */
     bool compactDatabase();
@@ -175,6 +387,40 @@ public:
      */
     bool checkIntegrity();
 
+    /**
+     * @brief 在数据库线程中备份数据库，不阻塞调用线程
+     * @param backupPath 备份文件路径
+     * @param progress 进度回调，在数据库线程中调用，返回false时取消
+     * @return 备份结果的future
+     */
+    QFuture<bool> backupDatabaseAsync(const QString &backupPath,
+                                      const std::function<bool(int, int)> &progress = {});
+
+    /**
+     * @brief 在数据库线程中创建增量快照，不阻塞调用线程
+     * @param repositoryPath 备份仓库目录
+     * @return 结果的future
+     */
+    QFuture<bool> createBackupSnapshotAsync(const QString &repositoryPath);
+
+    /**
+     * @brief 在数据库线程中压缩数据库（VACUUM），不阻塞调用线程
+     * @return 压缩结果的future
+     */
+    QFuture<bool> compactDatabaseAsync();
+
+    /**
+     * @brief 在数据库线程中检查数据库完整性，不阻塞调用线程
+     * @return 检查结果的future
+     */
+    QFuture<bool> checkIntegrityAsync();
+
+    /**
+     * @brief 获取数据库执行线程
+     * @return 数据库执行线程，可用于提交其他耗时的数据库任务
+     */
+    DatabaseExecutor *executor() const { return m_executor; }
+
     // 事务操作
     /**
      * @brief 开始数据库事务
@@ -195,11 +441,21 @@ public:
     bool rollbackTransaction();
 
     /**
-     * @brief 从QVariantMap组装密码项目对象
-     * @param row 包含数据的QVariantMap
+     * @brief 从按列存储的结果集中组装密码项目对象
+     * @param rows 查询结果集
+     * @param row 行索引
      * @return 密码项目指针
      */
-    PasswordItem* createPasswordItemFromMap(const QVariantMap &row);
+    PasswordItem* createPasswordItemFromRow(const SQLCipherResultSet &rows, int row);
+
+    /**
+     * @brief 从按列存储的结果集中组装密码记录
+     * @param rows 查询结果集
+     * @param row 行索引
+     * @param record 输出的密码记录
+     * @return 加密管理器未初始化时返回false
+     */
+    bool createPasswordRecordFromRow(const SQLCipherResultSet &rows, int row, PasswordRecord &record);
 
     /**
      * @brief 打开数据库连接（不做任何SQL操作）
@@ -233,6 +489,14 @@ signals:
      */
     void passwordItemUpdated(PasswordItem *item);
 
+    /**
+     * @brief 密码记录已写入信号（保存或更新之后）
+     *
+     * 记录中的敏感字段只有刚写入的密文，可以直接合并到列表模型中
+     * @param record 写入后的密码记录
+     */
+    void passwordRecordStored(const PasswordRecord &record);
+
     /**
      * @brief 密码项目已删除信号
      * @param id 删除的密码项目ID
@@ -247,9 +511,71 @@ private:
 
     QSqlDatabase m_database;             // 数据库连接（用于兼容性）
     SQLCipherWrapper *m_sqlcipher;       // SQLCipher封装
+    DatabaseExecutor *m_executor;        // 串行执行耗时数据库任务的线程
     QString m_databasePath;              // 数据库文件路径
     bool m_isEncrypted;                  // 数据库是否已加密
-    QString m_currentPassword;           // 当前数据库密码
+    std::atomic<bool> m_searchIndexReady; // 全文搜索索引是否可用（可在工作线程中读取）
+    std::atomic<bool> m_recordEnvelope;  // 新写入的条目是否使用记录信封（可在工作线程中读取）
+
+    /**
+     * @brief 设置密钥前准备页大小和性能配置
+     */
+    void preparePerformanceProfile();
+
+    /**
+     * @brief 有耗时任务在数据库线程中排队或执行时拒绝同步写操作
+     * @return 需要拒绝时返回true，并发出databaseError信号
+     */
+    bool rejectWhileBusy();
+
+    /**
+     * @brief 用原始密钥打开已有数据库，原始密钥无效时尝试从口令密钥迁移
+     *
+     * 设置中记录了该数据库文件已使用原始密钥（新建或迁移成功后写入，按规范路径区分）时不尝试迁移
+     * @param key 原始数据库密钥
+     * @param legacyPassword 主密码，为空时不尝试迁移
+     * @return 是否成功
+     */
+    bool keyExistingDatabase(const QByteArray &key, const QString &legacyPassword);
+
+    /**
+     * @brief 将密码记录写入全文搜索索引（已存在则替换）
+     * @param record 密码记录，用户名和备注使用明文
+     * @return 写入是否成功
+     */
+    bool indexPasswordRecord(const PasswordRecord &record);
+
+    /**
+     * @brief 从全文搜索索引中删除密码项目
+     * @param id 密码项目ID
+     */
+    void removeFromSearchIndex(int id);
+
+    /**
+     * @brief 清空并重建全文搜索索引
+     * @return 重建是否成功
+     */
+    bool rebuildSearchIndex();
+
+    /**
+     * @brief 在当前事务中清空并重新填充全文搜索索引
+     * @return 填充是否成功
+     */
+    bool fillSearchIndex();
+
+    /**
+     * @brief 在一个事务中把所有条目的密文改写为新的子密钥，并重建搜索索引
+     * @param rekeyer 新旧密钥
+     * @return 全部改写成功时返回true，否则回滚
+     */
+    bool resealPasswordRecords(const CiphertextRekeyer &rekeyer);
+
+    /**
+     * @brief 将用户输入转换为FTS5子串查询表达式
+     * @param searchTerm 搜索词，多个词之间以空白分隔，需全部匹配
+     * @return FTS5 MATCH表达式
+     */
+    static QString buildFtsQuery(const QString &searchTerm);
 
     /**
      * @brief 升级数据库结构（用于版本迁移）
@@ -257,6 +583,22 @@ private:
      */
     bool upgradeDatabase();
 
+    /**
+     * @brief 把密码表从版本1（Base64文本密文、ISO时间字符串）转换为版本2
+     *
+     * 按id分批复制到passwords_v2，每批一个事务，旧的XOR格式字段在复制时
+     * 重新加密为当前格式。中断后下次解锁时从已复制的最大id之后继续；
+     * 全部复制后在一个事务中替换旧表并更新版本号
+     * @return 转换是否成功
+     */
+    bool migrateToVersion2();
+
+    /**
+     * @brief 为密码表增加版本3的secrets列（记录信封密文）
+     * @return 升级是否成功
+     */
+    bool migrateToVersion3();
+
     /**
      * @brief 检查表是否存在
      * @param tableName 表名
@@ -277,6 +619,20 @@ private:
      */
     bool setDatabaseVersion(int version);
 
+    /**
+     * @brief 逐行读取已绑定参数的查询语句并组装密码项目
+     * @param stmt 查询语句
+     * @return 密码项目列表
+     */
+    QList<PasswordItem*> fetchPasswordItems(SQLCipherStatement &stmt);
+
+    /**
+     * @brief 逐行读取已绑定参数的查询语句并组装密码记录
+     * @param stmt 查询语句
+     * @return 密码记录列表
+     */
+    QList<PasswordRecord> fetchPasswordRecords(SQLCipherStatement &stmt);
+
     /**
      * @brief 记录数据库错误并发出信号
      * @param operation 操作名称
@@ -0,0 +1,133 @@
+#include "PerformanceProfile.h"
+#include <QSettings>
+
+// 设置中保存配置名和旧版本记录的数据库页大小的键
+static const QString PROFILE_SETTINGS_KEY = QStringLiteral("database/performance_profile");
+static const QString PAGE_SIZE_SETTINGS_KEY = QStringLiteral("database/cipher_page_size");
+
+/**
+ * @brief 获取打开连接后要执行的PRAGMA语句
+ * @return PRAGMA语句列表
+ */
+QStringList PerformanceProfile::pragmas() const
+{
+    return {
+        QStringLiteral("PRAGMA cipher_memory_security = %1").arg(cipherMemorySecurity ? "ON" : "OFF"),
+        QStringLiteral("PRAGMA journal_mode = %1").arg(journalMode),
+        QStringLiteral("PRAGMA synchronous = %1").arg(synchronous),
+        // 负数表示以KiB为单位
+        QStringLiteral("PRAGMA cache_size = %1").arg(-cacheSizeKiB),
+        QStringLiteral("PRAGMA mmap_size = %1").arg(mmapSize),
+        QStringLiteral("PRAGMA temp_store = %1").arg(tempStore),
+    };
+}
+
+/**
+ * @brief 获取内置的配置
+ *
+ * durable：回滚日志、每次提交完整同步，断电也不丢失已提交的修改（默认）；
+ * balanced：WAL加NORMAL同步，断电可能丢失最后几次提交但不会损坏数据库；
+ * fast：与balanced相同的持久性，使用更大的缓存和mmap并关闭内存清零，
+ * 以释放后的内存可能残留明文为代价换取速度
+ * @return 配置列表
+ */
+const QList<PerformanceProfile> &PerformanceProfile::builtinProfiles()
+{
+    static const QList<PerformanceProfile> profiles = [] {
+        PerformanceProfile durable;
+        durable.name = QStringLiteral("durable");
+        durable.journalMode = QStringLiteral("DELETE");
+        durable.synchronous = QStringLiteral("FULL");
+        durable.cacheSizeKiB = 2000;
+        durable.mmapSize = 0;
+        durable.tempStore = QStringLiteral("MEMORY");
+        durable.cipherMemorySecurity = true;
+
+        PerformanceProfile balanced;
+        balanced.name = QStringLiteral("balanced");
+        balanced.journalMode = QStringLiteral("WAL");
+        balanced.synchronous = QStringLiteral("NORMAL");
+        balanced.cacheSizeKiB = 8192;
+        balanced.mmapSize = 64 * 1024 * 1024;
+        balanced.tempStore = QStringLiteral("MEMORY");
+        balanced.cipherMemorySecurity = true;
+
+        PerformanceProfile fast;
+        fast.name = QStringLiteral("fast");
+        fast.journalMode = QStringLiteral("WAL");
+        fast.synchronous = QStringLiteral("NORMAL");
+        fast.cacheSizeKiB = 32768;
+        fast.mmapSize = 256 * 1024 * 1024;
+        fast.tempStore = QStringLiteral("MEMORY");
+        fast.cipherMemorySecurity = false;
+
+        return QList<PerformanceProfile>{durable, balanced, fast};
+    }();
+    return profiles;
+}
+
+/**
+ * @brief 按名称查找内置配置
+ * @param name 配置名
+ * @return 配置，找不到时返回默认配置
+ */
+PerformanceProfile PerformanceProfile::byName(const QString &name)
+{
+    for (const PerformanceProfile &profile : builtinProfiles()) {
+        if (profile.name == name) {
+            return profile;
+        }
+    }
+    // 默认配置durable位于列表开头
+    return builtinProfiles().at(0);
+}
+
+/**
+ * @brief 默认配置名
+ *
+ * 默认保持升级前的持久性（回滚日志加完整同步），WAL需要用户主动选择
+ */
+QString PerformanceProfile::defaultName()
+{
+    return QStringLiteral("durable");
+}
+
+/**
+ * @brief 读取已保存的配置
+ * @return 当前选择的配置
+ */
+PerformanceProfile PerformanceProfile::load()
+{
+    QSettings settings;
+    return byName(settings.value(PROFILE_SETTINGS_KEY, defaultName()).toString());
+}
+
+/**
+ * @brief 保存选择的配置名
+ * @param name 配置名
+ */
+void PerformanceProfile::save(const QString &name)
+{
+    QSettings settings;
+    settings.setValue(PROFILE_SETTINGS_KEY, name);
+}
+
+/**
+ * @brief 读取旧版本创建数据库时记录的页大小
+ * @param fallback 没有记录时使用的页大小
+ * @return 页大小
+ */
+int PerformanceProfile::storedCipherPageSize(int fallback)
+{
+    QSettings settings;
+    return settings.value(PAGE_SIZE_SETTINGS_KEY, fallback).toInt();
+}
+
+/**
+ * @brief 删除旧版本记录的页大小
+ */
+void PerformanceProfile::clearStoredCipherPageSize()
+{
+    QSettings settings;
+    settings.remove(PAGE_SIZE_SETTINGS_KEY);
+}
@@ -0,0 +1,78 @@
+#ifndef PERFORMANCEPROFILE_H
+#define PERFORMANCEPROFILE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+/**
+ * @brief SQLCipher连接的性能配置
+ *
+ * 打开数据库并设置密钥后由SQLCipherWrapper按配置执行一组PRAGMA，
+ * 在持久性和写入延迟之间取舍。配置名保存在QSettings中，下次打开时生效；
+ * 修改配置时除页大小外的设置也会立即应用到当前连接。
+ *
+ * cipher_page_size决定数据库文件的格式，不属于性能配置：数据库始终使用
+ * SQLCipher 4默认的4096字节页，只有旧版本以其他页大小创建的数据库沿用当时记录的值。
+ * SQLCipher加密的数据库不使用mmap，mmapSize只对未加密的连接有效。
+ */
+struct PerformanceProfile
+{
+    QString name;                       // 配置名（保存到设置中）
+    QString journalMode;                // journal_mode
+    QString synchronous;                // synchronous
+    int cacheSizeKiB = 2000;            // 页缓存大小（KiB）
+    qint64 mmapSize = 0;                // mmap_size（字节）
+    QString tempStore;                  // temp_store
+    bool cipherMemorySecurity = true;   // cipher_memory_security
+
+    /**
+     * @brief 获取打开连接后要执行的PRAGMA语句（不含cipher_page_size）
+     * @return PRAGMA语句列表
+     */
+    QStringList pragmas() const;
+
+    /**
+     * @brief 获取内置的配置
+     * @return 按持久性从高到低排列的配置列表
+     */
+    static const QList<PerformanceProfile> &builtinProfiles();
+
+    /**
+     * @brief 按名称查找内置配置，找不到时返回默认配置
+     * @param name 配置名
+     * @return 配置
+     */
+    static PerformanceProfile byName(const QString &name);
+
+    /**
+     * @brief 默认配置名
+     */
+    static QString defaultName();
+
+    /**
+     * @brief 读取已保存的配置
+     * @return 当前选择的配置
+     */
+    static PerformanceProfile load();
+
+    /**
+     * @brief 保存选择的配置名
+     * @param name 配置名
+     */
+    static void save(const QString &name);
+
+    /**
+     * @brief 读取旧版本创建数据库时记录的页大小
+     * @param fallback 没有记录时使用的页大小
+     * @return 页大小
+     */
+    static int storedCipherPageSize(int fallback);
+
+    /**
+     * @brief 删除旧版本记录的页大小（新建数据库时调用，避免沿用到新文件）
+     */
+    static void clearStoredCipherPageSize();
+};
+
+#endif // PERFORMANCEPROFILE_H
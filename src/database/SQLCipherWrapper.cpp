@@ -3,15 +3,79 @@
 #include <QDebug>
 #include <QDir>
 #include <QFileInfo>
+#include <QFile>
 #include <QVariant>
+#include <cstring>
+
+// 语句缓存的最大条目数
+static const int MAX_CACHED_STATEMENTS = 64;
+
+// 在线备份每步之间的休眠时间（毫秒），让出连接给其他线程
+static const int BACKUP_STEP_SLEEP_MS = 5;
+
+/**
+ * @brief 把口令转换为PRAGMA key使用的字符串字面量
+ * @param password 口令
+ * @return 转义后的字面量，SQLCipher会对其执行PBKDF2
+ */
+static QByteArray passphraseLiteral(const QString &password)
+{
+    QByteArray escaped = password.toUtf8();
+    escaped.replace('\'', "''");
+    QByteArray literal = "'" + escaped + "'";
+    escaped.fill('\0');
+    return literal;
+}
+
+/**
+ * @brief 把原始密钥转换为PRAGMA key使用的十六进制BLOB字面量
+ * @param key 原始密钥
+ * @return 形如"x'...'"的字面量，SQLCipher直接使用该密钥，不再派生
+ */
+static QByteArray rawKeyLiteral(const QByteArray &key)
+{
+    QByteArray hex = key.toHex();
+    QByteArray literal = "\"x'" + hex + "'\"";
+    hex.fill('\0');
+    return literal;
+}
+
+/**
+ * @brief 读取当前行指定列的值
+ * @param stmt 语句句柄
+ * @param column 列索引
+ * @return 列值
+ */
+static QVariant columnValue(sqlite3_stmt *stmt, int column)
+{
+    switch (sqlite3_column_type(stmt, column)) {
+        case SQLITE_INTEGER:
+            return sqlite3_column_int64(stmt, column);
+        case SQLITE_FLOAT:
+            return sqlite3_column_double(stmt, column);
+        case SQLITE_TEXT:
+            return QString::fromUtf8(reinterpret_cast<const char*>(sqlite3_column_text(stmt, column)),
+                                     sqlite3_column_bytes(stmt, column));
+        case SQLITE_BLOB:
+            return QByteArray(reinterpret_cast<const char*>(sqlite3_column_blob(stmt, column)),
+                              sqlite3_column_bytes(stmt, column));
+        case SQLITE_NULL:
+        default:
+            return QVariant();
+    }
+}
 
 SQLCipherWrapper::SQLCipherWrapper(QObject *parent)
     : QObject(parent)
     , m_db(nullptr)
     , m_isConnected(false)
     , m_isEncrypted(false)
+    , m_readOnly(false)
     , m_lastInsertId(-1)
     , m_affectedRows(0)
+    , m_connectionId(0)
+    , m_cipherPageSize(4096)
+    , m_profile(PerformanceProfile::byName(PerformanceProfile::defaultName()))
 {
 }
 
@@ -60,17 +124,70 @@ bool SQLCipherWrapper::openDatabase(const QString &dbPath)
     return true;
 }
 
-void SQLCipherWrapper::closeDatabase()
+bool SQLCipherWrapper::openReadOnly(const SQLCipherWrapper &source)
 {
-    if (m_db) {
+    if (m_isConnected) {
+        closeDatabase();
+    }
+
+    QByteArray keyLiteral;
+    {
+        QMutexLocker locker(&source.m_mutex);
+        if (!source.m_isConnected || !source.m_isEncrypted) {
+            setLastError("Source database not keyed");
+            return false;
+        }
+        m_dbPath = source.m_dbPath;
+        m_cipherPageSize = source.m_cipherPageSize;
+        keyLiteral = source.m_key;
+    }
+
+    int result = sqlite3_open_v2(QFile::encodeName(m_dbPath).constData(), &m_db,
+                                 SQLITE_OPEN_READONLY, nullptr);
+    if (result != SQLITE_OK) {
+        setLastError(QString("Failed to open database: %1").arg(m_db ? sqlite3_errmsg(m_db) : "out of memory"));
         sqlite3_close(m_db);
         m_db = nullptr;
+        keyLiteral.fill('\0');
+        return false;
+    }
+
+    m_isConnected = true;
+    m_readOnly = true;
+    const bool keyed = applyKey(keyLiteral, "SELECT count(*) FROM sqlite_master");
+    keyLiteral.fill('\0');
+    if (!keyed) {
+        closeDatabase();
+        return false;
+    }
+    return true;
+}
+
+bool SQLCipherWrapper::closeDatabase()
+{
+    QMutexLocker locker(&m_mutex);
+    clearStatementCache();
+    ++m_connectionId;
+    bool closed = true;
+    if (m_db) {
+        int result = sqlite3_close(m_db);
+        if (result != SQLITE_OK) {
+            // 仍有未结束的备份等对象占用连接，交给SQLite在它们结束后释放句柄
+            qCritical() << "Failed to close SQLCipher database:" << sqlite3_errmsg(m_db);
+            sqlite3_close_v2(m_db);
+            closed = false;
+        }
+        m_db = nullptr;
     }
     m_isConnected = false;
     m_isEncrypted = false;
+    m_readOnly = false;
+    m_key.fill('\0');
+    m_key.clear();
     m_lastInsertId = -1;
     m_affectedRows = 0;
     qInfo() << "SQLCipher database closed";
+    return closed;
 }
 
 bool SQLCipherWrapper::setPassword(const QString &password)
@@ -80,20 +197,12 @@ bool SQLCipherWrapper::setPassword(const QString &password)
         return false;
     }
 
-    // 设置数据库密码
-    QString pragmaSql = QString("PRAGMA key = '%1'").arg(password);
-    if (!execute(pragmaSql)) {
-        return false;
-    }
-
     // 对于新数据库，sqlite_master可能为空，所以不强制验证
     // 只检查是否能正常执行SQL语句
-    if (!execute("SELECT 1")) {
-        setLastError("Invalid password or database corrupted");
+    if (!applyKey(passphraseLiteral(password), "SELECT 1")) {
         return false;
     }
 
-    m_isEncrypted = true;
     qInfo() << "Database password set successfully";
     return true;
 }
@@ -105,19 +214,10 @@ bool SQLCipherWrapper::verifyPassword(const QString &password)
         return false;
     }
 
-    // 设置数据库密码
-    QString pragmaSql = QString("PRAGMA key = '%1'").arg(password);
-    if (!execute(pragmaSql)) {
+    if (!applyKey(passphraseLiteral(password), "SELECT count(*) FROM sqlite_master")) {
         return false;
     }
 
-    // 验证密码是否正确
-    if (!execute("SELECT count(*) FROM sqlite_master")) {
-        setLastError("Invalid password");
-        return false;
-    }
-
-    m_isEncrypted = true;
     qInfo() << "Database password verified successfully";
     return true;
 }
@@ -134,9 +234,7 @@ bool SQLCipherWrapper::changePassword(const QString &oldPassword, const QString
         return false;
     }
 
-    // 更改数据库密码
-    QString pragmaSql = QString("PRAGMA rekey = '%1'").arg(newPassword);
-    if (!execute(pragmaSql)) {
+    if (!changeKey(passphraseLiteral(newPassword))) {
         return false;
     }
 
@@ -144,8 +242,101 @@ bool SQLCipherWrapper::changePassword(const QString &oldPassword, const QString
     return true;
 }
 
+bool SQLCipherWrapper::setKey(const QByteArray &key)
+{
+    if (!m_isConnected || key.isEmpty()) {
+        setLastError("Database not connected or key is empty");
+        return false;
+    }
+
+    if (!applyKey(rawKeyLiteral(key), "SELECT 1")) {
+        return false;
+    }
+
+    qInfo() << "Database key set successfully";
+    return true;
+}
+
+bool SQLCipherWrapper::verifyKey(const QByteArray &key)
+{
+    if (!m_isConnected || key.isEmpty()) {
+        setLastError("Database not connected or key is empty");
+        return false;
+    }
+
+    if (!applyKey(rawKeyLiteral(key), "SELECT count(*) FROM sqlite_master")) {
+        return false;
+    }
+
+    qInfo() << "Database key verified successfully";
+    return true;
+}
+
+bool SQLCipherWrapper::rekey(const QByteArray &key)
+{
+    if (!m_isConnected || !m_isEncrypted || key.isEmpty()) {
+        setLastError("Database not keyed or new key is empty");
+        return false;
+    }
+
+    if (!changeKey(rawKeyLiteral(key))) {
+        return false;
+    }
+
+    qInfo() << "Database rekeyed successfully";
+    return true;
+}
+
+bool SQLCipherWrapper::applyKey(const QByteArray &keyLiteral, const QString &checkSql)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // 页大小必须紧随密钥设置；直接执行而不经过execute，出错信息中不会带出密钥
+    QByteArray sql = "PRAGMA key = " + keyLiteral
+                   + "; PRAGMA cipher_page_size = " + QByteArray::number(m_cipherPageSize);
+    const int rc = sqlite3_exec(m_db, sql.constData(), nullptr, nullptr, nullptr);
+    sql.fill('\0');
+    if (rc != SQLITE_OK) {
+        setLastError(QString("Failed to set database key: %1").arg(sqlite3_errmsg(m_db)));
+        return false;
+    }
+
+    // 密钥错误时第一次读取数据库页才会失败
+    if (!execute(checkSql)) {
+        setLastError("Invalid key or database corrupted");
+        return false;
+    }
+
+    m_isEncrypted = true;
+    m_key.fill('\0');
+    m_key = keyLiteral;
+    // 只读连接无法切换日志模式，沿用数据库文件当前的设置
+    if (!m_readOnly) {
+        applyPerformanceProfile(m_profile);
+    }
+    return true;
+}
+
+bool SQLCipherWrapper::changeKey(const QByteArray &keyLiteral)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QByteArray sql = "PRAGMA rekey = " + keyLiteral;
+    const int rc = sqlite3_exec(m_db, sql.constData(), nullptr, nullptr, nullptr);
+    sql.fill('\0');
+    if (rc != SQLITE_OK) {
+        setLastError(QString("Failed to rekey database: %1").arg(sqlite3_errmsg(m_db)));
+        return false;
+    }
+
+    m_key.fill('\0');
+    m_key = keyLiteral;
+    return true;
+}
+
 bool SQLCipherWrapper::execute(const QString &sql)
 {
+    QMutexLocker locker(&m_mutex);
     if (!m_isConnected) {
         setLastError("Database not connected");
         return false;
@@ -167,8 +358,7 @@ bool SQLCipherWrapper::execute(const QString &sql)
     }
 
     // 获取影响的行数和最后插入的ID
-    m_affectedRows = sqlite3_changes(m_db);
-    m_lastInsertId = sqlite3_last_insert_rowid(m_db);
+    updateExecutionStats();
 
     sqlite3_finalize(stmt);
     return true;
@@ -178,6 +368,7 @@ QList<QVariantMap> SQLCipherWrapper::query(const QString &sql)
 {
     QList<QVariantMap> results;
     
+    QMutexLocker locker(&m_mutex);
     if (!m_isConnected) {
         setLastError("Database not connected");
         return results;
@@ -204,30 +395,7 @@ QList<QVariantMap> SQLCipherWrapper::query(const QString &sql)
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         QVariantMap row;
         for (int i = 0; i < columnCount; ++i) {
-            QString columnName = columnNames[i];
-            int columnType = sqlite3_column_type(stmt, i);
-            
-            QVariant value;
-            switch (columnType) {
-                case SQLITE_INTEGER:
-                    value = sqlite3_column_int64(stmt, i);
-                    break;
-                case SQLITE_FLOAT:
-                    value = sqlite3_column_double(stmt, i);
-                    break;
-                case SQLITE_TEXT:
-                    value = QString::fromUtf8(reinterpret_cast<const char*>(sqlite3_column_text(stmt, i)));
-                    break;
-                case SQLITE_BLOB:
-                    value = QByteArray(reinterpret_cast<const char*>(sqlite3_column_blob(stmt, i)), 
-                                     sqlite3_column_bytes(stmt, i));
-                    break;
-                case SQLITE_NULL:
-                default:
-                    value = QVariant();
-                    break;
-            }
-            row[columnName] = value;
+            row[columnNames[i]] = columnValue(stmt, i);
         }
         results.append(row);
     }
@@ -236,6 +404,70 @@ QList<QVariantMap> SQLCipherWrapper::query(const QString &sql)
     return results;
 }
 
+SQLCipherStatement SQLCipherWrapper::prepare(const QString &sql)
+{
+    // SQLite连接本身是串行化的，这里只需保护语句缓存
+    QMutexLocker locker(&m_mutex);
+    if (!m_isConnected) {
+        setLastError("Database not connected");
+        return SQLCipherStatement();
+    }
+
+    // 优先复用缓存中空闲的语句
+    sqlite3_stmt *cached = m_statementCache.value(sql, nullptr);
+    if (cached && !m_busyStatements.contains(cached)) {
+        m_busyStatements.insert(cached);
+        return SQLCipherStatement(this, cached, true);
+    }
+
+    sqlite3_stmt *stmt = nullptr;
+    int result = sqlite3_prepare_v3(m_db, sql.toUtf8().constData(), -1,
+                                    SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+    if (result != SQLITE_OK) {
+        setLastError(QString("Failed to prepare statement: %1").arg(sqlite3_errmsg(m_db)));
+        sqlite3_finalize(stmt);
+        return SQLCipherStatement();
+    }
+
+    // 缓存中已有同一SQL（正被占用）或缓存已满时，返回临时语句
+    if (cached || m_statementCache.size() >= MAX_CACHED_STATEMENTS) {
+        m_temporaryStatements.insert(stmt);
+        return SQLCipherStatement(this, stmt, false);
+    }
+
+    m_statementCache.insert(sql, stmt);
+    m_busyStatements.insert(stmt);
+    return SQLCipherStatement(this, stmt, true);
+}
+
+void SQLCipherWrapper::clearStatementCache()
+{
+    QMutexLocker locker(&m_mutex);
+    for (sqlite3_stmt *stmt : std::as_const(m_statementCache)) {
+        sqlite3_finalize(stmt);
+    }
+    m_statementCache.clear();
+    m_busyStatements.clear();
+    // 临时语句的句柄可能比连接活得更久，关闭前一并销毁
+    for (sqlite3_stmt *stmt : std::as_const(m_temporaryStatements)) {
+        sqlite3_finalize(stmt);
+    }
+    m_temporaryStatements.clear();
+}
+
+void SQLCipherWrapper::releaseCachedStatement(sqlite3_stmt *stmt)
+{
+    QMutexLocker locker(&m_mutex);
+    m_busyStatements.remove(stmt);
+}
+
+void SQLCipherWrapper::updateExecutionStats()
+{
+    QMutexLocker locker(&m_mutex);
+    m_affectedRows = sqlite3_changes(m_db);
+    m_lastInsertId = sqlite3_last_insert_rowid(m_db);
+}
+
 qint64 SQLCipherWrapper::lastInsertId() const
 {
     return m_lastInsertId;
@@ -248,6 +480,7 @@ int SQLCipherWrapper::affectedRows() const
 
 QString SQLCipherWrapper::lastError() const
 {
+    QMutexLocker locker(&m_mutex);
     return m_lastError;
 }
 
@@ -276,9 +509,122 @@ bool SQLCipherWrapper::rollbackTransaction()
     return execute("ROLLBACK");
 }
 
+void SQLCipherWrapper::setCipherPageSize(int pageSize)
+{
+    m_cipherPageSize = pageSize;
+}
+
+bool SQLCipherWrapper::applyPerformanceProfile(const PerformanceProfile &profile)
+{
+    QMutexLocker locker(&m_mutex);
+    m_profile = profile;
+    if (!m_isConnected || !m_isEncrypted) {
+        return true;
+    }
+
+    // 单条设置失败（如事务中无法切换日志模式）不影响其余设置
+    bool ok = true;
+    for (const QString &pragma : profile.pragmas()) {
+        if (!execute(pragma)) {
+            qWarning() << "Failed to apply" << pragma << ":" << m_lastError;
+            ok = false;
+        }
+    }
+    qInfo() << "Applied performance profile:" << profile.name;
+    return ok;
+}
+
+bool SQLCipherWrapper::backupTo(const QString &destPath, int pagesPerStep,
+                                const std::function<bool(int, int)> &progress)
+{
+    if (!m_isConnected) {
+        setLastError("Database not connected");
+        return false;
+    }
+
+    const QString tempPath = destPath + QStringLiteral(".part");
+    QFile::remove(tempPath);
+    sqlite3 *dest = nullptr;
+    if (sqlite3_open_v2(QFile::encodeName(tempPath).constData(), &dest,
+                        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+        setLastError(QString("Failed to open backup file: %1").arg(dest ? sqlite3_errmsg(dest) : "out of memory"));
+        sqlite3_close(dest);
+        return false;
+    }
+
+    sqlite3_backup *backup = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        // 备份文件必须使用相同的密钥，否则页面会以明文写出
+        if (m_isEncrypted) {
+            QByteArray sql = "PRAGMA key = " + m_key;
+            sql += "; PRAGMA cipher_page_size = " + QByteArray::number(m_cipherPageSize);
+            const int rc = sqlite3_exec(dest, sql.constData(), nullptr, nullptr, nullptr);
+            sql.fill('\0');
+            if (rc != SQLITE_OK) {
+                setLastError(QString("Failed to key backup file: %1").arg(sqlite3_errmsg(dest)));
+                sqlite3_close(dest);
+                QFile::remove(tempPath);
+                return false;
+            }
+        }
+        backup = sqlite3_backup_init(dest, "main", m_db, "main");
+    }
+    if (!backup) {
+        setLastError(QString("Failed to start backup: %1").arg(sqlite3_errmsg(dest)));
+        sqlite3_close(dest);
+        QFile::remove(tempPath);
+        return false;
+    }
+
+    int rc = SQLITE_OK;
+    bool cancelled = false;
+    while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+        {
+            QMutexLocker locker(&m_mutex);
+            rc = sqlite3_backup_step(backup, pagesPerStep);
+        }
+        const int total = sqlite3_backup_pagecount(backup);
+        if (progress && !progress(total - sqlite3_backup_remaining(backup), total)) {
+            cancelled = rc != SQLITE_DONE;
+            break;
+        }
+        if (rc != SQLITE_DONE) {
+            sqlite3_sleep(BACKUP_STEP_SLEEP_MS);
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        sqlite3_backup_finish(backup);
+    }
+    const bool success = rc == SQLITE_DONE && !cancelled;
+    if (!success) {
+        setLastError(cancelled ? QStringLiteral("Backup cancelled")
+                               : QString("Backup failed: %1").arg(sqlite3_errstr(rc)));
+    }
+    sqlite3_close(dest);
+
+    if (!success) {
+        QFile::remove(tempPath);
+        return false;
+    }
+    QFile::remove(destPath);
+    if (!QFile::rename(tempPath, destPath)) {
+        setLastError(QString("Failed to move backup file to %1").arg(destPath));
+        QFile::remove(tempPath);
+        return false;
+    }
+    return true;
+}
+
 void SQLCipherWrapper::setLastError(const QString &error)
 {
-    m_lastError = error;
+    {
+        // 界面线程和数据库线程都会写入错误信息
+        QMutexLocker locker(&m_mutex);
+        m_lastError = error;
+    }
     qCritical() << "SQLCipher error:" << error;
     emit databaseError(error);
 }
@@ -297,4 +643,375 @@ bool SQLCipherWrapper::checkSQLCipherVersion()
     
     qInfo() << "SQLCipher version:" << version;
     return true;
-} 
\ No newline at end of file
+}
+
+// SQLCipherResultSet实现
+
+QByteArray SQLCipherResultSet::columnName(int column) const
+{
+    return m_columns.at(column).name;
+}
+
+int SQLCipherResultSet::columnIndex(QByteArrayView name) const
+{
+    for (int i = 0; i < m_columns.size(); ++i) {
+        if (name.compare(m_columns.at(i).name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool SQLCipherResultSet::isNull(int row, int column) const
+{
+    return m_columns.at(column).types.at(row) == SQLITE_NULL;
+}
+
+qint64 SQLCipherResultSet::int64(int row, int column) const
+{
+    const Column &col = m_columns.at(column);
+    switch (col.types.at(row)) {
+        case SQLITE_INTEGER:
+            return col.values.at(row);
+        case SQLITE_FLOAT:
+            return static_cast<qint64>(real(row, column));
+        default:
+            return 0;
+    }
+}
+
+double SQLCipherResultSet::real(int row, int column) const
+{
+    const Column &col = m_columns.at(column);
+    switch (col.types.at(row)) {
+        case SQLITE_FLOAT: {
+            double value = 0.0;
+            const qint64 bits = col.values.at(row);
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        case SQLITE_INTEGER:
+            return static_cast<double>(col.values.at(row));
+        default:
+            return 0.0;
+    }
+}
+
+QByteArrayView SQLCipherResultSet::bytes(int row, int column) const
+{
+    const Column &col = m_columns.at(column);
+    const quint8 type = col.types.at(row);
+    if (type != SQLITE_TEXT && type != SQLITE_BLOB) {
+        return QByteArrayView();
+    }
+    return QByteArrayView(col.data.constData() + col.values.at(row), col.lengths.at(row));
+}
+
+QUtf8StringView SQLCipherResultSet::text(int row, int column) const
+{
+    QByteArrayView view = bytes(row, column);
+    return QUtf8StringView(view.data(), view.size());
+}
+
+QString SQLCipherResultSet::string(int row, int column) const
+{
+    if (isNull(row, column)) {
+        return QString();
+    }
+    return QString::fromUtf8(bytes(row, column));
+}
+
+// SQLCipherStatement实现
+
+SQLCipherStatement::SQLCipherStatement(SQLCipherWrapper *owner, sqlite3_stmt *stmt, bool cached)
+    : m_owner(owner)
+    , m_stmt(stmt)
+    , m_cached(cached)
+    , m_connectionId(owner->m_connectionId)
+{
+}
+
+SQLCipherStatement::SQLCipherStatement(SQLCipherStatement &&other) noexcept
+    : m_owner(other.m_owner)
+    , m_stmt(other.m_stmt)
+    , m_cached(other.m_cached)
+    , m_connectionId(other.m_connectionId)
+{
+    other.m_owner = nullptr;
+    other.m_stmt = nullptr;
+}
+
+SQLCipherStatement &SQLCipherStatement::operator=(SQLCipherStatement &&other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_owner = other.m_owner;
+        m_stmt = other.m_stmt;
+        m_cached = other.m_cached;
+        m_connectionId = other.m_connectionId;
+        other.m_owner = nullptr;
+        other.m_stmt = nullptr;
+    }
+    return *this;
+}
+
+SQLCipherStatement::~SQLCipherStatement()
+{
+    release();
+}
+
+bool SQLCipherStatement::bindText(int index, const QString &value)
+{
+    if (!m_stmt) {
+        return false;
+    }
+    QByteArray utf8 = value.toUtf8();
+    int result = sqlite3_bind_text(m_stmt, index, utf8.constData(), utf8.size(), SQLITE_TRANSIENT);
+    if (result != SQLITE_OK) {
+        m_owner->setLastError(QString("Failed to bind parameter %1: %2").arg(index).arg(sqlite3_errstr(result)));
+        return false;
+    }
+    return true;
+}
+
+bool SQLCipherStatement::bindInt64(int index, qint64 value)
+{
+    if (!m_stmt) {
+        return false;
+    }
+    int result = sqlite3_bind_int64(m_stmt, index, value);
+    if (result != SQLITE_OK) {
+        m_owner->setLastError(QString("Failed to bind parameter %1: %2").arg(index).arg(sqlite3_errstr(result)));
+        return false;
+    }
+    return true;
+}
+
+bool SQLCipherStatement::bindDouble(int index, double value)
+{
+    if (!m_stmt) {
+        return false;
+    }
+    int result = sqlite3_bind_double(m_stmt, index, value);
+    if (result != SQLITE_OK) {
+        m_owner->setLastError(QString("Failed to bind parameter %1: %2").arg(index).arg(sqlite3_errstr(result)));
+        return false;
+    }
+    return true;
+}
+
+bool SQLCipherStatement::bindBlob(int index, const QByteArray &value)
+{
+    if (!m_stmt) {
+        return false;
+    }
+    // 使用zeroblob保证空数组也绑定为BLOB而不是NULL
+    int result = value.isEmpty()
+                     ? sqlite3_bind_zeroblob(m_stmt, index, 0)
+                     : sqlite3_bind_blob(m_stmt, index, value.constData(), value.size(), SQLITE_TRANSIENT);
+    if (result != SQLITE_OK) {
+        m_owner->setLastError(QString("Failed to bind parameter %1: %2").arg(index).arg(sqlite3_errstr(result)));
+        return false;
+    }
+    return true;
+}
+
+bool SQLCipherStatement::bindNull(int index)
+{
+    if (!m_stmt) {
+        return false;
+    }
+    int result = sqlite3_bind_null(m_stmt, index);
+    if (result != SQLITE_OK) {
+        m_owner->setLastError(QString("Failed to bind parameter %1: %2").arg(index).arg(sqlite3_errstr(result)));
+        return false;
+    }
+    return true;
+}
+
+bool SQLCipherStatement::next()
+{
+    if (!m_stmt) {
+        return false;
+    }
+    // 连接由界面线程和数据库线程共用，执行和读取错误信息要在同一把锁内，
+    // 否则sqlite3_errmsg可能返回另一个线程的错误
+    QMutexLocker locker(&m_owner->m_mutex);
+    // 连接关闭时语句已被销毁
+    if (m_owner->m_connectionId != m_connectionId) {
+        return false;
+    }
+    int result = sqlite3_step(m_stmt);
+    if (result == SQLITE_ROW) {
+        return true;
+    }
+    if (result != SQLITE_DONE) {
+        m_owner->setLastError(QString("Failed to execute statement: %1")
+                              .arg(sqlite3_errmsg(sqlite3_db_handle(m_stmt))));
+    }
+    return false;
+}
+
+bool SQLCipherStatement::exec()
+{
+    if (!m_stmt) {
+        return false;
+    }
+    QMutexLocker locker(&m_owner->m_mutex);
+    if (m_owner->m_connectionId != m_connectionId) {
+        m_owner->setLastError("Database connection was closed");
+        return false;
+    }
+    int result = sqlite3_step(m_stmt);
+    while (result == SQLITE_ROW) {
+        result = sqlite3_step(m_stmt);
+    }
+    if (result != SQLITE_DONE) {
+        m_owner->setLastError(QString("Failed to execute statement: %1")
+                              .arg(sqlite3_errmsg(sqlite3_db_handle(m_stmt))));
+        sqlite3_reset(m_stmt);
+        return false;
+    }
+    m_owner->updateExecutionStats();
+    sqlite3_reset(m_stmt);
+    return true;
+}
+
+qint64 SQLCipherStatement::execInsert()
+{
+    if (!m_stmt) {
+        return -1;
+    }
+    // 持有连接锁直到读出行ID，期间其他线程的插入不会改变last_insert_rowid
+    QMutexLocker locker(&m_owner->m_mutex);
+    if (!exec()) {
+        return -1;
+    }
+    return sqlite3_last_insert_rowid(sqlite3_db_handle(m_stmt));
+}
+
+void SQLCipherStatement::reset()
+{
+    if (m_stmt) {
+        QMutexLocker locker(&m_owner->m_mutex);
+        if (m_owner->m_connectionId != m_connectionId) {
+            return;
+        }
+        sqlite3_reset(m_stmt);
+        sqlite3_clear_bindings(m_stmt);
+    }
+}
+
+int SQLCipherStatement::columnCount() const
+{
+    return m_stmt ? sqlite3_column_count(m_stmt) : 0;
+}
+
+bool SQLCipherStatement::isNull(int column) const
+{
+    return !m_stmt || sqlite3_column_type(m_stmt, column) == SQLITE_NULL;
+}
+
+qint64 SQLCipherStatement::columnInt64(int column) const
+{
+    return m_stmt ? sqlite3_column_int64(m_stmt, column) : 0;
+}
+
+double SQLCipherStatement::columnDouble(int column) const
+{
+    return m_stmt ? sqlite3_column_double(m_stmt, column) : 0.0;
+}
+
+QByteArrayView SQLCipherStatement::columnBytes(int column) const
+{
+    if (!m_stmt) {
+        return QByteArrayView();
+    }
+    // 先取指针再取长度，这是SQLite推荐的调用顺序
+    const char *data = static_cast<const char*>(sqlite3_column_blob(m_stmt, column));
+    return QByteArrayView(data, sqlite3_column_bytes(m_stmt, column));
+}
+
+QString SQLCipherStatement::columnText(int column) const
+{
+    if (isNull(column)) {
+        return QString();
+    }
+    return QString::fromUtf8(columnBytes(column));
+}
+
+SQLCipherResultSet SQLCipherStatement::fetch(int maxRows)
+{
+    SQLCipherResultSet result;
+    if (!m_stmt) {
+        return result;
+    }
+    // 整批读取期间持有连接锁，逐行的next()重入同一把锁
+    QMutexLocker locker(&m_owner->m_mutex);
+
+    const int columnCount = sqlite3_column_count(m_stmt);
+    result.m_columns.resize(columnCount);
+    for (int i = 0; i < columnCount; ++i) {
+        SQLCipherResultSet::Column &column = result.m_columns[i];
+        column.name = QByteArray(sqlite3_column_name(m_stmt, i));
+        if (maxRows > 0) {
+            column.types.reserve(maxRows);
+            column.values.reserve(maxRows);
+            column.lengths.reserve(maxRows);
+        }
+    }
+
+    while ((maxRows < 0 || result.m_rowCount < maxRows) && next()) {
+        for (int i = 0; i < columnCount; ++i) {
+            SQLCipherResultSet::Column &column = result.m_columns[i];
+            const int type = sqlite3_column_type(m_stmt, i);
+            qint64 value = 0;
+            int length = 0;
+            switch (type) {
+                case SQLITE_INTEGER:
+                    value = sqlite3_column_int64(m_stmt, i);
+                    break;
+                case SQLITE_FLOAT: {
+                    const double real = sqlite3_column_double(m_stmt, i);
+                    std::memcpy(&value, &real, sizeof(value));
+                    break;
+                }
+                case SQLITE_TEXT:
+                case SQLITE_BLOB: {
+                    QByteArrayView bytes = columnBytes(i);
+                    value = column.data.size();
+                    length = static_cast<int>(bytes.size());
+                    column.data.append(bytes);
+                    break;
+                }
+                default:
+                    break;
+            }
+            column.types.append(static_cast<quint8>(type));
+            column.values.append(value);
+            column.lengths.append(length);
+        }
+        ++result.m_rowCount;
+    }
+    return result;
+}
+
+void SQLCipherStatement::release()
+{
+    if (!m_stmt) {
+        return;
+    }
+    // 连接已关闭时缓存语句已被销毁，不能再访问
+    QMutexLocker locker(&m_owner->m_mutex);
+    if (m_owner->m_connectionId == m_connectionId) {
+        if (m_cached) {
+            reset();
+            m_owner->releaseCachedStatement(m_stmt);
+        } else {
+            m_owner->m_temporaryStatements.remove(m_stmt);
+            sqlite3_finalize(m_stmt);
+        }
+    }
+    m_stmt = nullptr;
+    m_owner = nullptr;
+}
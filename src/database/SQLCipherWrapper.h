@@ -5,10 +5,281 @@
 #include <QString>
 #include <QList>
 #include <QVariantMap>
+#include <QByteArrayView>
+#include <QUtf8StringView>
+#include <QHash>
+#include <QSet>
+#include <QRecursiveMutex>
+#include <functional>
+#include "PerformanceProfile.h"
 #include <QSqlError>
 
 // 前向声明
 struct sqlite3;
+struct sqlite3_stmt;
+class SQLCipherWrapper;
+class SQLCipherStatement;
+
+/**
+ * @brief 按列存储的查询结果
+ *
+ * 由SQLCipherStatement::fetch()生成。每一列的数据分别保存在连续的数组中，
+ * 文本和BLOB内容拼接存放在该列的一个缓冲区里，因此内存分配次数与列数相关，
+ * 而不是与单元格数量相关。列只能通过索引访问，text()/bytes()返回指向
+ * 内部缓冲区的视图，在结果集销毁前有效，不产生拷贝。
+ */
+class SQLCipherResultSet
+{
+public:
+    SQLCipherResultSet() = default;
+
+    /**
+     * @brief 获取行数
+     * @return 行数
+     */
+    int rowCount() const { return m_rowCount; }
+
+    /**
+     * @brief 获取列数
+     * @return 列数
+     */
+    int columnCount() const { return static_cast<int>(m_columns.size()); }
+
+    /**
+     * @brief 获取列名
+     * @param column 列索引
+     * @return 列名（UTF-8）
+     */
+    QByteArray columnName(int column) const;
+
+    /**
+     * @brief 根据列名查找列索引
+     * @param name 列名
+     * @return 列索引，未找到返回-1
+     */
+    int columnIndex(QByteArrayView name) const;
+
+    /**
+     * @brief 检查单元格是否为NULL
+     * @param row 行索引
+     * @param column 列索引
+     * @return 是否为NULL
+     */
+    bool isNull(int row, int column) const;
+
+    /**
+     * @brief 读取整数值
+     * @param row 行索引
+     * @param column 列索引
+     * @return 整数值（浮点会被截断，其他类型返回0）
+     */
+    qint64 int64(int row, int column) const;
+
+    /**
+     * @brief 读取浮点值
+     * @param row 行索引
+     * @param column 列索引
+     * @return 浮点值（其他类型返回0）
+     */
+    double real(int row, int column) const;
+
+    /**
+     * @brief 以零拷贝视图读取文本或BLOB内容
+     * @param row 行索引
+     * @param column 列索引
+     * @return 原始字节视图，其他类型返回空视图
+     */
+    QByteArrayView bytes(int row, int column) const;
+
+    /**
+     * @brief 以零拷贝视图读取UTF-8文本
+     * @param row 行索引
+     * @param column 列索引
+     * @return UTF-8文本视图
+     */
+    QUtf8StringView text(int row, int column) const;
+
+    /**
+     * @brief 读取文本并转换为QString（会分配内存）
+     * @param row 行索引
+     * @param column 列索引
+     * @return 文本值，NULL返回空QString
+     */
+    QString string(int row, int column) const;
+
+private:
+    friend class SQLCipherStatement;
+
+    /**
+     * @brief 单列的数据存储
+     */
+    struct Column {
+        QByteArray name;           ///< 列名
+        QList<quint8> types;       ///< 每行的SQLite类型
+        QList<qint64> values;      ///< 整数值、浮点位模式或文本在data中的偏移
+        QList<int> lengths;        ///< 文本/BLOB长度
+        QByteArray data;           ///< 该列所有文本/BLOB内容
+    };
+
+    QList<Column> m_columns;       ///< 所有列
+    int m_rowCount = 0;            ///< 行数
+};
+
+/**
+ * @brief 预编译语句句柄
+ *
+ * 由SQLCipherWrapper::prepare()返回，封装一个可复用的sqlite3_stmt。
+ * 句柄只能移动不能复制，析构时自动reset并清除绑定参数，
+ * 缓存中的语句随后可以被下一次prepare()直接复用，无需重新解析SQL。
+ * 参数索引从1开始，与sqlite3_bind_*保持一致。
+ */
+class SQLCipherStatement
+{
+public:
+    SQLCipherStatement() = default;
+    SQLCipherStatement(SQLCipherStatement &&other) noexcept;
+    SQLCipherStatement &operator=(SQLCipherStatement &&other) noexcept;
+    ~SQLCipherStatement();
+
+    SQLCipherStatement(const SQLCipherStatement &) = delete;
+    SQLCipherStatement &operator=(const SQLCipherStatement &) = delete;
+
+    /**
+     * @brief 检查语句是否有效
+     * @return 预编译成功则返回true
+     */
+    bool isValid() const { return m_stmt != nullptr; }
+
+    /**
+     * @brief 绑定文本参数（空QString绑定为空字符串，NULL请用bindNull）
+     * @param index 参数索引（从1开始）
+     * @param value 文本值
+     * @return 是否成功
+     */
+    bool bindText(int index, const QString &value);
+
+    /**
+     * @brief 绑定整数参数
+     * @param index 参数索引（从1开始）
+     * @param value 整数值
+     * @return 是否成功
+     */
+    bool bindInt64(int index, qint64 value);
+
+    /**
+     * @brief 绑定浮点参数
+     * @param index 参数索引（从1开始）
+     * @param value 浮点值
+     * @return 是否成功
+     */
+    bool bindDouble(int index, double value);
+
+    /**
+     * @brief 绑定二进制参数（空QByteArray绑定为零长度BLOB，NULL请用bindNull）
+     * @param index 参数索引（从1开始）
+     * @param value 二进制数据
+     * @return 是否成功
+     */
+    bool bindBlob(int index, const QByteArray &value);
+
+    /**
+     * @brief 绑定NULL参数
+     * @param index 参数索引（从1开始）
+     * @return 是否成功
+     */
+    bool bindNull(int index);
+
+    /**
+     * @brief 执行一步，获取下一行
+     * @return 有新行时返回true，结束或出错返回false
+     */
+    bool next();
+
+    /**
+     * @brief 执行语句直到完成（用于INSERT/UPDATE/DELETE）
+     *
+     * 成功后会更新SQLCipherWrapper的lastInsertId()和affectedRows()
+     * @return 是否成功
+     */
+    bool exec();
+
+    /**
+     * @brief 执行INSERT语句并返回新行的ID
+     *
+     * 执行和读取行ID期间持有连接锁，不会读到其他线程插入的行ID
+     * @return 新行ID，失败返回-1
+     */
+    qint64 execInsert();
+
+    /**
+     * @brief 重置语句并清除绑定参数，以便再次执行
+     */
+    void reset();
+
+    /**
+     * @brief 获取结果列数
+     * @return 列数
+     */
+    int columnCount() const;
+
+    /**
+     * @brief 检查当前行的列是否为NULL
+     * @param column 列索引
+     * @return 是否为NULL
+     */
+    bool isNull(int column) const;
+
+    /**
+     * @brief 读取当前行的整数列
+     * @param column 列索引
+     * @return 整数值
+     */
+    qint64 columnInt64(int column) const;
+
+    /**
+     * @brief 读取当前行的浮点列
+     * @param column 列索引
+     * @return 浮点值
+     */
+    double columnDouble(int column) const;
+
+    /**
+     * @brief 以零拷贝视图读取当前行的文本或BLOB列
+     *
+     * 视图指向SQLite内部内存，在下一次next()/reset()之前有效
+     * @param column 列索引
+     * @return 原始字节视图
+     */
+    QByteArrayView columnBytes(int column) const;
+
+    /**
+     * @brief 读取当前行的文本列并转换为QString
+     * @param column 列索引
+     * @return 文本值
+     */
+    QString columnText(int column) const;
+
+    /**
+     * @brief 把剩余结果读入按列存储的结果集
+     * @param maxRows 最多读取的行数，-1表示读取全部
+     * @return 结果集
+     */
+    SQLCipherResultSet fetch(int maxRows = -1);
+
+private:
+    friend class SQLCipherWrapper;
+    SQLCipherStatement(SQLCipherWrapper *owner, sqlite3_stmt *stmt, bool cached);
+
+    /**
+     * @brief 归还语句（缓存语句放回缓存，临时语句直接销毁）
+     */
+    void release();
+
+    SQLCipherWrapper *m_owner = nullptr;  ///< 所属的数据库封装
+    sqlite3_stmt *m_stmt = nullptr;       ///< 语句句柄
+    bool m_cached = false;                ///< 是否来自语句缓存
+    quint64 m_connectionId = 0;           ///< 创建时的连接编号
+};
 
 /**
  * @brief SQLCipher数据库封装类
@@ -30,10 +301,24 @@ public:
      */
     bool openDatabase(const QString &dbPath);
 
+    /**
+     * @brief 以只读方式打开另一个连接的数据库文件
+     *
+     * 使用与source相同的密钥和页大小，不应用性能配置。在本连接上开启的
+     * 读事务是独立的快照，不占用source的连接锁
+     * @param source 已设置密钥的连接
+     * @return 是否成功
+     */
+    bool openReadOnly(const SQLCipherWrapper &source);
+
     /**
      * @brief 关闭数据库连接
+     *
+     * 先销毁所有缓存语句和尚未释放的临时语句，旧连接上的句柄随后失效。
+     * 连接仍被其他对象占用时改用sqlite3_close_v2延后释放
+     * @return 是否已干净地关闭
      */
-    void closeDatabase();
+    bool closeDatabase();
 
     /**
      * @brief 设置数据库密码
@@ -57,6 +342,29 @@ public:
      */
     bool changePassword(const QString &oldPassword, const QString &newPassword);
 
+    /**
+     * @brief 使用原始密钥加密新数据库
+     *
+     * 以"x'...'"形式传给SQLCipher，跳过其内置的口令PBKDF2
+     * @param key 原始密钥（32字节）
+     * @return 是否成功
+     */
+    bool setKey(const QByteArray &key);
+
+    /**
+     * @brief 使用原始密钥打开已有数据库
+     * @param key 原始密钥（32字节）
+     * @return 密钥正确返回true
+     */
+    bool verifyKey(const QByteArray &key);
+
+    /**
+     * @brief 把已设置密钥的数据库重新加密为新的原始密钥
+     * @param key 新的原始密钥（32字节）
+     * @return 是否成功
+     */
+    bool rekey(const QByteArray &key);
+
     /**
      * @brief 执行SQL语句
      * @param sql SQL语句
@@ -71,8 +379,23 @@ public:
      */
     QList<QVariantMap> query(const QString &sql);
 
+    /**
+     * @brief 获取预编译语句
+     *
+     * 按SQL文本缓存sqlite3_stmt，相同SQL的后续调用直接复用已解析的语句。
+     * 若缓存中的语句正被使用（嵌套调用），则返回一个用完即销毁的临时语句。
+     * 可以在工作线程中调用，但返回的语句只能在创建它的线程中使用和销毁。
+     * 注意：不要对包含密钥等敏感内容的SQL使用此接口。
+     * @param sql 带?占位符的SQL语句
+     * @return 语句句柄，失败时isValid()为false
+     */
+    SQLCipherStatement prepare(const QString &sql);
+
     /**
      * @brief 获取最后插入的行ID
+     *
+     * 连接被多个线程共享时可能已被其他语句覆盖，插入后需要行ID时
+     * 应使用SQLCipherStatement::execInsert()
      * @return 行ID
      */
     qint64 lastInsertId() const;
@@ -119,6 +442,36 @@ public:
      */
     bool rollbackTransaction();
 
+    /**
+     * @brief 设置密钥后使用的cipher_page_size，必须与数据库创建时一致
+     * @param pageSize 页大小
+     */
+    void setCipherPageSize(int pageSize);
+
+    /**
+     * @brief 设置并应用性能配置
+     *
+     * 已设置密钥时立即执行配置中的PRAGMA，否则在设置密钥后执行
+     * @param profile 性能配置
+     * @return 所有设置都应用成功返回true
+     */
+    bool applyPerformanceProfile(const PerformanceProfile &profile);
+
+    /**
+     * @brief 使用SQLite在线备份接口把数据库复制到指定文件
+     *
+     * 备份文件使用与当前连接相同的密钥。每步复制pagesPerStep页，步与步之间
+     * 释放连接锁并短暂休眠，其他线程的读写可以继续进行；经由本连接的修改
+     * 会由SQLite同步到备份中，得到的是一致的快照。
+     * 先写入临时文件，完成后再替换目标文件
+     * @param destPath 目标文件路径
+     * @param pagesPerStep 每步复制的页数
+     * @param progress 每步之后调用，参数为已复制页数和总页数，返回false时取消
+     * @return 是否成功
+     */
+    bool backupTo(const QString &destPath, int pagesPerStep,
+                  const std::function<bool(int, int)> &progress = {});
+
 signals:
     /**
      * @brief 数据库错误信号
@@ -132,8 +485,38 @@ private:
     QString m_lastError;              ///< 最后的错误信息
     bool m_isConnected;               ///< 是否已连接
     bool m_isEncrypted;               ///< 是否已加密
+    bool m_readOnly;                  ///< 是否为只读连接（不应用性能配置）
     qint64 m_lastInsertId;            ///< 最后插入的行ID
     int m_affectedRows;               ///< 影响的行数
+    quint64 m_connectionId;           ///< 连接编号，每次关闭后递增
+    QByteArray m_key;                 ///< 当前连接密钥的SQL字面量，用于给备份文件加密，关闭时清零
+    int m_cipherPageSize;             ///< 设置密钥后使用的页大小
+    PerformanceProfile m_profile;     ///< 设置密钥后应用的性能配置
+    QHash<QString, sqlite3_stmt*> m_statementCache;  ///< SQL文本到预编译语句的缓存
+    QSet<sqlite3_stmt*> m_busyStatements;            ///< 正在被句柄占用的缓存语句
+    QSet<sqlite3_stmt*> m_temporaryStatements;       ///< 未进入缓存、尚未释放的临时语句
+    mutable QRecursiveMutex m_mutex;                 ///< 保护语句缓存和执行状态，允许工作线程并发查询
+
+    friend class SQLCipherStatement;
+
+    /**
+     * @brief 归还缓存语句
+     * @param stmt 语句句柄
+     */
+    void releaseCachedStatement(sqlite3_stmt *stmt);
+
+    /**
+     * @brief 销毁所有缓存的预编译语句和临时语句
+     *
+     * 会连同正被句柄占用的语句一起销毁，只能在closeDatabase()中调用，
+     * 此后旧连接的句柄通过连接编号识别，不再归还语句
+     */
+    void clearStatementCache();
+
+    /**
+     * @brief 记录语句执行结果（最后插入ID和影响行数）
+     */
+    void updateExecutionStats();
 
     /**
      * @brief 设置最后的错误信息
@@ -141,6 +524,21 @@ private:
      */
     void setLastError(const QString &error);
 
+    /**
+     * @brief 设置密钥和页大小并检查能否读取数据库
+     * @param keyLiteral 密钥的SQL字面量
+     * @param checkSql 用于检查密钥的语句
+     * @return 是否成功
+     */
+    bool applyKey(const QByteArray &keyLiteral, const QString &checkSql);
+
+    /**
+     * @brief 使用PRAGMA rekey更换密钥
+     * @param keyLiteral 新密钥的SQL字面量
+     * @return 是否成功
+     */
+    bool changeKey(const QByteArray &keyLiteral);
+
     /**
      * @brief 检查SQLCipher版本
      * @return 是否支持SQLCipher
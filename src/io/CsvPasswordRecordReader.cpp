@@ -0,0 +1,228 @@
+#include "CsvPasswordRecordReader.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <vector>
+
+// 每条记录至少包含的字段数：标题、用户名、密码、网址、备注、分类、创建时间、更新时间、收藏
+static const int CSV_FIELD_COUNT = 9;
+
+/**
+ * @brief 清零解析过程中的字段文本
+ *
+ * 只清零没有与记录共享的副本，共享的数据由记录负责擦除
+ * @param fields 字段列表
+ */
+static void wipeFields(QStringList &fields)
+{
+    for (QString &field : fields) {
+        if (field.isDetached()) {
+            field.fill(QChar(u'\0'));
+        }
+    }
+    fields.clear();
+}
+
+/**
+ * @brief 构造函数
+ */
+CsvPasswordRecordReader::CsvPasswordRecordReader() = default;
+
+/**
+ * @brief 析构函数，解除文件映射
+ */
+CsvPasswordRecordReader::~CsvPasswordRecordReader()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+    }
+}
+
+/**
+ * @brief 打开CSV文件并跳过标题行
+ * @param filePath 文件路径
+ * @return 打开成功返回true
+ */
+bool CsvPasswordRecordReader::open(const QString &filePath)
+{
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        setErrorString(QStringLiteral("无法打开CSV文件"));
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size > 0) {
+        m_mapped = m_file.map(0, m_size);
+    }
+    if (m_mapped) {
+        m_data = reinterpret_cast<const char *>(m_mapped);
+    } else {
+        m_fallback = m_file.readAll();
+        m_data = m_fallback.constData();
+        m_size = m_fallback.size();
+    }
+
+    // 跳过UTF-8 BOM和标题行
+    if (m_size >= 3 && qstrncmp(m_data, "\xEF\xBB\xBF", 3) == 0) {
+        m_pos = 3;
+    }
+    const qint64 headerEnd = findRecordEnd(m_pos);
+    if (m_pos >= m_size || headerEnd < 0) {
+        setErrorString(QStringLiteral("CSV文件为空"));
+        return false;
+    }
+    m_pos = qMin(headerEnd + 1, m_size);
+    return true;
+}
+
+/**
+ * @brief 读取下一条记录
+ * @param record 输出的记录
+ * @return 读到记录返回true
+ */
+bool CsvPasswordRecordReader::readNext(PasswordRecord &record)
+{
+    while (m_batchPos >= m_batch.size()) {
+        if (!fillBatch()) {
+            return false;
+        }
+    }
+    record = std::move(m_batch[m_batchPos++]);
+    return true;
+}
+
+/**
+ * @brief 查找记录的结束位置
+ *
+ * 转义的引号（""）会切换两次状态，不影响结果
+ * @param from 记录开始位置
+ * @return 换行符位置，引号未闭合时返回-1
+ */
+qint64 CsvPasswordRecordReader::findRecordEnd(qint64 from) const
+{
+    bool inQuotes = false;
+    for (qint64 i = from; i < m_size; ++i) {
+        const char c = m_data[i];
+        if (c == '"') {
+            inQuotes = !inQuotes;
+        } else if (c == '\n' && !inQuotes) {
+            return i;
+        }
+    }
+    return inQuotes ? -1 : m_size;
+}
+
+/**
+ * @brief 找出下一批记录的边界并并行解析
+ * @return 解析出至少一条记录返回true
+ */
+bool CsvPasswordRecordReader::fillBatch()
+{
+    m_batch.clear();
+    m_batchPos = 0;
+
+    while (m_batch.isEmpty()) {
+        // 记录边界依赖前面的引号状态，只能顺序查找
+        QList<QPair<qint64, qint64>> spans;
+        spans.reserve(BATCH_SIZE);
+        while (spans.size() < BATCH_SIZE && m_pos < m_size) {
+            const qint64 end = findRecordEnd(m_pos);
+            if (end < 0) {
+                setErrorString(QStringLiteral("CSV格式错误（位置%1）：引号未闭合").arg(m_pos));
+                m_pos = m_size;
+                break;
+            }
+            spans.append(qMakePair(m_pos, end));
+            m_pos = qMin(end + 1, m_size);
+        }
+        if (spans.isEmpty()) {
+            return false;
+        }
+
+        // 每条记录的解析互不依赖，分片并行写入预先分配的批次
+        const qsizetype count = spans.size();
+        QList<PasswordRecord> parsed(count);
+        std::vector<char> valid(count, 0);
+        PasswordRecord *out = parsed.data();
+        const char *data = m_data;
+        auto parseSlice = [&spans, &valid, out, data, count](qsizetype first) {
+            const qsizetype last = qMin(first + PARSE_SLICE_SIZE, count);
+            for (qsizetype i = first; i < last; ++i) {
+                const QPair<qint64, qint64> &span = spans.at(i);
+                valid[i] = parseRecord(data + span.first, span.second - span.first, out[i]);
+            }
+        };
+        if (count <= PARSE_SLICE_SIZE) {
+            parseSlice(0);
+        } else {
+            QList<qsizetype> slices;
+            for (qsizetype first = 0; first < count; first += PARSE_SLICE_SIZE) {
+                slices.append(first);
+            }
+            QtConcurrent::blockingMap(slices, parseSlice);
+        }
+
+        m_batch.reserve(count);
+        for (qsizetype i = 0; i < count; ++i) {
+            if (valid[i]) {
+                m_batch.append(std::move(out[i]));
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 解析一条记录
+ *
+ * 引号规则与导出时一致：引号内的逗号和换行属于字段内容，""表示一个引号。
+ * 字段中的CRLF统一转换为LF
+ * @param data 记录内容
+ * @param length 内容长度
+ * @param record 输出的记录
+ * @return 字段数足够时返回true
+ */
+bool CsvPasswordRecordReader::parseRecord(const char *data, qsizetype length, PasswordRecord &record)
+{
+    if (length > 0 && data[length - 1] == '\r') {
+        --length;
+    }
+    if (length == 0) {
+        return false;
+    }
+
+    QStringList fields;
+    fields.reserve(CSV_FIELD_COUNT);
+    QByteArray field;
+    bool inQuotes = false;
+    for (qsizetype i = 0; i < length; ++i) {
+        const char c = data[i];
+        if (c == '"') {
+            if (inQuotes && i + 1 < length && data[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else {
+                inQuotes = !inQuotes;
+            }
+        } else if (c == ',' && !inQuotes) {
+            fields.append(QString::fromUtf8(field));
+            // clear()会释放缓冲区，先清零再释放
+            field.fill('\0');
+            field.clear();
+        } else if (c == '\r' && i + 1 < length && data[i + 1] == '\n') {
+            continue;
+        } else {
+            field += c;
+        }
+    }
+    fields.append(QString::fromUtf8(field));
+    field.fill('\0');
+
+    if (fields.size() < CSV_FIELD_COUNT) {
+        wipeFields(fields);
+        return false;
+    }
+    record = makeRecord(fields[0], fields[1], fields[2], fields[3], fields[4],
+                        fields[5], fields[6], fields[7], fields[8] == QLatin1String("true"));
+    wipeFields(fields);
+    return true;
+}
@@ -0,0 +1,69 @@
+#ifndef CSVPASSWORDRECORDREADER_H
+#define CSVPASSWORDRECORDREADER_H
+
+#include <QFile>
+#include <QByteArray>
+#include "PasswordRecordReader.h"
+
+/**
+ * @brief 从导出的CSV文件中读取密码记录
+ *
+ * 文件以内存映射方式读取（映射失败时退回一次性读入）。记录边界按引号状态
+ * 查找，引号内的换行属于字段内容，多行备注不会被拆成多行。
+ * 每次顺序找出BATCH_SIZE条记录的边界后，把这些记录分片交给线程池并行解析，
+ * 结果写入预先分配好的批次中，导入时逐条取出。进度以字节为单位。
+ */
+class CsvPasswordRecordReader : public PasswordRecordReader
+{
+public:
+    static constexpr int BATCH_SIZE = 4096;        // 每批解析的记录数
+    static constexpr int PARSE_SLICE_SIZE = 256;   // 每个并行任务解析的记录数
+
+    CsvPasswordRecordReader();
+    ~CsvPasswordRecordReader() override;
+
+    /**
+     * @brief 打开CSV文件并跳过标题行
+     * @param filePath 文件路径
+     * @return 打开成功返回true，失败时可通过errorString()获取原因
+     */
+    bool open(const QString &filePath);
+
+    bool readNext(PasswordRecord &record) override;
+    qint64 progressValue() const override { return m_pos; }
+    qint64 progressMaximum() const override { return m_size; }
+
+private:
+    QFile m_file;                    // 输入文件
+    uchar *m_mapped = nullptr;       // 映射的文件内容
+    QByteArray m_fallback;           // 无法映射时一次性读入的内容
+    const char *m_data = nullptr;    // 文件内容
+    qint64 m_size = 0;               // 文件大小
+    qint64 m_pos = 0;                // 下一条记录的开始位置
+    QList<PasswordRecord> m_batch;   // 已解析的记录
+    qsizetype m_batchPos = 0;        // 下一条要返回的记录
+
+    /**
+     * @brief 查找记录的结束位置（不在引号内的换行符）
+     * @param from 记录开始位置
+     * @return 换行符位置，最后一条记录没有换行符时返回文件大小；引号未闭合时返回-1
+     */
+    qint64 findRecordEnd(qint64 from) const;
+
+    /**
+     * @brief 找出下一批记录的边界并并行解析
+     * @return 解析出至少一条记录返回true，文件结束或出错返回false
+     */
+    bool fillBatch();
+
+    /**
+     * @brief 解析一条记录
+     * @param data 记录内容（不含结尾换行符）
+     * @param length 内容长度
+     * @param record 输出的记录
+     * @return 字段数足够时返回true，空行或字段不足返回false
+     */
+    static bool parseRecord(const char *data, qsizetype length, PasswordRecord &record);
+};
+
+#endif // CSVPASSWORDRECORDREADER_H
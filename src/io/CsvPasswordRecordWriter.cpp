@@ -0,0 +1,55 @@
+#include "CsvPasswordRecordWriter.h"
+
+/**
+ * @brief 写入一条记录
+ * @param record 已解密的记录
+ * @return 写入成功返回true
+ */
+bool CsvPasswordRecordWriter::writeRecord(const PasswordRecord &record)
+{
+    m_stream << escapeField(record.title) << ','
+             << escapeField(secret(record.username)) << ','
+             << escapeField(secret(record.password)) << ','
+             << escapeField(record.website) << ','
+             << escapeField(secret(record.notes)) << ','
+             << escapeField(record.category) << ','
+             << formatTimestamp(record.createdAt) << ','
+             << formatTimestamp(record.updatedAt) << ','
+             << (record.isFavorite ? "true" : "false") << '\n';
+    return m_stream.status() == QTextStream::Ok;
+}
+
+/**
+ * @brief 写入标题行
+ * @return 成功返回true
+ */
+bool CsvPasswordRecordWriter::writeHeader()
+{
+    m_stream.setDevice(&m_file);
+    m_stream.setEncoding(QStringConverter::Utf8);
+    m_stream << "Title,Username,Password,Website,Notes,Category,Created At,Updated At,Is Favorite\n";
+    return m_stream.status() == QTextStream::Ok;
+}
+
+/**
+ * @brief 把缓冲中的内容写入文件
+ * @return 成功返回true
+ */
+bool CsvPasswordRecordWriter::writeFooter()
+{
+    m_stream.flush();
+    return m_stream.status() == QTextStream::Ok;
+}
+
+/**
+ * @brief 按CSV规则转义字段
+ * @param field 字段内容
+ * @return 转义后的字段
+ */
+QString CsvPasswordRecordWriter::escapeField(QString field)
+{
+    if (field.contains(',') || field.contains('"') || field.contains('\n')) {
+        field = '"' + field.replace('"', QLatin1String("\"\"")) + '"';
+    }
+    return field;
+}
@@ -0,0 +1,35 @@
+#ifndef CSVPASSWORDRECORDWRITER_H
+#define CSVPASSWORDRECORDWRITER_H
+
+#include <QTextStream>
+#include "PasswordRecordWriter.h"
+
+/**
+ * @brief 逐条写出CSV格式的导出文件
+ *
+ * 包含逗号、引号或换行的字段用引号包围，引号写成两个引号。
+ */
+class CsvPasswordRecordWriter : public PasswordRecordWriter
+{
+public:
+    using PasswordRecordWriter::PasswordRecordWriter;
+
+    bool writeRecord(const PasswordRecord &record) override;
+
+protected:
+    QIODevice::OpenMode openMode() const override { return QIODevice::WriteOnly | QIODevice::Text; }
+    bool writeHeader() override;
+    bool writeFooter() override;
+
+private:
+    QTextStream m_stream;   // 带缓冲的UTF-8文本流
+
+    /**
+     * @brief 按CSV规则转义字段
+     * @param field 字段内容
+     * @return 转义后的字段
+     */
+    static QString escapeField(QString field);
+};
+
+#endif // CSVPASSWORDRECORDWRITER_H
@@ -0,0 +1,182 @@
+#include "JsonArrayReader.h"
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+/**
+ * @brief 检查是否为JSON空白字符
+ */
+static bool isJsonWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * @brief 构造函数
+ * @param device 已打开的输入设备
+ */
+JsonArrayReader::JsonArrayReader(QIODevice *device)
+    : m_device(device)
+{
+}
+
+/**
+ * @brief 读取数组中的下一个对象
+ * @param object 输出的对象
+ * @return 读到对象返回true
+ */
+bool JsonArrayReader::readNext(QJsonObject &object)
+{
+    while (!m_finished && !hasError()) {
+        if (!skipWhitespace()) {
+            m_errorString = m_started ? QStringLiteral("JSON数组不完整") : QStringLiteral("JSON格式错误");
+            return false;
+        }
+
+        const char c = m_buffer.at(m_pos);
+        if (!m_started) {
+            if (c != '[') {
+                m_errorString = QStringLiteral("JSON格式错误");
+                return false;
+            }
+            m_started = true;
+            ++m_pos;
+            continue;
+        }
+        if (c == ']') {
+            m_finished = true;
+            ++m_pos;
+            break;
+        }
+        if (c == ',') {
+            ++m_pos;
+            continue;
+        }
+
+        const qsizetype end = scanElement();
+        if (end < 0) {
+            return false;
+        }
+        if (c != '{') {
+            // 与整体解析时一样，忽略不是对象的元素
+            m_pos = end;
+            continue;
+        }
+
+        QJsonParseError parseError;
+        const QJsonDocument doc = QJsonDocument::fromJson(
+            QByteArray::fromRawData(m_buffer.constData() + m_pos, end - m_pos), &parseError);
+        if (parseError.error != QJsonParseError::NoError) {
+            m_errorString = QStringLiteral("JSON格式错误（位置%1）：%2")
+                                .arg(bytesConsumed() + parseError.offset)
+                                .arg(parseError.errorString());
+            return false;
+        }
+        m_pos = end;
+        object = doc.object();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 丢弃已处理的数据并从设备读取下一块
+ * @return 读到新数据返回true
+ */
+bool JsonArrayReader::fill()
+{
+    if (m_pos > 0) {
+        m_buffer.remove(0, m_pos);
+        m_consumed += m_pos;
+        m_pos = 0;
+    }
+
+    const QByteArray chunk = m_device->read(READ_CHUNK_SIZE);
+    if (chunk.isEmpty()) {
+        return false;
+    }
+    m_buffer.append(chunk);
+
+    // 跳过文件开头的UTF-8 BOM
+    if (m_consumed == 0 && !m_started && m_buffer.startsWith("\xEF\xBB\xBF")) {
+        m_pos = 3;
+    }
+    return true;
+}
+
+/**
+ * @brief 跳过空白字符
+ * @return 还有数据返回true
+ */
+bool JsonArrayReader::skipWhitespace()
+{
+    for (;;) {
+        while (m_pos < m_buffer.size()) {
+            if (!isJsonWhitespace(m_buffer.at(m_pos))) {
+                return true;
+            }
+            ++m_pos;
+        }
+        if (!fill()) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief 查找当前元素的结束位置
+ *
+ * 只跟踪字符串、转义和括号深度，不做完整的语法检查，
+ * 元素内部的语法错误由随后的QJsonDocument::fromJson报告。
+ * 扫描位置相对于元素开头保存，读取更多数据时缓冲区前移不影响扫描。
+ * @return 元素结束位置（不含），出错时返回-1
+ */
+qsizetype JsonArrayReader::scanElement()
+{
+    const char first = m_buffer.at(m_pos);
+    const bool scalar = first != '{' && first != '[' && first != '"';
+    qsizetype offset = 0;
+    int depth = 0;
+    bool inString = false;
+    bool escape = false;
+
+    for (;;) {
+        while (m_pos + offset < m_buffer.size()) {
+            const char c = m_buffer.at(m_pos + offset);
+            if (inString) {
+                if (escape) {
+                    escape = false;
+                } else if (c == '\\') {
+                    escape = true;
+                } else if (c == '"') {
+                    inString = false;
+                    if (depth == 0) {
+                        return m_pos + offset + 1;
+                    }
+                }
+            } else if (scalar) {
+                if (c == ',' || c == ']' || isJsonWhitespace(c)) {
+                    return m_pos + offset;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return m_pos + offset + 1;
+                }
+            }
+            ++offset;
+        }
+
+        if (offset > MAX_ELEMENT_SIZE) {
+            m_errorString = QStringLiteral("JSON条目过大（位置%1）").arg(bytesConsumed());
+            return -1;
+        }
+        if (!fill()) {
+            m_errorString = QStringLiteral("JSON数组不完整");
+            return -1;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef JSONARRAYREADER_H
+#define JSONARRAYREADER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QJsonObject>
+
+class QIODevice;
+
+/**
+ * @brief 流式读取顶层为数组的JSON文件
+ *
+ * 按固定大小分块从设备读取，只扫描出当前元素的边界再交给QJsonDocument
+ * 解析，缓冲区中只保留尚未处理的数据，内存占用取决于单个元素的大小而不是
+ * 整个文件。数组中不是对象的元素会被忽略。
+ */
+class JsonArrayReader
+{
+public:
+    static constexpr qsizetype READ_CHUNK_SIZE = 64 * 1024;          // 每次从设备读取的字节数
+    static constexpr qsizetype MAX_ELEMENT_SIZE = 16 * 1024 * 1024;  // 单个元素的最大字节数
+
+    /**
+     * @brief 构造函数
+     * @param device 已打开的输入设备，生命周期由调用方管理
+     */
+    explicit JsonArrayReader(QIODevice *device);
+
+    /**
+     * @brief 读取数组中的下一个对象
+     * @param object 输出的对象
+     * @return 读到对象返回true，数组结束或出错返回false
+     */
+    bool readNext(QJsonObject &object);
+
+    /**
+     * @brief 检查是否已读到数组末尾
+     * @return 已结束返回true
+     */
+    bool atEnd() const { return m_finished; }
+
+    /**
+     * @brief 检查读取过程中是否出错
+     * @return 出错返回true
+     */
+    bool hasError() const { return !m_errorString.isEmpty(); }
+
+    /**
+     * @brief 获取错误信息
+     * @return 错误信息，没有错误时为空
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief 已处理的字节数
+     * @return 从设备开头算起已经解析完的字节数
+     */
+    qint64 bytesConsumed() const { return m_consumed + m_pos; }
+
+private:
+    QIODevice *m_device;        // 输入设备
+    QByteArray m_buffer;        // 尚未处理完的数据
+    qsizetype m_pos = 0;        // 缓冲区中的当前位置
+    qint64 m_consumed = 0;      // 已从缓冲区丢弃的字节数
+    bool m_started = false;     // 是否已读到数组开头
+    bool m_finished = false;    // 是否已读到数组末尾
+    QString m_errorString;      // 错误信息
+
+    /**
+     * @brief 丢弃已处理的数据并从设备读取下一块
+     * @return 读到新数据返回true
+     */
+    bool fill();
+
+    /**
+     * @brief 跳过空白字符，必要时读取更多数据
+     * @return 还有数据返回true，已到设备末尾返回false
+     */
+    bool skipWhitespace();
+
+    /**
+     * @brief 查找从当前位置开始的元素的结束位置，必要时读取更多数据
+     * @return 元素结束位置（不含），出错时返回-1
+     */
+    qsizetype scanElement();
+};
+
+#endif // JSONARRAYREADER_H
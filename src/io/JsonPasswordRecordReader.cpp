@@ -0,0 +1,51 @@
+#include "JsonPasswordRecordReader.h"
+
+/**
+ * @brief 构造函数
+ */
+JsonPasswordRecordReader::JsonPasswordRecordReader()
+    : m_json(&m_file)
+{
+}
+
+/**
+ * @brief 打开JSON文件
+ * @param filePath 文件路径
+ * @return 打开成功返回true
+ */
+bool JsonPasswordRecordReader::open(const QString &filePath)
+{
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        setErrorString(QStringLiteral("无法打开JSON文件"));
+        return false;
+    }
+    m_size = m_file.size();
+    return true;
+}
+
+/**
+ * @brief 读取下一条记录
+ * @param record 输出的记录
+ * @return 读到记录返回true
+ */
+bool JsonPasswordRecordReader::readNext(PasswordRecord &record)
+{
+    QJsonObject obj;
+    if (!m_json.readNext(obj)) {
+        if (m_json.hasError()) {
+            setErrorString(m_json.errorString());
+        }
+        return false;
+    }
+    record = makeRecord(obj["title"].toString(),
+                        obj["username"].toString(),
+                        obj["password"].toString(),
+                        obj["website"].toString(),
+                        obj["notes"].toString(),
+                        obj["category"].toString(),
+                        obj["created_at"].toString(),
+                        obj["updated_at"].toString(),
+                        obj["is_favorite"].toBool());
+    return true;
+}
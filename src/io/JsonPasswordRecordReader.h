@@ -0,0 +1,36 @@
+#ifndef JSONPASSWORDRECORDREADER_H
+#define JSONPASSWORDRECORDREADER_H
+
+#include <QFile>
+#include "PasswordRecordReader.h"
+#include "JsonArrayReader.h"
+
+/**
+ * @brief 从导出的JSON文件中逐条读取密码记录
+ *
+ * 文件由JsonArrayReader分块读取，每次只解析一个条目，
+ * 导入几百MB的文件时内存占用也保持不变。进度以字节为单位。
+ */
+class JsonPasswordRecordReader : public PasswordRecordReader
+{
+public:
+    JsonPasswordRecordReader();
+
+    /**
+     * @brief 打开JSON文件
+     * @param filePath 文件路径
+     * @return 打开成功返回true，失败时可通过errorString()获取原因
+     */
+    bool open(const QString &filePath);
+
+    bool readNext(PasswordRecord &record) override;
+    qint64 progressValue() const override { return m_json.bytesConsumed(); }
+    qint64 progressMaximum() const override { return m_size; }
+
+private:
+    QFile m_file;            // 输入文件
+    JsonArrayReader m_json;  // 流式数组读取器
+    qint64 m_size = 0;       // 文件大小
+};
+
+#endif // JSONPASSWORDRECORDREADER_H
@@ -0,0 +1,52 @@
+#include "JsonPasswordRecordWriter.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+
+/**
+ * @brief 写入一条记录
+ * @param record 已解密的记录
+ * @return 写入成功返回true
+ */
+bool JsonPasswordRecordWriter::writeRecord(const PasswordRecord &record)
+{
+    QJsonObject jsonItem;
+    jsonItem["title"] = record.title;
+    jsonItem["username"] = secret(record.username);
+    jsonItem["password"] = secret(record.password);
+    jsonItem["website"] = record.website;
+    jsonItem["notes"] = secret(record.notes);
+    jsonItem["category"] = record.category;
+    jsonItem["created_at"] = formatTimestamp(record.createdAt);
+    jsonItem["updated_at"] = formatTimestamp(record.updatedAt);
+    jsonItem["is_favorite"] = record.isFavorite;
+
+    // 单独序列化的对象缩进少一级，字符串中的换行已被转义，可以按行补齐缩进
+    QByteArray json = QJsonDocument(jsonItem).toJson(QJsonDocument::Indented);
+    json.chop(1);
+    json.replace("\n", "\n    ");
+    json.prepend(m_count > 0 ? ",\n    " : "    ");
+    ++m_count;
+
+    const bool ok = m_file.write(json) == json.size();
+    json.fill('\0');
+    return ok;
+}
+
+/**
+ * @brief 写入数组开头
+ * @return 成功返回true
+ */
+bool JsonPasswordRecordWriter::writeHeader()
+{
+    return m_file.write("[\n") == 2;
+}
+
+/**
+ * @brief 写入数组结尾
+ * @return 成功返回true
+ */
+bool JsonPasswordRecordWriter::writeFooter()
+{
+    const QByteArray footer = m_count > 0 ? QByteArrayLiteral("\n]\n") : QByteArrayLiteral("]\n");
+    return m_file.write(footer) == footer.size();
+}
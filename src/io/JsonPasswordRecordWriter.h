@@ -0,0 +1,27 @@
+#ifndef JSONPASSWORDRECORDWRITER_H
+#define JSONPASSWORDRECORDWRITER_H
+
+#include "PasswordRecordWriter.h"
+
+/**
+ * @brief 逐条写出JSON格式的导出文件
+ *
+ * 每条记录单独序列化后按数组元素的缩进写出，
+ * 生成的文件与QJsonDocument整体序列化的结果逐字节相同。
+ */
+class JsonPasswordRecordWriter : public PasswordRecordWriter
+{
+public:
+    using PasswordRecordWriter::PasswordRecordWriter;
+
+    bool writeRecord(const PasswordRecord &record) override;
+
+protected:
+    bool writeHeader() override;
+    bool writeFooter() override;
+
+private:
+    qsizetype m_count = 0;   // 已写出的记录数
+};
+
+#endif // JSONPASSWORDRECORDWRITER_H
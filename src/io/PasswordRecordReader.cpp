@@ -0,0 +1,51 @@
+#include "PasswordRecordReader.h"
+#include <QDateTime>
+
+/**
+ * @brief 由导入文件中的字段构造密码记录
+ * @return 敏感字段为明文的密码记录
+ */
+PasswordRecord PasswordRecordReader::makeRecord(const QString &title, const QString &username,
+                                                const QString &password, const QString &website,
+                                                const QString &notes, const QString &category,
+                                                const QString &createdAt, const QString &updatedAt,
+                                                bool isFavorite)
+{
+    PasswordRecord record;
+    record.title = title;
+    record.username.setPlaintext(username);
+    record.password.setPlaintext(password);
+    record.website = website;
+    record.notes.setPlaintext(notes);
+    record.category = category;
+    // 无法解析的时间保存为0，写入时使用当前时间
+    const QDateTime created = QDateTime::fromString(createdAt, Qt::ISODate);
+    const QDateTime updated = QDateTime::fromString(updatedAt, Qt::ISODate);
+    record.createdAt = created.isValid() ? created.toMSecsSinceEpoch() : 0;
+    record.updatedAt = updated.isValid() ? updated.toMSecsSinceEpoch() : 0;
+    record.isFavorite = isFavorite;
+    return record;
+}
+
+/**
+ * @brief 构造函数
+ * @param records 待导入的记录
+ */
+PasswordRecordListReader::PasswordRecordListReader(QList<PasswordRecord> records)
+    : m_records(std::move(records))
+{
+}
+
+/**
+ * @brief 读取下一条记录，读出的记录从列表中移走
+ * @param record 输出的记录
+ * @return 读到记录返回true
+ */
+bool PasswordRecordListReader::readNext(PasswordRecord &record)
+{
+    if (m_position >= m_records.size()) {
+        return false;
+    }
+    record = std::move(m_records[m_position++]);
+    return true;
+}
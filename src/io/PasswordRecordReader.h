@@ -0,0 +1,85 @@
+#ifndef PASSWORDRECORDREADER_H
+#define PASSWORDRECORDREADER_H
+
+#include <QString>
+#include <QList>
+#include "models/PasswordRecord.h"
+
+/**
+ * @brief 导入数据源的抽象接口
+ *
+ * 导入时由DatabaseManager在数据库线程中逐条读取记录并分批写入，
+ * 数据源只需保留当前读取位置附近的数据，内存占用与文件大小无关。
+ * 进度以数据源自己的单位表示（条目数或字节数），界面只使用比例。
+ */
+class PasswordRecordReader
+{
+public:
+    virtual ~PasswordRecordReader() = default;
+
+    /**
+     * @brief 读取下一条记录
+     * @param record 输出的记录，敏感字段为明文
+     * @return 读到记录返回true，结束或出错返回false
+     */
+    virtual bool readNext(PasswordRecord &record) = 0;
+
+    /**
+     * @brief 当前进度
+     * @return 已处理的数量
+     */
+    virtual qint64 progressValue() const = 0;
+
+    /**
+     * @brief 进度总量
+     * @return 总数量
+     */
+    virtual qint64 progressMaximum() const = 0;
+
+    /**
+     * @brief 检查读取过程中是否出错
+     * @return 出错返回true
+     */
+    bool hasError() const { return !m_errorString.isEmpty(); }
+
+    /**
+     * @brief 获取错误信息
+     * @return 错误信息，没有错误时为空
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief 由导入文件中的字段构造密码记录
+     * @return 敏感字段为明文的密码记录，无法解析的时间保存为0
+     */
+    static PasswordRecord makeRecord(const QString &title, const QString &username,
+                                     const QString &password, const QString &website,
+                                     const QString &notes, const QString &category,
+                                     const QString &createdAt, const QString &updatedAt,
+                                     bool isFavorite);
+
+protected:
+    void setErrorString(const QString &error) { m_errorString = error; }
+
+private:
+    QString m_errorString;   // 错误信息
+};
+
+/**
+ * @brief 以内存中的记录列表作为导入数据源
+ */
+class PasswordRecordListReader : public PasswordRecordReader
+{
+public:
+    explicit PasswordRecordListReader(QList<PasswordRecord> records);
+
+    bool readNext(PasswordRecord &record) override;
+    qint64 progressValue() const override { return m_position; }
+    qint64 progressMaximum() const override { return m_records.size(); }
+
+private:
+    QList<PasswordRecord> m_records;   // 待导入的记录
+    qsizetype m_position = 0;          // 下一条记录的位置
+};
+
+#endif // PASSWORDRECORDREADER_H
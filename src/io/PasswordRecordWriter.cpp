@@ -0,0 +1,65 @@
+#include "PasswordRecordWriter.h"
+#include <QDateTime>
+
+/**
+ * @brief 构造函数
+ * @param includeSecrets 是否写出敏感字段
+ */
+PasswordRecordWriter::PasswordRecordWriter(bool includeSecrets)
+    : m_includeSecrets(includeSecrets)
+{
+}
+
+/**
+ * @brief 打开导出文件并写入文件头
+ * @param filePath 文件路径
+ * @return 成功返回true
+ */
+bool PasswordRecordWriter::open(const QString &filePath)
+{
+    m_file.setFileName(filePath);
+    if (!m_file.open(openMode())) {
+        setErrorString(m_file.errorString());
+        return false;
+    }
+    if (!writeHeader()) {
+        setErrorString(m_file.errorString());
+        m_file.cancelWriting();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 写入文件尾并提交文件
+ * @return 成功返回true
+ */
+bool PasswordRecordWriter::finish()
+{
+    if (!writeFooter() || !m_file.commit()) {
+        setErrorString(m_file.errorString());
+        m_file.cancelWriting();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 获取要写出的敏感字段内容
+ * @param field 敏感字段
+ * @return 明文或空字符串
+ */
+QString PasswordRecordWriter::secret(const EncryptedField &field) const
+{
+    return m_includeSecrets ? field.plaintext() : QString();
+}
+
+/**
+ * @brief 将毫秒时间戳格式化为时间字符串
+ * @param msecs 毫秒时间戳
+ * @return ISO格式时间字符串
+ */
+QString PasswordRecordWriter::formatTimestamp(qint64 msecs)
+{
+    return QDateTime::fromMSecsSinceEpoch(msecs).toString(Qt::ISODate);
+}
@@ -0,0 +1,101 @@
+#ifndef PASSWORDRECORDWRITER_H
+#define PASSWORDRECORDWRITER_H
+
+#include <QSaveFile>
+#include <QString>
+#include "models/PasswordRecord.h"
+
+/**
+ * @brief 导出文件写入器的基类
+ *
+ * 导出时由DatabaseManager在数据库线程中逐条提供已解密的记录，
+ * 写入器立即把它写到文件，不在内存中保留整个密码库。
+ * 文件先写到临时文件，finish()成功后才替换目标文件，失败时不会留下半个文件。
+ */
+class PasswordRecordWriter
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param includeSecrets 是否写出用户名、密码和备注
+     */
+    explicit PasswordRecordWriter(bool includeSecrets);
+    virtual ~PasswordRecordWriter() = default;
+
+    PasswordRecordWriter(const PasswordRecordWriter &) = delete;
+    PasswordRecordWriter &operator=(const PasswordRecordWriter &) = delete;
+
+    /**
+     * @brief 打开导出文件并写入文件头
+     * @param filePath 文件路径
+     * @return 成功返回true，失败时可通过errorString()获取原因
+     */
+    bool open(const QString &filePath);
+
+    /**
+     * @brief 写入一条记录
+     * @param record 已解密的记录
+     * @return 写入成功返回true
+     */
+    virtual bool writeRecord(const PasswordRecord &record) = 0;
+
+    /**
+     * @brief 写入文件尾并提交文件
+     * @return 成功返回true
+     */
+    bool finish();
+
+    /**
+     * @brief 是否写出敏感字段
+     * @return 写出用户名、密码和备注时返回true
+     */
+    bool includesSecrets() const { return m_includeSecrets; }
+
+    /**
+     * @brief 获取错误信息
+     * @return 错误信息，没有错误时为空
+     */
+    QString errorString() const { return m_errorString; }
+
+protected:
+    QSaveFile m_file;          // 导出文件
+    bool m_includeSecrets;     // 是否写出敏感字段
+
+    /**
+     * @brief 打开文件使用的模式
+     */
+    virtual QIODevice::OpenMode openMode() const { return QIODevice::WriteOnly; }
+
+    /**
+     * @brief 写入文件头
+     * @return 成功返回true
+     */
+    virtual bool writeHeader() = 0;
+
+    /**
+     * @brief 写入文件尾并刷新缓冲
+     * @return 成功返回true
+     */
+    virtual bool writeFooter() = 0;
+
+    /**
+     * @brief 获取要写出的敏感字段内容，不包含敏感字段时为空
+     * @param field 敏感字段
+     * @return 明文或空字符串
+     */
+    QString secret(const EncryptedField &field) const;
+
+    /**
+     * @brief 将毫秒时间戳格式化为导出文件中使用的时间字符串
+     * @param msecs 毫秒时间戳
+     * @return ISO格式时间字符串
+     */
+    static QString formatTimestamp(qint64 msecs);
+
+    void setErrorString(const QString &error) { m_errorString = error; }
+
+private:
+    QString m_errorString;   // 错误信息
+};
+
+#endif // PASSWORDRECORDWRITER_H
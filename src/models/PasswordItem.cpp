@@ -3,6 +3,20 @@
 #include <QRandomGenerator>
 #include <QUrl>
 #include <QDebug>
+#include "crypto/CryptoManager.h"
+
+// PasswordItem实现
+
+/**
+ * @brief 比较两个敏感字段是否相同，存在密文时只比较密文，避免触发解密
+ */
+static bool sameSecret(const EncryptedField &a, const EncryptedField &b)
+{
+    if (!a.ciphertext().isEmpty() || !b.ciphertext().isEmpty()) {
+        return a.ciphertext() == b.ciphertext();
+    }
+    return a.plaintext() == b.plaintext();
+}
 
 /**
  * @brief 默认构造函数
@@ -10,12 +24,10 @@
  */
 PasswordItem::PasswordItem(QObject *parent)
     : QObject(parent)
-    , m_id(-1)
-    , m_isFavorite(false)
 {
     // 设置创建时间和更新时间为当前时间
-    m_createdAt = QDateTime::currentDateTime();
-    m_updatedAt = m_createdAt;
+    m_record.createdAt = QDateTime::currentMSecsSinceEpoch();
+    m_record.updatedAt = m_record.createdAt;
 }
 
 /**
@@ -36,43 +48,64 @@ PasswordItem::PasswordItem(const QString &title,
                           const QString &category,
                           QObject *parent)
     : QObject(parent)
-    , m_id(-1)
-    , m_title(title)
-    , m_username(username)
-    , m_password(password)
-    , m_website(website)
-    , m_notes(notes)
-    , m_category(category)
-    , m_isFavorite(false)
 {
+    m_record.title = title;
+    m_record.username.setPlaintext(username);
+    m_record.password.setPlaintext(password);
+    m_record.website = website;
+    m_record.notes.setPlaintext(notes);
+    m_record.category = category;
+
     // 设置创建时间和更新时间为当前时间
-    m_createdAt = QDateTime::currentDateTime();
-    m_updatedAt = m_createdAt;
+    m_record.createdAt = QDateTime::currentMSecsSinceEpoch();
+    m_record.updatedAt = m_record.createdAt;
+}
+
+/**
+ * @brief 用记录替换全部字段
+ * @param record 新的记录
+ */
+void PasswordItem::setRecord(const PasswordRecord &record)
+{
+    const PasswordRecord old = m_record;
+    m_record = record;
+
+    if (old.id != record.id) emit idChanged();
+    if (old.title != record.title) emit titleChanged();
+    if (!sameSecret(old.username, record.username)) emit usernameChanged();
+    if (!sameSecret(old.password, record.password)) emit passwordChanged();
+    if (old.website != record.website) emit websiteChanged();
+    if (!sameSecret(old.notes, record.notes)) emit notesChanged();
+    if (old.category != record.category) emit categoryChanged();
+    if (old.createdAt != record.createdAt) emit createdAtChanged();
+    if (old.updatedAt != record.updatedAt) emit updatedAtChanged();
+    if (old.isFavorite != record.isFavorite) emit isFavoriteChanged();
 }
 
 // Setter方法的实现
 
 void PasswordItem::setId(int id)
 {
-    if (m_id != id) {
-        m_id = id;
+    if (m_record.id != id) {
+        m_record.id = id;
         emit idChanged();
     }
 }
 
 void PasswordItem::setTitle(const QString &title)
 {
-    if (m_title != title) {
-        m_title = title;
+    if (m_record.title != title) {
+        m_record.title = title;
         updateTimestamp();
         emit titleChanged();
     }
 }
 
+// 敏感字段的setter用hasPlaintext()比较，尚未解密的字段直接视为变化，不为比较而解密
 void PasswordItem::setUsername(const QString &username)
 {
-    if (m_username != username) {
-        m_username = username;
+    if (!m_record.username.hasPlaintext(username)) {
+        m_record.username.setPlaintext(username);
         updateTimestamp();
         emit usernameChanged();
     }
@@ -80,8 +113,8 @@ void PasswordItem::setUsername(const QString &username)
 
 void PasswordItem::setPassword(const QString &password)
 {
-    if (m_password != password) {
-        m_password = password;
+    if (!m_record.password.hasPlaintext(password)) {
+        m_record.password.setPlaintext(password);
         updateTimestamp();
         emit passwordChanged();
     }
@@ -89,8 +122,8 @@ void PasswordItem::setPassword(const QString &password)
 
 void PasswordItem::setWebsite(const QString &website)
 {
-    if (m_website != website) {
-        m_website = website;
+    if (m_record.website != website) {
+        m_record.website = website;
         updateTimestamp();
         emit websiteChanged();
     }
@@ -98,8 +131,8 @@ void PasswordItem::setWebsite(const QString &website)
 
 void PasswordItem::setNotes(const QString &notes)
 {
-    if (m_notes != notes) {
-        m_notes = notes;
+    if (!m_record.notes.hasPlaintext(notes)) {
+        m_record.notes.setPlaintext(notes);
         updateTimestamp();
         emit notesChanged();
     }
@@ -107,8 +140,8 @@ void PasswordItem::setNotes(const QString &notes)
 
 void PasswordItem::setCategory(const QString &category)
 {
-    if (m_category != category) {
-        m_category = category;
+    if (m_record.category != category) {
+        m_record.category = category;
         updateTimestamp();
         emit categoryChanged();
     }
@@ -116,36 +149,82 @@ void PasswordItem::setCategory(const QString &category)
 
 void PasswordItem::setCreatedAt(const QDateTime &dateTime)
 {
-    if (m_createdAt != dateTime) {
-        m_createdAt = dateTime;
+    const qint64 msecs = dateTime.toMSecsSinceEpoch();
+    if (m_record.createdAt != msecs) {
+        m_record.createdAt = msecs;
         emit createdAtChanged();
     }
 }
 
 void PasswordItem::setUpdatedAt(const QDateTime &dateTime)
 {
-    if (m_updatedAt != dateTime) {
-        m_updatedAt = dateTime;
+    const qint64 msecs = dateTime.toMSecsSinceEpoch();
+    if (m_record.updatedAt != msecs) {
+        m_record.updatedAt = msecs;
         emit updatedAtChanged();
     }
 }
 
 void PasswordItem::setIsFavorite(bool favorite)
 {
-    if (m_isFavorite != favorite) {
-        m_isFavorite = favorite;
+    if (m_record.isFavorite != favorite) {
+        m_record.isFavorite = favorite;
         updateTimestamp();
         emit isFavoriteChanged();
     }
 }
 
+/**
+ * @brief 设置敏感字段的密文（从数据库加载时使用）
+ * @param username 用户名密文
+ * @param password 密码密文
+ * @param notes 备注密文
+ */
+void PasswordItem::setEncryptedFields(const QByteArray &username, const QByteArray &password, const QByteArray &notes)
+{
+    m_record.username.setCiphertext(username);
+    m_record.password.setCiphertext(password);
+    m_record.notes.setCiphertext(notes);
+    emit usernameChanged();
+    emit passwordChanged();
+    emit notesChanged();
+}
+
+/**
+ * @brief 获取尚未解密的敏感字段
+ * @return 字段指针列表
+ */
+QList<EncryptedField*> PasswordItem::pendingSecretFields()
+{
+    return m_record.pendingSecretFields();
+}
+
+/**
+ * @brief 获取参与搜索的尚未解密字段
+ * @return 字段指针列表
+ */
+QList<EncryptedField*> PasswordItem::pendingSearchableFields()
+{
+    return m_record.pendingSearchableFields();
+}
+
+/**
+ * @brief 清除内存中已解密的用户名、密码和备注
+ *
+ * 只影响从数据库加载、仍保留密文的字段，之后读取时会重新解密
+ */
+void PasswordItem::wipeSecrets()
+{
+    m_record.wipeSecrets();
+}
+
 /**
  * @brief 验证密码项目数据是否有效
  * @return 如果标题和密码非空则返回true
  */
 bool PasswordItem::isValid() const
 {
-    return !m_title.trimmed().isEmpty() && !m_password.isEmpty();
+    return !m_record.title.trimmed().isEmpty() && !password().isEmpty();
 }
 
 /**
@@ -173,11 +252,11 @@ bool PasswordItem::matchesSearchTerm(const QString &searchTerm) const
     }
     
     QString term = searchTerm.toLower();
-    return m_title.toLower().contains(term) ||
-           m_username.toLower().contains(term) ||
-           m_website.toLower().contains(term) ||
-           m_notes.toLower().contains(term) ||
-           m_category.toLower().contains(term);
+    return m_record.title.toLower().contains(term) ||
+           username().toLower().contains(term) ||
+           m_record.website.toLower().contains(term) ||
+           notes().toLower().contains(term) ||
+           m_record.category.toLower().contains(term);
 }
 
 /**
@@ -186,11 +265,11 @@ bool PasswordItem::matchesSearchTerm(const QString &searchTerm) const
  */
 QUrl PasswordItem::getWebsiteUrl() const
 {
-    if (m_website.isEmpty()) {
+    if (m_record.website.isEmpty()) {
         return QUrl();
     }
     
-    QString url = m_website;
+    QString url = m_record.website;
     // 如果URL不包含协议，添加https://
     if (!url.startsWith("http://") && !url.startsWith("https://")) {
         url.prepend("https://");
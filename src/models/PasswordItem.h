@@ -5,12 +5,14 @@
 #include <QString>
 #include <QDateTime>
 #include <QUrl>
+#include "PasswordRecord.h"
 
 /**
  * @brief 密码项目数据模型类
  * 
  * 用于表示单个密码条目的数据结构，包含所有必要的字段
  * 支持增删改查操作和数据验证
+ * 数据保存在内部的PasswordRecord中，列表模型只在QML需要编辑时才创建本对象
  */
 class PasswordItem : public QObject
 {
@@ -41,16 +43,28 @@ public:
                 QObject *parent = nullptr);
 
     // Getter方法
-    int id() const { return m_id; }
-    QString title() const { return m_title; }
-    QString username() const { return m_username; }
-    QString password() const { return m_password; }
-    QString website() const { return m_website; }
-    QString notes() const { return m_notes; }
-    QString category() const { return m_category; }
-    QDateTime createdAt() const { return m_createdAt; }
-    QDateTime updatedAt() const { return m_updatedAt; }
-    bool isFavorite() const { return m_isFavorite; }
+    int id() const { return m_record.id; }
+    QString title() const { return m_record.title; }
+    QString username() const { return m_record.secret(PasswordRecord::SecretUsername); }
+    QString password() const { return m_record.secret(PasswordRecord::SecretPassword); }
+    QString website() const { return m_record.website; }
+    QString notes() const { return m_record.secret(PasswordRecord::SecretNotes); }
+    QString category() const { return m_record.category; }
+    QDateTime createdAt() const { return QDateTime::fromMSecsSinceEpoch(m_record.createdAt); }
+    QDateTime updatedAt() const { return QDateTime::fromMSecsSinceEpoch(m_record.updatedAt); }
+    bool isFavorite() const { return m_record.isFavorite; }
+
+    /**
+     * @brief 获取内部的值类型记录
+     * @return 记录的常量引用
+     */
+    const PasswordRecord &record() const { return m_record; }
+
+    /**
+     * @brief 用记录替换全部字段，并为变化的属性发出通知
+     * @param record 新的记录
+     */
+    void setRecord(const PasswordRecord &record);
 
     // Setter方法
     void setId(int id);
@@ -64,11 +78,34 @@ public:
     void setUpdatedAt(const QDateTime &dateTime);
     void setIsFavorite(bool favorite);
 
+    /**
+     * @brief 设置敏感字段的密文（从数据库加载时使用）
+     *
+     * 明文不会立即解密，而是在对应getter首次被调用时解密
+     * @param username 用户名密文
+     * @param password 密码密文
+     * @param notes 备注密文
+     */
+    void setEncryptedFields(const QByteArray &username, const QByteArray &password, const QByteArray &notes);
+
+    /**
+     * @brief 获取尚未解密的敏感字段，供批量并行解密使用
+     * @return 字段指针列表，生命周期与本对象相同
+     */
+    QList<EncryptedField*> pendingSecretFields();
+
+    /**
+     * @brief 获取参与搜索的尚未解密字段（用户名和备注，不含密码）
+     * @return 字段指针列表，生命周期与本对象相同
+     */
+    QList<EncryptedField*> pendingSearchableFields();
+
     // 工具方法
     Q_INVOKABLE bool isValid() const;
     Q_INVOKABLE QString generatePassword(int length = 12, bool includeSymbols = true);
     Q_INVOKABLE bool matchesSearchTerm(const QString &searchTerm) const;
     Q_INVOKABLE QUrl getWebsiteUrl() const;
+    Q_INVOKABLE void wipeSecrets();
 
     // 静态工具方法
     static QString generateRandomPassword(int length = 12, bool includeSymbols = true);
@@ -86,16 +123,7 @@ signals:
     void isFavoriteChanged();
 
 private:
-    int m_id;                  // 唯一ID，用于数据库主键
-    QString m_title;           // 密码项目标题
-    QString m_username;        // 用户名/邮箱
-    QString m_password;        // 密码（将在存储时加密）
-    QString m_website;         // 网站URL
-    QString m_notes;           // 备注信息
-    QString m_category;        // 分类（如：社交媒体、工作、银行等）
-    QDateTime m_createdAt;     // 创建时间
-    QDateTime m_updatedAt;     // 最后更新时间
-    bool m_isFavorite;         // 是否为收藏项目
+    PasswordRecord m_record;   // 全部字段，敏感字段延迟解密
 
     void updateTimestamp();    // 更新时间戳的私有方法
 };
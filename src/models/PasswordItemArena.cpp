@@ -0,0 +1,135 @@
+#include "PasswordItemArena.h"
+
+/**
+ * @brief 构造函数
+ * @param owner 新建对象的父对象
+ */
+PasswordItemArena::PasswordItemArena(QObject *owner)
+    : m_owner(owner)
+{
+}
+
+/**
+ * @brief 析构函数
+ *
+ * 对象本身随父对象一起销毁，这里只负责清除明文
+ */
+PasswordItemArena::~PasswordItemArena()
+{
+    wipeSecrets();
+}
+
+/**
+ * @brief 获取记录的包装对象
+ * @param record 密码记录
+ * @return 包装对象
+ */
+PasswordItem *PasswordItemArena::acquire(const PasswordRecord &record)
+{
+    if (PasswordItem *item = m_live.value(record.id)) {
+        return item;
+    }
+
+    PasswordItem *item = reattach(record.id);
+    if (!item) {
+        item = new PasswordItem(m_owner);
+        if (m_setup) {
+            m_setup(item);
+        }
+        m_live.insert(record.id, item);
+    }
+    item->setRecord(record);
+    return item;
+}
+
+/**
+ * @brief 取回相同ID的待回收对象
+ * @param id 记录ID
+ * @return 取回的对象，没有时返回nullptr
+ */
+PasswordItem *PasswordItemArena::reattach(int id)
+{
+    PasswordItem *item = m_detached.take(id);
+    if (item) {
+        m_live.insert(id, item);
+    }
+    return item;
+}
+
+/**
+ * @brief 释放单个对象
+ * @param id 记录ID
+ */
+void PasswordItemArena::release(int id)
+{
+    if (PasswordItem *item = m_live.take(id)) {
+        destroy(item);
+    }
+    if (PasswordItem *item = m_detached.take(id)) {
+        destroy(item);
+    }
+}
+
+/**
+ * @brief 将所有正在使用的对象标记为待回收并清除明文
+ */
+void PasswordItemArena::detachAll()
+{
+    for (auto it = m_live.cbegin(); it != m_live.cend(); ++it) {
+        it.value()->wipeSecrets();
+        // 同一ID上一次刷新遗留的对象不会再被取回，直接删除
+        if (PasswordItem *stale = m_detached.value(it.key())) {
+            destroy(stale);
+        }
+        m_detached.insert(it.key(), it.value());
+    }
+    m_live.clear();
+}
+
+/**
+ * @brief 清除并删除所有待回收对象
+ * @return 删除的对象数量
+ */
+int PasswordItemArena::releaseDetached()
+{
+    const int count = m_detached.size();
+    for (PasswordItem *item : std::as_const(m_detached)) {
+        destroy(item);
+    }
+    m_detached.clear();
+    return count;
+}
+
+/**
+ * @brief 清除并删除所有对象
+ */
+void PasswordItemArena::releaseAll()
+{
+    detachAll();
+    releaseDetached();
+}
+
+/**
+ * @brief 清除所有对象中已解密的明文
+ */
+void PasswordItemArena::wipeSecrets()
+{
+    for (PasswordItem *item : std::as_const(m_live)) {
+        item->wipeSecrets();
+    }
+    for (PasswordItem *item : std::as_const(m_detached)) {
+        item->wipeSecrets();
+    }
+}
+
+/**
+ * @brief 清除明文并延迟删除对象
+ * @param item 要删除的对象
+ */
+void PasswordItemArena::destroy(PasswordItem *item) const
+{
+    // 先断开与父对象的连接，避免删除前再触发槽函数
+    QObject::disconnect(item, nullptr, m_owner, nullptr);
+    item->wipeSecrets();
+    item->deleteLater();
+}
@@ -0,0 +1,114 @@
+#ifndef PASSWORDITEMARENA_H
+#define PASSWORDITEMARENA_H
+
+#include <QHash>
+#include <functional>
+#include "PasswordItem.h"
+
+/**
+ * @brief 持有PasswordItem包装对象的对象池
+ *
+ * 列表模型通过它按记录ID获取可编辑的包装对象，所有对象以指定的
+ * QObject为父对象，生命周期完全由对象池管理。
+ * 刷新列表时先调用detachAll()把现有对象标记为待回收并清除明文，
+ * 重新加载到相同ID的记录时通过reattach()取回同一个对象，
+ * 这样QML持有的引用始终指向同一个条目；加载完成后由releaseDetached()
+ * 一次性清除并删除没有被取回的对象，长时间使用时对象数量保持稳定。
+ */
+class PasswordItemArena
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param owner 新建对象的父对象
+     */
+    explicit PasswordItemArena(QObject *owner);
+
+    /**
+     * @brief 析构函数，清除所有对象中的明文
+     */
+    ~PasswordItemArena();
+
+    PasswordItemArena(const PasswordItemArena &) = delete;
+    PasswordItemArena &operator=(const PasswordItemArena &) = delete;
+
+    /**
+     * @brief 设置新建对象时的初始化回调（通常用于连接信号）
+     * @param setup 回调函数
+     */
+    void setSetupFunction(std::function<void(PasswordItem*)> setup) { m_setup = std::move(setup); }
+
+    /**
+     * @brief 查找正在使用的对象
+     * @param id 记录ID
+     * @return 对象指针，不存在时返回nullptr
+     */
+    PasswordItem *find(int id) const { return m_live.value(id); }
+
+    /**
+     * @brief 获取记录的包装对象，必要时取回待回收对象或新建
+     * @param record 密码记录
+     * @return 包装对象
+     */
+    PasswordItem *acquire(const PasswordRecord &record);
+
+    /**
+     * @brief 取回相同ID的待回收对象
+     * @param id 记录ID
+     * @return 取回的对象，没有待回收对象时返回nullptr；调用方负责更新其记录
+     */
+    PasswordItem *reattach(int id);
+
+    /**
+     * @brief 释放单个对象，清除明文后延迟删除
+     * @param id 记录ID
+     */
+    void release(int id);
+
+    /**
+     * @brief 将所有正在使用的对象标记为待回收并清除明文
+     */
+    void detachAll();
+
+    /**
+     * @brief 清除并删除所有待回收对象
+     * @return 删除的对象数量
+     */
+    int releaseDetached();
+
+    /**
+     * @brief 清除并删除所有对象
+     */
+    void releaseAll();
+
+    /**
+     * @brief 清除所有对象中已解密的明文
+     */
+    void wipeSecrets();
+
+    /**
+     * @brief 正在使用的对象数量
+     * @return 对象数量
+     */
+    int liveCount() const { return m_live.size(); }
+
+    /**
+     * @brief 待回收的对象数量
+     * @return 对象数量
+     */
+    int detachedCount() const { return m_detached.size(); }
+
+private:
+    QObject *m_owner;                              // 新建对象的父对象
+    std::function<void(PasswordItem*)> m_setup;    // 新建对象的初始化回调
+    QHash<int, PasswordItem*> m_live;              // 正在使用的对象
+    QHash<int, PasswordItem*> m_detached;          // 等待取回或删除的对象
+
+    /**
+     * @brief 清除明文并延迟删除对象（QML可能仍持有引用）
+     * @param item 要删除的对象
+     */
+    void destroy(PasswordItem *item) const;
+};
+
+#endif // PASSWORDITEMARENA_H
@@ -1,5 +1,7 @@
 #include "PasswordListModel.h"
 #include <QDebug>
+#include <QDateTime>
+#include <QSet>
 #include <algorithm>
 
 /**
@@ -8,8 +10,22 @@
  */
 PasswordListModel::PasswordListModel(QObject *parent)
     : QAbstractListModel(parent)
+    , m_items(this)
+    , m_syncingItems(false)
     , m_showFavoritesOnly(false)
+    , m_searchIndexBuilt(false)
+    , m_idFilterActive(false)
 {
+    // 连接包装对象的所有变化信号，编辑结果写回记录
+    m_items.setSetupFunction([this](PasswordItem *item) {
+        connect(item, &PasswordItem::titleChanged, this, &PasswordListModel::onPasswordItemChanged);
+        connect(item, &PasswordItem::usernameChanged, this, &PasswordListModel::onPasswordItemChanged);
+        connect(item, &PasswordItem::passwordChanged, this, &PasswordListModel::onPasswordItemChanged);
+        connect(item, &PasswordItem::websiteChanged, this, &PasswordListModel::onPasswordItemChanged);
+        connect(item, &PasswordItem::notesChanged, this, &PasswordListModel::onPasswordItemChanged);
+        connect(item, &PasswordItem::categoryChanged, this, &PasswordListModel::onPasswordItemChanged);
+        connect(item, &PasswordItem::isFavoriteChanged, this, &PasswordListModel::onPasswordItemChanged);
+    });
 }
 
 /**
@@ -20,7 +36,7 @@ PasswordListModel::PasswordListModel(QObject *parent)
 int PasswordListModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent)
-    return m_filteredItems.size();
+    return m_filteredIds.size();
 }
 
 /**
@@ -31,38 +47,36 @@ int PasswordListModel::rowCount(const QModelIndex &parent) const
  */
 QVariant PasswordListModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_filteredItems.size()) {
+    if (!index.isValid() || index.row() >= m_filteredIds.size()) {
         return QVariant();
     }
 
-    PasswordItem *item = m_filteredItems.at(index.row());
-    if (!item) {
+    const PasswordRecord *record = m_store.find(m_filteredIds.at(index.row()));
+    if (!record) {
         return QVariant();
     }
 
     switch (role) {
     case IdRole:
-        return item->id();
+        return record->id;
     case TitleRole:
-        return item->title();
+        return record->title;
     case UsernameRole:
-        return item->username();
+        return record->secret(PasswordRecord::SecretUsername);
     case PasswordRole:
-        return item->password();
+        return record->secret(PasswordRecord::SecretPassword);
     case WebsiteRole:
-        return item->website();
+        return record->website;
     case NotesRole:
-        return item->notes();
+        return record->secret(PasswordRecord::SecretNotes);
     case CategoryRole:
-        return item->category();
+        return record->category;
     case CreatedAtRole:
-        return item->createdAt();
+        return QDateTime::fromMSecsSinceEpoch(record->createdAt);
     case UpdatedAtRole:
-        return item->updatedAt();
+        return QDateTime::fromMSecsSinceEpoch(record->updatedAt);
     case IsFavoriteRole:
-        return item->isFavorite();
-    case PasswordItemRole:
-        return QVariant::fromValue(item);
+        return record->isFavorite;
     default:
         return QVariant();
     }
@@ -85,7 +99,6 @@ QHash<int, QByteArray> PasswordListModel::roleNames() const
     roles[CreatedAtRole] = "createdAt";
     roles[UpdatedAtRole] = "updatedAt";
     roles[IsFavoriteRole] = "isFavorite";
-    roles[PasswordItemRole] = "passwordItem";
     return roles;
 }
 
@@ -95,7 +108,7 @@ QHash<int, QByteArray> PasswordListModel::roleNames() const
  */
 int PasswordListModel::count() const
 {
-    return m_filteredItems.size();
+    return m_filteredIds.size();
 }
 
 /**
@@ -106,6 +119,7 @@ void PasswordListModel::setSearchFilter(const QString &filter)
 {
     if (m_searchFilter != filter) {
         m_searchFilter = filter;
+        m_foldedSearchFilter = TrigramIndex::fold(filter);
         applyFilters();
         emit searchFilterChanged();
     }
@@ -139,6 +153,8 @@ void PasswordListModel::setShowFavoritesOnly(bool showFavoritesOnly)
 
 /**
  * @brief 添加密码项目
+ *
+ * 只复制项目中的记录，模型不接管传入对象的所有权
  * @param item 要添加的密码项目
  */
 void PasswordListModel::addPassword(PasswordItem *item)
@@ -147,16 +163,17 @@ void PasswordListModel::addPassword(PasswordItem *item)
         return;
     }
 
-    // 检查是否已存在相同ID的项目
-    for (PasswordItem *existingItem : m_passwordItems) {
-        if (existingItem->id() == item->id() && item->id() != -1) {
-            qWarning() << "Password item with ID" << item->id() << "already exists";
-            return;
-        }
+    // 检查是否已存在相同ID的项目（记录按ID存储，ID必须唯一）
+    if (m_store.contains(item->id())) {
+        qWarning() << "Password item with ID" << item->id() << "already exists";
+        return;
     }
 
-    m_passwordItems.append(item);
-    connectPasswordItem(item);
+    m_store.insert(item->record());
+    m_order.append(item->id());
+    if (m_searchIndexBuilt) {
+        indexPasswordRecords({item->id()});
+    }
     applyFilters();
     emit passwordAdded(item);
 }
@@ -167,12 +184,11 @@ void PasswordListModel::addPassword(PasswordItem *item)
  */
 void PasswordListModel::removePassword(int index)
 {
-    if (index < 0 || index >= m_filteredItems.size()) {
+    if (index < 0 || index >= m_filteredIds.size()) {
         return;
     }
 
-    PasswordItem *item = m_filteredItems.at(index);
-    removePasswordById(item->id());
+    removePasswordById(m_filteredIds.at(index));
 }
 
 /**
@@ -181,16 +197,24 @@ void PasswordListModel::removePassword(int index)
  */
 void PasswordListModel::removePasswordById(int id)
 {
-    for (int i = 0; i < m_passwordItems.size(); ++i) {
-        if (m_passwordItems.at(i)->id() == id) {
-            PasswordItem *item = m_passwordItems.at(i);
-            disconnectPasswordItem(item);
-            m_passwordItems.removeAt(i);
-            applyFilters();
-            emit passwordRemoved(id);
-            break;
-        }
+    if (!m_store.contains(id)) {
+        return;
     }
+
+    m_items.release(id);
+    m_searchIndex.remove(id);
+
+    // 只移除对应的一行，其余行保持不变
+    const int row = m_filteredIds.indexOf(id);
+    if (row >= 0) {
+        beginRemoveRows(QModelIndex(), row, row);
+        m_filteredIds.removeAt(row);
+        endRemoveRows();
+        emit countChanged();
+    }
+    m_order.removeOne(id);
+    m_store.remove(id);
+    emit passwordRemoved(id);
 }
 
 /**
@@ -200,10 +224,10 @@ void PasswordListModel::removePasswordById(int id)
  */
 PasswordItem* PasswordListModel::getPassword(int index)
 {
-    if (index < 0 || index >= m_filteredItems.size()) {
+    if (index < 0 || index >= m_filteredIds.size()) {
         return nullptr;
     }
-    return m_filteredItems.at(index);
+    return wrapperFor(m_filteredIds.at(index));
 }
 
 /**
@@ -213,12 +237,7 @@ PasswordItem* PasswordListModel::getPassword(int index)
  */
 PasswordItem* PasswordListModel::getPasswordById(int id)
 {
-    for (PasswordItem *item : m_passwordItems) {
-        if (item->id() == id) {
-            return item;
-        }
-    }
-    return nullptr;
+    return wrapperFor(id);
 }
 
 /**
@@ -228,13 +247,13 @@ PasswordItem* PasswordListModel::getPasswordById(int id)
  */
 void PasswordListModel::updatePassword(int index, PasswordItem *item)
 {
-    if (!item || index < 0 || index >= m_filteredItems.size()) {
+    if (!item || index < 0 || index >= m_filteredIds.size()) {
         return;
     }
 
-    PasswordItem *existingItem = m_filteredItems.at(index);
+    PasswordItem *existingItem = wrapperFor(m_filteredIds.at(index));
     if (existingItem) {
-        // 更新现有项目的数据
+        // 通过包装对象更新，变化信号会把数据写回记录并重新应用过滤器
         existingItem->setTitle(item->title());
         existingItem->setUsername(item->username());
         existingItem->setPassword(item->password());
@@ -242,27 +261,24 @@ void PasswordListModel::updatePassword(int index, PasswordItem *item)
         existingItem->setNotes(item->notes());
         existingItem->setCategory(item->category());
         existingItem->setIsFavorite(item->isFavorite());
-        
-        // 重新应用过滤器（因为可能影响过滤结果）
-        applyFilters();
         emit passwordUpdated(existingItem);
     }
 }
 
 /**
  * @brief 清空所有密码项目
+ *
+ * 包装对象只标记为待回收，重新加载相同ID的记录时继续使用，
+ * 加载完成后调用releaseStaleItems()删除其余对象
  */
 void PasswordListModel::clear()
 {
     beginResetModel();
-    
-    // 断开所有信号连接
-    for (PasswordItem *item : m_passwordItems) {
-        disconnectPasswordItem(item);
-    }
-    
-    m_passwordItems.clear();
-    m_filteredItems.clear();
+    m_items.detachAll();
+    m_store.clear();
+    m_order.clear();
+    m_filteredIds.clear();
+    resetSearchIndex();
     endResetModel();
     emit countChanged();
 }
@@ -275,6 +291,19 @@ void PasswordListModel::refresh()
     applyFilters();
 }
 
+/**
+ * @brief 清除所有项目中已解密的敏感字段明文
+ */
+void PasswordListModel::wipeSecrets()
+{
+    for (PasswordRecord &record : m_store.records()) {
+        record.wipeSecrets();
+    }
+    m_items.wipeSecrets();
+    // 搜索索引缓存了折叠后的用户名和备注，一并清零，下次搜索时重新建立
+    resetSearchIndex();
+}
+
 /**
  * @brief 搜索密码项目
  * @param searchTerm 搜索词
@@ -283,9 +312,18 @@ void PasswordListModel::refresh()
 QList<PasswordItem*> PasswordListModel::search(const QString &searchTerm)
 {
     QList<PasswordItem*> results;
-    for (PasswordItem *item : m_passwordItems) {
-        if (item->matchesSearchTerm(searchTerm)) {
-            results.append(item);
+    if (searchTerm.isEmpty()) {
+        for (int id : std::as_const(m_order)) {
+            results.append(wrapperFor(id));
+        }
+        return results;
+    }
+
+    ensureSearchIndex();
+    const QSet<int> matches = m_searchIndex.search(TrigramIndex::fold(searchTerm));
+    for (int id : std::as_const(m_order)) {
+        if (matches.contains(id)) {
+            results.append(wrapperFor(id));
         }
     }
     return results;
@@ -297,13 +335,13 @@ QList<PasswordItem*> PasswordListModel::search(const QString &searchTerm)
  */
 QStringList PasswordListModel::getCategories() const
 {
-    QStringList categories;
-    for (PasswordItem *item : m_passwordItems) {
-        QString category = item->category();
-        if (!category.isEmpty() && !categories.contains(category)) {
-            categories.append(category);
+    QSet<QString> unique;
+    for (const PasswordRecord &record : m_store.records()) {
+        if (!record.category.isEmpty()) {
+            unique.insert(record.category);
         }
     }
+    QStringList categories(unique.cbegin(), unique.cend());
     categories.sort();
     return categories;
 }
@@ -315,9 +353,10 @@ QStringList PasswordListModel::getCategories() const
 QList<PasswordItem*> PasswordListModel::getFavorites() const
 {
     QList<PasswordItem*> favorites;
-    for (PasswordItem *item : m_passwordItems) {
-        if (item->isFavorite()) {
-            favorites.append(item);
+    for (int id : m_order) {
+        const PasswordRecord *record = m_store.find(id);
+        if (record && record->isFavorite) {
+            favorites.append(wrapperFor(id));
         }
     }
     return favorites;
@@ -329,12 +368,9 @@ QList<PasswordItem*> PasswordListModel::getFavorites() const
  */
 void PasswordListModel::sortByTitle(bool ascending)
 {
-    beginResetModel();
-    std::sort(m_filteredItems.begin(), m_filteredItems.end(),
-              [ascending](const PasswordItem *a, const PasswordItem *b) {
-                  return ascending ? a->title() < b->title() : a->title() > b->title();
-              });
-    endResetModel();
+    sortItems([ascending](const PasswordRecord &a, const PasswordRecord &b) {
+        return ascending ? a.title < b.title : a.title > b.title;
+    });
 }
 
 /**
@@ -343,12 +379,9 @@ void PasswordListModel::sortByTitle(bool ascending)
  */
 void PasswordListModel::sortByCategory(bool ascending)
 {
-    beginResetModel();
-    std::sort(m_filteredItems.begin(), m_filteredItems.end(),
-              [ascending](const PasswordItem *a, const PasswordItem *b) {
-                  return ascending ? a->category() < b->category() : a->category() > b->category();
-              });
-    endResetModel();
+    sortItems([ascending](const PasswordRecord &a, const PasswordRecord &b) {
+        return ascending ? a.category < b.category : a.category > b.category;
+    });
 }
 
 /**
@@ -357,12 +390,9 @@ void PasswordListModel::sortByCategory(bool ascending)
  */
 void PasswordListModel::sortByCreatedDate(bool ascending)
 {
-    beginResetModel();
-    std::sort(m_filteredItems.begin(), m_filteredItems.end(),
-              [ascending](const PasswordItem *a, const PasswordItem *b) {
-                  return ascending ? a->createdAt() < b->createdAt() : a->createdAt() > b->createdAt();
-              });
-    endResetModel();
+    sortItems([ascending](const PasswordRecord &a, const PasswordRecord &b) {
+        return ascending ? a.createdAt < b.createdAt : a.createdAt > b.createdAt;
+    });
 }
 
 /**
@@ -371,113 +401,385 @@ void PasswordListModel::sortByCreatedDate(bool ascending)
  */
 void PasswordListModel::sortByUpdatedDate(bool ascending)
 {
-    beginResetModel();
-    std::sort(m_filteredItems.begin(), m_filteredItems.end(),
-              [ascending](const PasswordItem *a, const PasswordItem *b) {
-                  return ascending ? a->updatedAt() < b->updatedAt() : a->updatedAt() > b->updatedAt();
-              });
-    endResetModel();
+    sortItems([ascending](const PasswordRecord &a, const PasswordRecord &b) {
+        return ascending ? a.updatedAt < b.updatedAt : a.updatedAt > b.updatedAt;
+    });
 }
 
 /**
- * @brief 设置密码项目列表
- * @param items 新的密码项目列表
+ * @brief 设置密码记录列表
+ * @param records 新的密码记录，按显示顺序排列
  */
-void PasswordListModel::setPasswordItems(const QList<PasswordItem*> &items)
+void PasswordListModel::setPasswordRecords(QList<PasswordRecord> records)
 {
     beginResetModel();
-    
-    // 断开旧的信号连接
-    for (PasswordItem *item : m_passwordItems) {
-        disconnectPasswordItem(item);
+    m_items.detachAll();
+    m_store.clear();
+    m_order.clear();
+    resetSearchIndex();
+
+    m_store.reserve(records.size());
+    m_order.reserve(records.size());
+    for (PasswordRecord &record : records) {
+        if (!m_store.contains(record.id)) {
+            m_order.append(record.id);
+        }
+        m_store.insert(std::move(record));
     }
-    
-    m_passwordItems = items;
-    
-    // 连接新的信号
-    for (PasswordItem *item : m_passwordItems) {
-        connectPasswordItem(item);
+    for (int id : std::as_const(m_order)) {
+        reattachItem(id);
     }
-    
-    applyFilters();
+    m_items.releaseDetached();
+
+    m_filteredIds = computeFilteredIds();
     endResetModel();
     emit countChanged();
 }
 
 /**
- * @brief 获取所有密码项目
- * @return 所有密码项目列表
+ * @brief 在末尾追加一批密码记录
+ *
+ * 只为通过过滤条件的记录发出beginInsertRows/endInsertRows，
+ * 已显示的行和滚动位置保持不变，适合分批加载
+ * @param records 要追加的密码记录
  */
-QList<PasswordItem*> PasswordListModel::getAllPasswords() const
+void PasswordListModel::appendPasswordRecords(QList<PasswordRecord> records)
 {
-    return m_passwordItems;
+    if (records.isEmpty()) {
+        return;
+    }
+
+    QList<int> ids;
+    ids.reserve(records.size());
+    for (PasswordRecord &record : records) {
+        const int id = record.id;
+        if (m_store.contains(id)) {
+            qWarning() << "Password item with ID" << id << "already exists";
+            continue;
+        }
+        m_store.insert(std::move(record));
+        m_order.append(id);
+        ids.append(id);
+        reattachItem(id);
+    }
+
+    if (m_searchIndexBuilt) {
+        indexPasswordRecords(ids);
+    }
+
+    QList<int> visibleIds;
+    for (int id : std::as_const(ids)) {
+        if (matchesFilters(*m_store.find(id))) {
+            visibleIds.append(id);
+        }
+    }
+
+    if (!visibleIds.isEmpty()) {
+        const int first = m_filteredIds.size();
+        beginInsertRows(QModelIndex(), first, first + visibleIds.size() - 1);
+        m_filteredIds.append(visibleIds);
+        endInsertRows();
+        emit countChanged();
+    }
 }
 
 /**
- * @brief 获取过滤后的密码项目
- * @return 过滤后的密码项目列表
+ * @brief 合并一批记录：已有ID的记录原地替换，其余追加到末尾，同一ID只保留最后一条
+ *
+ * 用于批量导入完成后一次性更新列表，不重新加载整个列表
+ * @param records 要合并的密码记录
  */
-QList<PasswordItem*> PasswordListModel::getFilteredPasswords() const
+void PasswordListModel::upsertPasswordRecords(QList<PasswordRecord> records)
 {
-    return m_filteredItems;
+    // 同一次导入中标题和网址相同的条目写入同一ID，只保留最后写入的一条，
+    // 否则新增的ID会被追加两次
+    QList<PasswordRecord> unique;
+    unique.reserve(records.size());
+    QSet<int> seen;
+    for (auto it = records.rbegin(); it != records.rend(); ++it) {
+        if (!seen.contains(it->id)) {
+            seen.insert(it->id);
+            unique.append(std::move(*it));
+        }
+    }
+    std::reverse(unique.begin(), unique.end());
+
+    QList<PasswordRecord> added;
+    QList<int> changedIds;
+    for (PasswordRecord &record : unique) {
+        if (!m_store.contains(record.id)) {
+            added.append(std::move(record));
+            continue;
+        }
+        const int id = record.id;
+        m_store.insert(std::move(record));
+        changedIds.append(id);
+        if (PasswordItem *item = m_items.find(id)) {
+            m_syncingItems = true;
+            item->setRecord(*m_store.find(id));
+            m_syncingItems = false;
+        }
+    }
+
+    if (!changedIds.isEmpty()) {
+        if (m_searchIndexBuilt) {
+            indexPasswordRecords(changedIds);
+        }
+        applyFilters();
+
+        // 替换的记录仍然可见时，用一次dataChanged覆盖它们所在的行范围
+        int firstRow = -1;
+        int lastRow = -1;
+        const QSet<int> changed(changedIds.cbegin(), changedIds.cend());
+        for (int row = 0; row < m_filteredIds.size(); ++row) {
+            if (changed.contains(m_filteredIds.at(row))) {
+                if (firstRow < 0) {
+                    firstRow = row;
+                }
+                lastRow = row;
+            }
+        }
+        if (firstRow >= 0) {
+            emit dataChanged(index(firstRow), index(lastRow));
+        }
+    }
+
+    appendPasswordRecords(std::move(added));
+}
+
+/**
+ * @brief 只显示指定ID的项目
+ *
+ * 用于应用数据库全文搜索的结果，不创建新的项目对象，
+ * 只对可见性发生变化的行发出信号
+ * @param ids 要显示的项目ID
+ */
+void PasswordListModel::setIdFilter(const QList<int> &ids)
+{
+    m_idFilter = QSet<int>(ids.cbegin(), ids.cend());
+    m_idFilterActive = true;
+    applyFilters();
 }
 
 /**
- * @brief 密码项目数据变化时的槽函数
+ * @brief 取消ID过滤
+ */
+void PasswordListModel::clearIdFilter()
+{
+    if (!m_idFilterActive) {
+        return;
+    }
+    m_idFilter.clear();
+    m_idFilterActive = false;
+    applyFilters();
+}
+
+/**
+ * @brief 包装对象数据变化时的槽函数
+ *
+ * 把包装对象中的数据写回记录，再更新索引和过滤结果
  */
 void PasswordListModel::onPasswordItemChanged()
 {
-    // 重新应用过滤器，因为数据变化可能影响过滤结果
+    PasswordItem *changedItem = qobject_cast<PasswordItem*>(sender());
+    if (m_syncingItems || !changedItem || !m_store.contains(changedItem->id())) {
+        return;
+    }
+
+    const int id = changedItem->id();
+    m_store.insert(changedItem->record());
+    if (m_searchIndexBuilt) {
+        m_searchIndex.insert(*m_store.find(id));
+    }
+
     applyFilters();
     
-    // 查找变化的项目并发出信号
-    PasswordItem *changedItem = qobject_cast<PasswordItem*>(sender());
-    if (changedItem) {
-        emit passwordUpdated(changedItem);
+    // 项目仍然可见时只通知它所在的一行
+    const int row = m_filteredIds.indexOf(id);
+    if (row >= 0) {
+        const QModelIndex changedIndex = index(row);
+        emit dataChanged(changedIndex, changedIndex);
     }
+    emit passwordUpdated(changedItem);
 }
 
 /**
  * @brief 应用所有过滤器
+ *
+ * 计算新的过滤结果后与当前结果比较，只对发生变化的连续行发出
+ * 插入/删除信号，未变化的行、委托和滚动位置保持不变
  */
 void PasswordListModel::applyFilters()
 {
-    beginResetModel();
-    
-    m_filteredItems.clear();
-    for (PasswordItem *item : m_passwordItems) {
-        if (matchesFilters(item)) {
-            m_filteredItems.append(item);
+    updateFilteredIds(computeFilteredIds());
+}
+
+/**
+ * @brief 按当前过滤条件计算过滤结果，保持完整列表中的顺序
+ * @return 过滤后的记录ID列表
+ */
+QList<int> PasswordListModel::computeFilteredIds()
+{
+    QList<int> filtered;
+    if (m_searchFilter.isEmpty()) {
+        for (int id : std::as_const(m_order)) {
+            if (matchesFilters(*m_store.find(id))) {
+                filtered.append(id);
+            }
+        }
+    } else {
+        // 通过索引一次性得到匹配集合，不再逐项转换大小写
+        ensureSearchIndex();
+        const QSet<int> matches = m_searchIndex.search(m_foldedSearchFilter);
+        for (int id : std::as_const(m_order)) {
+            if (matches.contains(id) && matchesFilters(*m_store.find(id))) {
+                filtered.append(id);
+            }
         }
     }
-    
-    endResetModel();
-    emit countChanged();
+    return filtered;
+}
+
+/**
+ * @brief 将过滤结果更新为新的列表，只发出最少的行插入/删除信号
+ *
+ * 新旧过滤结果都是m_order的子序列且顺序一致，因此可以沿着
+ * 完整列表同时遍历二者，把连续的新增和移除合并为一次行操作
+ * @param filtered 新的过滤结果
+ */
+void PasswordListModel::updateFilteredIds(const QList<int> &filtered)
+{
+    const QList<int> previous = m_filteredIds;
+    const int previousCount = previous.size();
+
+    int row = 0;                  // 当前处理到的行
+    int oldPos = 0;               // 旧结果中的位置
+    int newPos = 0;               // 新结果中的位置
+    int removeCount = 0;          // 待移除的连续行数（从row开始）
+    QList<int> pendingInserts;    // 待插入到row处的连续记录
+
+    auto flushRemovals = [&]() {
+        if (removeCount > 0) {
+            beginRemoveRows(QModelIndex(), row, row + removeCount - 1);
+            m_filteredIds.remove(row, removeCount);
+            endRemoveRows();
+            removeCount = 0;
+        }
+    };
+    auto flushInserts = [&]() {
+        if (!pendingInserts.isEmpty()) {
+            beginInsertRows(QModelIndex(), row, row + pendingInserts.size() - 1);
+            for (int k = 0; k < pendingInserts.size(); ++k) {
+                m_filteredIds.insert(row + k, pendingInserts.at(k));
+            }
+            endInsertRows();
+            row += pendingInserts.size();
+            pendingInserts.clear();
+        }
+    };
+
+    for (int id : std::as_const(m_order)) {
+        const bool wasVisible = oldPos < previous.size() && previous.at(oldPos) == id;
+        const bool isVisible = newPos < filtered.size() && filtered.at(newPos) == id;
+
+        if (wasVisible && isVisible) {
+            flushRemovals();
+            flushInserts();
+            ++row;
+            ++oldPos;
+            ++newPos;
+        } else if (wasVisible) {
+            flushInserts();
+            ++removeCount;
+            ++oldPos;
+        } else if (isVisible) {
+            flushRemovals();
+            pendingInserts.append(id);
+            ++newPos;
+        }
+    }
+    flushRemovals();
+    flushInserts();
+
+    if (m_filteredIds.size() != previousCount) {
+        emit countChanged();
+    }
+}
+
+/**
+ * @brief 按给定比较函数对全部记录稳定排序，过滤结果随之重排
+ *
+ * 只改变行的顺序，通过layoutChanged通知视图并更新持久索引，
+ * 不会重建委托
+ * @param lessThan 比较函数
+ */
+void PasswordListModel::sortItems(const std::function<bool(const PasswordRecord&, const PasswordRecord&)> &lessThan)
+{
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    // 排序期间记录不会移动，直接比较指针指向的记录，避免反复查表
+    QList<const PasswordRecord*> records;
+    records.reserve(m_order.size());
+    for (int id : std::as_const(m_order)) {
+        records.append(m_store.find(id));
+    }
+    std::stable_sort(records.begin(), records.end(), [&lessThan](const PasswordRecord *a, const PasswordRecord *b) {
+        return lessThan(*a, *b);
+    });
+    for (int i = 0; i < records.size(); ++i) {
+        m_order[i] = records.at(i)->id;
+    }
+
+    // 按新顺序重新排列过滤结果，保持其为完整列表的子序列
+    QSet<int> visible(m_filteredIds.cbegin(), m_filteredIds.cend());
+    QList<int> sorted;
+    sorted.reserve(m_filteredIds.size());
+    QHash<int, int> newRows;
+    for (int id : std::as_const(m_order)) {
+        if (visible.contains(id)) {
+            newRows.insert(id, sorted.size());
+            sorted.append(id);
+        }
+    }
+
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (const QModelIndex &oldIndex : oldIndexes) {
+        const int id = m_filteredIds.value(oldIndex.row(), -1);
+        newIndexes.append(index(newRows.value(id, oldIndex.row()), oldIndex.column()));
+    }
+
+    m_filteredIds = sorted;
+    changePersistentIndexList(oldIndexes, newIndexes);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
 }
 
 /**
- * @brief 检查项目是否匹配过滤条件
- * @param item 要检查的密码项目
+ * @brief 检查记录是否匹配过滤条件
+ * @param record 要检查的密码记录
  * @return 如果匹配所有过滤条件则返回true
  */
-bool PasswordListModel::matchesFilters(PasswordItem *item) const
+bool PasswordListModel::matchesFilters(const PasswordRecord &record) const
 {
-    if (!item) {
+    // 搜索过滤器（使用索引中缓存的折叠文本）
+    if (!m_searchFilter.isEmpty() && !m_searchIndex.matches(record.id, m_foldedSearchFilter)) {
         return false;
     }
     
-    // 搜索过滤器
-    if (!m_searchFilter.isEmpty() && !item->matchesSearchTerm(m_searchFilter)) {
+    // ID过滤器
+    if (m_idFilterActive && !m_idFilter.contains(record.id)) {
         return false;
     }
     
     // 分类过滤器
-    if (!m_categoryFilter.isEmpty() && item->category() != m_categoryFilter) {
+    if (!m_categoryFilter.isEmpty() && record.category != m_categoryFilter) {
         return false;
     }
     
     // 收藏过滤器
-    if (m_showFavoritesOnly && !item->isFavorite()) {
+    if (m_showFavoritesOnly && !record.isFavorite) {
         return false;
     }
     
@@ -485,35 +787,89 @@ bool PasswordListModel::matchesFilters(PasswordItem *item) const
 }
 
 /**
- * @brief 连接密码项目的信号
- * @param item 要连接信号的密码项目
+ * @brief 获取或创建记录的包装对象
+ * @param id 记录ID
+ * @return 包装对象，记录不存在时返回nullptr
  */
-void PasswordListModel::connectPasswordItem(PasswordItem *item)
+PasswordItem *PasswordListModel::wrapperFor(int id) const
 {
-    if (!item) {
-        return;
+    if (PasswordItem *item = m_items.find(id)) {
+        return item;
     }
-    
-    // 连接所有变化信号到槽函数
-    connect(item, &PasswordItem::titleChanged, this, &PasswordListModel::onPasswordItemChanged);
-    connect(item, &PasswordItem::usernameChanged, this, &PasswordListModel::onPasswordItemChanged);
-    connect(item, &PasswordItem::passwordChanged, this, &PasswordListModel::onPasswordItemChanged);
-    connect(item, &PasswordItem::websiteChanged, this, &PasswordListModel::onPasswordItemChanged);
-    connect(item, &PasswordItem::notesChanged, this, &PasswordListModel::onPasswordItemChanged);
-    connect(item, &PasswordItem::categoryChanged, this, &PasswordListModel::onPasswordItemChanged);
-    connect(item, &PasswordItem::isFavoriteChanged, this, &PasswordListModel::onPasswordItemChanged);
+
+    const PasswordRecord *record = m_store.find(id);
+    if (!record) {
+        return nullptr;
+    }
+
+    m_syncingItems = true;
+    PasswordItem *item = m_items.acquire(*record);
+    m_syncingItems = false;
+    return item;
 }
 
 /**
- * @brief 断开密码项目的信号连接
- * @param item 要断开信号连接的密码项目
+ * @brief 刷新后取回相同ID的包装对象并更新其数据
+ *
+ * QML持有的引用因此在刷新后仍然指向同一条目
+ * @param id 记录ID
  */
-void PasswordListModel::disconnectPasswordItem(PasswordItem *item)
+void PasswordListModel::reattachItem(int id)
 {
-    if (!item) {
+    PasswordItem *item = m_items.reattach(id);
+    if (item) {
+        m_syncingItems = true;
+        item->setRecord(*m_store.find(id));
+        m_syncingItems = false;
+    }
+}
+
+/**
+ * @brief 删除刷新后没有被重新加载的包装对象
+ *
+ * 应在分批加载全部完成后调用，删除前会清除其中的明文
+ * @return 删除的对象数量
+ */
+int PasswordListModel::releaseStaleItems()
+{
+    return m_items.releaseDetached();
+}
+
+/**
+ * @brief 首次搜索时为所有记录建立搜索索引
+ */
+void PasswordListModel::ensureSearchIndex()
+{
+    if (m_searchIndexBuilt) {
         return;
     }
-    
-    // 断开所有信号连接
-    disconnect(item, nullptr, this, nullptr);
-} 
\ No newline at end of file
+    m_searchIndexBuilt = true;
+    indexPasswordRecords(m_order);
+}
+
+/**
+ * @brief 批量解密用户名和备注后将记录加入搜索索引
+ * @param ids 记录ID列表
+ */
+void PasswordListModel::indexPasswordRecords(const QList<int> &ids)
+{
+    // 解密期间存储不会变化，字段指针保持有效
+    QList<EncryptedField*> fields;
+    for (int id : ids) {
+        fields.append(m_store.find(id)->pendingSearchableFields());
+    }
+    EncryptedField::decryptAll(fields);
+
+    for (int id : ids) {
+        m_searchIndex.insert(*m_store.find(id));
+    }
+}
+
+/**
+ * @brief 丢弃搜索索引，下次搜索时重新建立
+ */
+void PasswordListModel::resetSearchIndex()
+{
+    m_searchIndex.clear();
+    m_searchIndexBuilt = false;
+}
@@ -3,13 +3,21 @@
 
 #include <QAbstractListModel>
 #include <QQmlEngine>
+#include <QSet>
+#include <functional>
 #include "PasswordItem.h"
+#include "PasswordItemArena.h"
+#include "PasswordRecordStore.h"
+#include "TrigramIndex.h"
 
 /**
  * @brief 密码列表模型类
  * 
  * 继承自QAbstractListModel，用于在QML界面中显示密码列表
- * 支持搜索、过滤、排序等功能
+ * 支持搜索、过滤、排序等功能。
+ * 条目以值类型记录保存在PasswordRecordStore中，各角色直接读取记录；
+ * 只有QML需要可编辑对象时才通过getPasswordById()按需创建PasswordItem包装，
+ * 并在编辑后写回记录；委托应绑定普通角色，不为每行创建对象
  */
 class PasswordListModel : public QAbstractListModel
 {
@@ -37,8 +45,7 @@ public:
         CategoryRole,
         CreatedAtRole,
         UpdatedAtRole,
-        IsFavoriteRole,
-        PasswordItemRole  // 返回完整的PasswordItem对象
+        IsFavoriteRole
     };
 
     explicit PasswordListModel(QObject *parent = nullptr);
@@ -67,6 +74,7 @@ public:
     Q_INVOKABLE void updatePassword(int index, PasswordItem *item);
     Q_INVOKABLE void clear();
     Q_INVOKABLE void refresh();
+    Q_INVOKABLE void wipeSecrets();
 
     // 搜索和过滤
     Q_INVOKABLE QList<PasswordItem*> search(const QString &searchTerm);
@@ -80,9 +88,14 @@ public:
     Q_INVOKABLE void sortByUpdatedDate(bool ascending = false);
 
     // 数据操作
-    void setPasswordItems(const QList<PasswordItem*> &items);
-    QList<PasswordItem*> getAllPasswords() const;
-    QList<PasswordItem*> getFilteredPasswords() const;
+    void setPasswordRecords(QList<PasswordRecord> records);
+    void appendPasswordRecords(QList<PasswordRecord> records);
+    void upsertPasswordRecords(QList<PasswordRecord> records);
+    void setIdFilter(const QList<int> &ids);
+    void clearIdFilter();
+    int totalCount() const { return m_store.size(); }
+    bool containsPassword(int id) const { return m_store.contains(id); }
+    int releaseStaleItems();
 
 signals:
     void countChanged();
@@ -97,16 +110,30 @@ private slots:
     void onPasswordItemChanged();
 
 private:
-    QList<PasswordItem*> m_passwordItems;     // 所有密码项目
-    QList<PasswordItem*> m_filteredItems;     // 过滤后的密码项目
+    PasswordRecordStore m_store;              // 所有密码记录
+    QList<int> m_order;                       // 所有记录ID，按显示顺序排列
+    QList<int> m_filteredIds;                 // 过滤后的记录ID
+    mutable PasswordItemArena m_items;        // 按需创建的可编辑包装对象
+    mutable bool m_syncingItems;              // 正在用记录更新包装对象，忽略其变化信号
     QString m_searchFilter;                    // 搜索过滤器
     QString m_categoryFilter;                  // 分类过滤器
     bool m_showFavoritesOnly;                 // 是否只显示收藏
+    TrigramIndex m_searchIndex;               // 搜索索引，首次搜索时建立
+    bool m_searchIndexBuilt;                  // 搜索索引是否已建立
+    QString m_foldedSearchFilter;             // 大小写折叠后的搜索词
+    QSet<int> m_idFilter;                     // 只显示这些ID的项目（异步搜索结果）
+    bool m_idFilterActive;                    // 是否启用ID过滤
 
     void applyFilters();                      // 应用过滤器
-    bool matchesFilters(PasswordItem *item) const;  // 检查项目是否匹配过滤条件
-    void connectPasswordItem(PasswordItem *item);   // 连接密码项目的信号
-    void disconnectPasswordItem(PasswordItem *item); // 断开密码项目的信号连接
+    QList<int> computeFilteredIds();          // 按当前过滤条件计算过滤结果
+    void updateFilteredIds(const QList<int> &filtered); // 以最少的行变化更新过滤结果
+    void sortItems(const std::function<bool(const PasswordRecord&, const PasswordRecord&)> &lessThan); // 稳定排序全部记录
+    bool matchesFilters(const PasswordRecord &record) const; // 检查记录是否匹配过滤条件
+    PasswordItem *wrapperFor(int id) const;   // 获取或创建记录的包装对象
+    void reattachItem(int id);                // 刷新后取回相同ID的包装对象并更新其数据
+    void ensureSearchIndex();                 // 首次搜索时为所有记录建立搜索索引
+    void indexPasswordRecords(const QList<int> &ids); // 批量解密并索引记录
+    void resetSearchIndex();                  // 丢弃搜索索引
 };
 
 #endif // PASSWORDLISTMODEL_H 
\ No newline at end of file
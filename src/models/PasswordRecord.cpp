@@ -0,0 +1,267 @@
+#include "PasswordRecord.h"
+#include <QStringList>
+#include <QHash>
+#include <QPair>
+#include "crypto/CryptoManager.h"
+
+/**
+ * @brief 尽量清零并清空一组临时明文
+ *
+ * 与EncryptedField::wipe()相同，只覆盖独占的缓冲区
+ * @param plaintexts 明文列表
+ */
+static void wipePlaintexts(QStringList &plaintexts)
+{
+    for (QString &plaintext : plaintexts) {
+        if (plaintext.isDetached()) {
+            plaintext.fill(QChar(u'\0'));
+        }
+    }
+    plaintexts.clear();
+}
+
+// EncryptedField实现
+
+void EncryptedField::setCiphertext(const QByteArray &ciphertext)
+{
+    setEnvelope(ciphertext, -1);
+}
+
+void EncryptedField::setEnvelope(const QByteArray &envelope, int slot)
+{
+    wipe();
+    m_ciphertext = envelope;
+    m_slot = static_cast<qint8>(slot);
+    m_plaintext.clear();
+    m_decrypted = false;
+}
+
+void EncryptedField::setPlaintext(const QString &plaintext)
+{
+    m_ciphertext.clear();
+    m_slot = -1;
+    m_plaintext = plaintext;
+    m_decrypted = true;
+}
+
+void EncryptedField::setDecrypted(QString plaintext)
+{
+    m_plaintext = std::move(plaintext);
+    m_decrypted = true;
+}
+
+bool EncryptedField::hasPlaintext(const QString &plaintext) const
+{
+    return m_decrypted && m_plaintext == plaintext;
+}
+
+void EncryptedField::seal(const QByteArray &ciphertext, int slot)
+{
+    m_ciphertext = ciphertext;
+    m_slot = static_cast<qint8>(slot);
+    m_decrypted = true;
+    wipe();
+}
+
+QString EncryptedField::plaintext() const
+{
+    if (!m_decrypted) {
+        CryptoManager *crypto = CryptoManager::instance();
+        if (isEnveloped()) {
+            // 信封中其余字段的明文不保留在临时列表中
+            QStringList fields = crypto->decryptRecord(m_ciphertext);
+            if (m_slot < fields.size()) {
+                m_plaintext = std::move(fields[m_slot]);
+            }
+            wipePlaintexts(fields);
+        } else {
+            m_plaintext = crypto->decryptField(m_ciphertext);
+        }
+        m_decrypted = true;
+    }
+    return m_plaintext;
+}
+
+void EncryptedField::wipe()
+{
+    // 没有密文时明文是唯一的数据来源，不能丢弃
+    if (m_ciphertext.isEmpty() || !m_decrypted) {
+        return;
+    }
+    // 先覆盖再释放，尽量不在堆上留下明文。缓冲区被共享时fill()会先分离出
+    // 私有副本，清零的只是副本，所以只在独占时原地覆盖
+    if (m_plaintext.isDetached()) {
+        m_plaintext.fill(QChar(u'\0'));
+    }
+    m_plaintext.clear();
+    m_decrypted = false;
+}
+
+void EncryptedField::decryptAll(const QList<EncryptedField*> &fields)
+{
+    CryptoManager *crypto = CryptoManager::instance();
+    if (!crypto->isInitialized()) {
+        return;
+    }
+
+    QList<EncryptedField*> pending;
+    QList<QByteArray> ciphertexts;
+    QList<EncryptedField*> enveloped;
+    QList<int> envelopeIndexes;
+    QList<QByteArray> envelopes;
+    // 同一记录的字段共享信封的数据指针，按指针合并后每条记录只解密一次
+    QHash<const char*, int> envelopeByData;
+    // 复制出的记录与原记录共享信封，同一位置的第二个字段从第一个字段复制明文
+    QHash<QPair<int, int>, EncryptedField*> firstBySlot;
+    for (EncryptedField *field : fields) {
+        if (field->isDecrypted()) {
+            continue;
+        }
+        if (!field->isEnveloped()) {
+            pending.append(field);
+            ciphertexts.append(field->m_ciphertext);
+            continue;
+        }
+        const char *data = field->m_ciphertext.constData();
+        auto it = envelopeByData.constFind(data);
+        if (it == envelopeByData.constEnd()) {
+            it = envelopeByData.insert(data, envelopes.size());
+            envelopes.append(field->m_ciphertext);
+        }
+        enveloped.append(field);
+        envelopeIndexes.append(it.value());
+    }
+
+    if (!pending.isEmpty()) {
+        QStringList plaintexts = crypto->decryptFields(ciphertexts);
+        if (plaintexts.size() == pending.size()) {
+            for (int i = 0; i < pending.size(); ++i) {
+                pending[i]->setDecrypted(std::move(plaintexts[i]));
+            }
+        }
+        wipePlaintexts(plaintexts);
+    }
+
+    if (!enveloped.isEmpty()) {
+        QList<QStringList> records = crypto->decryptRecords(envelopes);
+        if (records.size() == envelopes.size()) {
+            for (int i = 0; i < enveloped.size(); ++i) {
+                EncryptedField *field = enveloped[i];
+                const QPair<int, int> key(envelopeIndexes.at(i), field->m_slot);
+                QStringList &fieldsOfRecord = records[key.first];
+                if (EncryptedField *first = firstBySlot.value(key)) {
+                    field->setDecrypted(first->m_plaintext);
+                } else if (field->m_slot < fieldsOfRecord.size()) {
+                    // 移交明文，信封的临时列表中不留共享的副本
+                    field->setDecrypted(std::move(fieldsOfRecord[field->m_slot]));
+                    firstBySlot.insert(key, field);
+                } else {
+                    field->setDecrypted(QString());
+                }
+            }
+        }
+        // 未被请求的字段（例如只为搜索解密时的密码）在这里清零
+        for (QStringList &fieldsOfRecord : records) {
+            wipePlaintexts(fieldsOfRecord);
+        }
+    }
+}
+
+// PasswordRecord实现
+
+/**
+ * @brief 按SecretSlot顺序获取敏感字段明文
+ * @return 用户名、密码、备注
+ */
+QStringList PasswordRecord::secretPlaintexts() const
+{
+    decryptSecrets();
+    return {username.plaintext(), password.plaintext(), notes.plaintext()};
+}
+
+/**
+ * @brief 获取一个敏感字段的明文，信封字段一次填入同一记录的全部字段
+ * @param slot 字段位置
+ * @return 明文
+ */
+QString PasswordRecord::secret(SecretSlot slot) const
+{
+    const EncryptedField *field = slot == SecretUsername ? &username
+                                : slot == SecretPassword ? &password
+                                                         : &notes;
+    if (!field->isDecrypted() && field->isEnveloped()) {
+        decryptSecrets();
+    }
+    return field->plaintext();
+}
+
+/**
+ * @brief 一次解密全部尚未解密的敏感字段
+ */
+void PasswordRecord::decryptSecrets() const
+{
+    // 字段的明文缓存本身是mutable的，这里只是借用非const的批量解密接口
+    EncryptedField::decryptAll(const_cast<PasswordRecord *>(this)->pendingSecretFields());
+}
+
+/**
+ * @brief 设置记录信封
+ * @param envelope 记录信封密文
+ */
+void PasswordRecord::setSecretEnvelope(const QByteArray &envelope)
+{
+    username.setEnvelope(envelope, SecretUsername);
+    password.setEnvelope(envelope, SecretPassword);
+    notes.setEnvelope(envelope, SecretNotes);
+}
+
+/**
+ * @brief 记录明文加密后的信封，并清零内存中的明文
+ * @param envelope 记录信封密文
+ */
+void PasswordRecord::sealSecretEnvelope(const QByteArray &envelope)
+{
+    username.seal(envelope, SecretUsername);
+    password.seal(envelope, SecretPassword);
+    notes.seal(envelope, SecretNotes);
+}
+
+/**
+ * @brief 获取尚未解密的敏感字段
+ * @return 字段指针列表
+ */
+QList<EncryptedField*> PasswordRecord::pendingSecretFields()
+{
+    QList<EncryptedField*> fields;
+    for (EncryptedField *field : {&username, &password, &notes}) {
+        if (!field->isDecrypted()) {
+            fields.append(field);
+        }
+    }
+    return fields;
+}
+
+/**
+ * @brief 获取参与搜索的尚未解密字段
+ * @return 字段指针列表
+ */
+QList<EncryptedField*> PasswordRecord::pendingSearchableFields()
+{
+    QList<EncryptedField*> fields;
+    for (EncryptedField *field : {&username, &notes}) {
+        if (!field->isDecrypted()) {
+            fields.append(field);
+        }
+    }
+    return fields;
+}
+
+/**
+ * @brief 清除已解密的敏感字段明文
+ */
+void PasswordRecord::wipeSecrets()
+{
+    username.wipe();
+    password.wipe();
+    notes.wipe();
+}
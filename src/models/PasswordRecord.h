@@ -0,0 +1,199 @@
+#ifndef PASSWORDRECORD_H
+#define PASSWORDRECORD_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QStringList>
+
+/**
+ * @brief 延迟解密的敏感字段
+ *
+ * 从数据库加载时只保存密文，第一次读取明文时才调用CryptoManager解密。
+ * wipe()会丢弃已解密的明文，之后再次读取时重新解密。
+ *
+ * 清零是尽力而为的：QString隐式共享，plaintext()返回的副本仍在使用时
+ * 缓冲区不归本字段独占，此时只能释放引用，由最后一个持有者释放内存。
+ *
+ * 以记录信封保存的条目中，同一记录的几个字段共享同一份信封密文
+ * （隐式共享，不复制），各自记住自己在信封中的位置。单独读取一个信封字段
+ * 也要解开整个信封，应通过PasswordRecord::secret()或decryptAll()读取，
+ * 一次解密填入同一记录的全部字段。
+ */
+class EncryptedField
+{
+public:
+    /**
+     * @brief 设置密文，明文将在首次读取时解密
+     * @param ciphertext 二进制密文
+     */
+    void setCiphertext(const QByteArray &ciphertext);
+
+    /**
+     * @brief 设置记录信封密文，明文将在首次读取时从信封中取出
+     * @param envelope 记录信封密文
+     * @param slot 本字段在信封中的位置
+     */
+    void setEnvelope(const QByteArray &envelope, int slot);
+
+    /**
+     * @brief 设置明文，同时丢弃旧的密文
+     * @param plaintext 明文
+     */
+    void setPlaintext(const QString &plaintext);
+
+    /**
+     * @brief 获取明文，必要时先单独解密本字段
+     *
+     * 信封字段应通过PasswordRecord::secret()读取，避免每个字段各解密一次信封
+     * @return 明文
+     */
+    QString plaintext() const;
+
+    /**
+     * @brief 比较明文是否与给定值相同，不会触发解密
+     *
+     * 尚未解密的字段无法得知明文，视为不同
+     * @param plaintext 要比较的明文
+     * @return 已驻留的明文与给定值相同时返回true
+     */
+    bool hasPlaintext(const QString &plaintext) const;
+
+    /**
+     * @brief 检查明文当前是否驻留在内存中
+     * @return 已解密或由明文设置时返回true
+     */
+    bool isDecrypted() const { return m_decrypted; }
+
+    /**
+     * @brief 获取密文
+     * @return 二进制密文（信封字段为整个信封），由明文设置时为空
+     */
+    QByteArray ciphertext() const { return m_ciphertext; }
+
+    /**
+     * @brief 检查密文是否为记录信封
+     * @return 信封字段返回true
+     */
+    bool isEnveloped() const { return m_slot >= 0; }
+
+    /**
+     * @brief 填入已在外部解密好的明文，保留密文
+     *
+     * 调用方应移交明文（std::move），避免留下共享同一缓冲区的副本
+     * @param plaintext 明文
+     */
+    void setDecrypted(QString plaintext);
+
+    /**
+     * @brief 记录当前明文加密后的密文，并清零内存中的明文
+     * @param ciphertext 二进制密文
+     * @param slot 信封中的位置，-1表示单独加密的字段
+     */
+    void seal(const QByteArray &ciphertext, int slot = -1);
+
+    /**
+     * @brief 清除已解密的明文（仅当存在密文可供重新解密时）
+     *
+     * 缓冲区由本字段独占时先原地清零再释放，否则只释放引用
+     */
+    void wipe();
+
+    /**
+     * @brief 批量并行解密一组尚未解密的字段
+     *
+     * 共享同一份信封密文的字段只解密一次，信封中未被请求的字段明文随即清零
+     * @param fields 字段列表，已解密的字段会被跳过
+     */
+    static void decryptAll(const QList<EncryptedField*> &fields);
+
+private:
+    QByteArray m_ciphertext;           // 密文（与BLOB列内容相同）
+    qint8 m_slot = -1;                 // 在记录信封中的位置，-1表示单独加密
+    mutable QString m_plaintext;       // 明文缓存
+    mutable bool m_decrypted = true;   // 明文是否可用
+};
+
+/**
+ * @brief 密码条目的值类型记录
+ *
+ * 列表模型以连续数组保存这些记录，不再为每个条目创建QObject。
+ * 敏感字段仍然延迟解密，时间戳以UTC毫秒时间戳保存。
+ * 需要在QML中编辑时再由PasswordItem包装。
+ */
+struct PasswordRecord
+{
+    /**
+     * @brief 敏感字段在记录信封中的位置
+     */
+    enum SecretSlot {
+        SecretUsername = 0,
+        SecretPassword,
+        SecretNotes,
+        SecretSlotCount
+    };
+
+    int id = -1;                 // 数据库主键
+    QString title;               // 标题
+    EncryptedField username;     // 用户名（延迟解密）
+    EncryptedField password;     // 密码（延迟解密）
+    QString website;             // 网站URL
+    EncryptedField notes;        // 备注（延迟解密）
+    QString category;            // 分类
+    qint64 createdAt = 0;        // 创建时间（毫秒时间戳）
+    qint64 updatedAt = 0;        // 更新时间（毫秒时间戳）
+    bool isFavorite = false;     // 是否收藏
+
+    /**
+     * @brief 按SecretSlot顺序获取敏感字段明文，用于打包记录信封
+     * @return 用户名、密码、备注
+     */
+    QStringList secretPlaintexts() const;
+
+    /**
+     * @brief 获取一个敏感字段的明文，必要时先解密
+     *
+     * 信封字段尚未解密时一次解开信封，同时填入三个敏感字段
+     * @param slot 字段位置
+     * @return 明文
+     */
+    QString secret(SecretSlot slot) const;
+
+    /**
+     * @brief 一次解密全部尚未解密的敏感字段
+     *
+     * 明文是字段内部的缓存，解密不改变记录的值，因此可以在const记录上调用
+     */
+    void decryptSecrets() const;
+
+    /**
+     * @brief 设置记录信封，三个敏感字段共享同一份密文
+     * @param envelope 记录信封密文
+     */
+    void setSecretEnvelope(const QByteArray &envelope);
+
+    /**
+     * @brief 记录明文加密后的信封，并清零内存中的明文
+     * @param envelope 记录信封密文
+     */
+    void sealSecretEnvelope(const QByteArray &envelope);
+
+    /**
+     * @brief 获取尚未解密的敏感字段，供批量并行解密使用
+     * @return 字段指针列表，在记录被移动或销毁前有效
+     */
+    QList<EncryptedField*> pendingSecretFields();
+
+    /**
+     * @brief 获取参与搜索的尚未解密字段（用户名和备注，不含密码）
+     * @return 字段指针列表，在记录被移动或销毁前有效
+     */
+    QList<EncryptedField*> pendingSearchableFields();
+
+    /**
+     * @brief 清除已解密的敏感字段明文
+     */
+    void wipeSecrets();
+};
+
+#endif // PASSWORDRECORD_H
@@ -0,0 +1,91 @@
+#include "PasswordRecordStore.h"
+
+/**
+ * @brief 按ID查找记录
+ * @param id 记录ID
+ * @return 记录指针，未找到返回nullptr
+ */
+PasswordRecord *PasswordRecordStore::find(int id)
+{
+    auto it = m_slotById.constFind(id);
+    return it == m_slotById.cend() ? nullptr : &m_records[it.value()];
+}
+
+/**
+ * @brief 按ID查找记录
+ * @param id 记录ID
+ * @return 记录指针，未找到返回nullptr
+ */
+const PasswordRecord *PasswordRecordStore::find(int id) const
+{
+    auto it = m_slotById.constFind(id);
+    return it == m_slotById.cend() ? nullptr : &m_records.at(it.value());
+}
+
+/**
+ * @brief 插入记录，已存在相同ID时替换
+ * @param record 要插入的记录
+ * @return 插入后的记录指针
+ */
+PasswordRecord *PasswordRecordStore::insert(PasswordRecord record)
+{
+    auto it = m_slotById.constFind(record.id);
+    if (it != m_slotById.cend()) {
+        PasswordRecord &existing = m_records[it.value()];
+        existing.wipeSecrets();
+        existing = std::move(record);
+        return &existing;
+    }
+
+    m_slotById.insert(record.id, m_records.size());
+    m_records.append(std::move(record));
+    return &m_records.last();
+}
+
+/**
+ * @brief 删除记录并清除其中的明文
+ * @param id 记录ID
+ * @return 是否找到并删除
+ */
+bool PasswordRecordStore::remove(int id)
+{
+    auto it = m_slotById.find(id);
+    if (it == m_slotById.end()) {
+        return false;
+    }
+
+    const int slot = it.value();
+    m_slotById.erase(it);
+    m_records[slot].wipeSecrets();
+
+    // 用最后一条记录填补空位，保持数组连续
+    const int lastSlot = m_records.size() - 1;
+    if (slot != lastSlot) {
+        m_records[slot] = std::move(m_records[lastSlot]);
+        m_slotById[m_records.at(slot).id] = slot;
+    }
+    m_records.removeLast();
+    return true;
+}
+
+/**
+ * @brief 清除所有记录的明文并清空
+ */
+void PasswordRecordStore::clear()
+{
+    for (PasswordRecord &record : m_records) {
+        record.wipeSecrets();
+    }
+    m_records.clear();
+    m_slotById.clear();
+}
+
+/**
+ * @brief 预留容量
+ * @param size 记录数量
+ */
+void PasswordRecordStore::reserve(int size)
+{
+    m_records.reserve(size);
+    m_slotById.reserve(size);
+}
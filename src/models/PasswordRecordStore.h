@@ -0,0 +1,82 @@
+#ifndef PASSWORDRECORDSTORE_H
+#define PASSWORDRECORDSTORE_H
+
+#include <QHash>
+#include <QList>
+#include "PasswordRecord.h"
+
+/**
+ * @brief 连续存储的密码记录集合
+ *
+ * 记录按值保存在一个连续数组中，另有ID到数组下标的哈希表，
+ * 按ID查找、替换和删除都是O(1)。删除时把最后一条记录移到空位，
+ * 因此数组顺序不代表显示顺序，显示顺序由列表模型单独维护。
+ */
+class PasswordRecordStore
+{
+public:
+    /**
+     * @brief 记录数量
+     * @return 记录数量
+     */
+    int size() const { return m_records.size(); }
+
+    /**
+     * @brief 是否为空
+     * @return 没有记录时返回true
+     */
+    bool isEmpty() const { return m_records.isEmpty(); }
+
+    /**
+     * @brief 检查是否包含指定ID的记录
+     * @param id 记录ID
+     * @return 包含时返回true
+     */
+    bool contains(int id) const { return m_slotById.contains(id); }
+
+    /**
+     * @brief 按ID查找记录
+     * @param id 记录ID
+     * @return 记录指针，未找到返回nullptr；在下一次插入或删除前有效
+     */
+    PasswordRecord *find(int id);
+    const PasswordRecord *find(int id) const;
+
+    /**
+     * @brief 插入记录，已存在相同ID时替换
+     * @param record 要插入的记录
+     * @return 插入后的记录指针
+     */
+    PasswordRecord *insert(PasswordRecord record);
+
+    /**
+     * @brief 删除记录并清除其中的明文
+     * @param id 记录ID
+     * @return 是否找到并删除
+     */
+    bool remove(int id);
+
+    /**
+     * @brief 清除所有记录的明文并清空
+     */
+    void clear();
+
+    /**
+     * @brief 预留容量
+     * @param size 记录数量
+     */
+    void reserve(int size);
+
+    /**
+     * @brief 获取所有记录（顺序不固定）
+     * @return 记录数组
+     */
+    QList<PasswordRecord> &records() { return m_records; }
+    const QList<PasswordRecord> &records() const { return m_records; }
+
+private:
+    QList<PasswordRecord> m_records;  // 连续存储的记录
+    QHash<int, int> m_slotById;       // 记录ID到数组下标
+};
+
+#endif // PASSWORDRECORDSTORE_H
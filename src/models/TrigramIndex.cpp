@@ -0,0 +1,256 @@
+#include "TrigramIndex.h"
+#include "PasswordRecord.h"
+#include <algorithm>
+
+// 字段分隔符，包含它的三元组不进入索引，避免跨字段匹配
+static const QChar FIELD_SEPARATOR = QLatin1Char('\n');
+
+// 空闲槽位超过该数量且超过有效项目数时重新编号
+static const int COMPACT_THRESHOLD = 1024;
+
+/**
+ * @brief 清零缓存的折叠文本，其中包含用户名和备注明文
+ * @param text 要清零的文本
+ */
+static void wipeText(QString &text)
+{
+    if (text.isDetached()) {
+        text.fill(QChar(u'\0'));
+    }
+    text.clear();
+}
+
+/**
+ * @brief 清空索引
+ */
+void TrigramIndex::clear()
+{
+    for (Entry &entry : m_entries) {
+        wipeText(entry.text);
+    }
+    m_entries.clear();
+    m_slots.clear();
+    m_postings.clear();
+}
+
+/**
+ * @brief 索引或重新索引一条记录
+ * @param record 密码记录
+ */
+void TrigramIndex::insert(const PasswordRecord &record)
+{
+    QString text = fold(record.title) + FIELD_SEPARATOR
+                 + fold(record.secret(PasswordRecord::SecretUsername)) + FIELD_SEPARATOR
+                 + fold(record.website) + FIELD_SEPARATOR
+                 + fold(record.secret(PasswordRecord::SecretNotes)) + FIELD_SEPARATOR
+                 + fold(record.category);
+
+    auto it = m_entries.find(record.id);
+    if (it != m_entries.end()) {
+        if (it->text == text) {
+            return;
+        }
+        removePostings(it->slot, it->text);
+        wipeText(it->text);
+        it->text = text;
+        addPostings(it->slot, it->text);
+        return;
+    }
+
+    // 新记录总是追加到末尾，倒排表中的槽位列表保持升序
+    const int slot = m_slots.size();
+    m_slots.append(record.id);
+    m_entries.insert(record.id, Entry{slot, text});
+    addPostings(slot, text);
+}
+
+/**
+ * @brief 从索引中移除记录
+ * @param id 记录ID
+ */
+void TrigramIndex::remove(int id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    removePostings(it->slot, it->text);
+    wipeText(it->text);
+    m_slots[it->slot] = -1;
+    m_entries.erase(it);
+
+    const int freeSlots = m_slots.size() - m_entries.size();
+    if (freeSlots > COMPACT_THRESHOLD && freeSlots > m_entries.size()) {
+        compact();
+    }
+}
+
+/**
+ * @brief 查找包含搜索词的所有记录
+ * @param foldedTerm 折叠后的搜索词
+ * @return 匹配的记录ID集合
+ */
+QSet<int> TrigramIndex::search(const QString &foldedTerm) const
+{
+    QSet<int> results;
+
+    // 搜索词太短无法使用三元组时，直接扫描缓存的折叠文本
+    if (foldedTerm.size() < 3) {
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+            if (it->text.contains(foldedTerm)) {
+                results.insert(it.key());
+            }
+        }
+        return results;
+    }
+
+    // 收集所有三元组的倒排表，任一缺失即无结果
+    QList<const QList<int>*> lists;
+    for (quint64 key : trigrams(foldedTerm)) {
+        auto it = m_postings.constFind(key);
+        if (it == m_postings.cend()) {
+            return results;
+        }
+        lists.append(&it.value());
+    }
+    if (lists.isEmpty()) {
+        return results;
+    }
+
+    // 从最短的倒排表开始求交集
+    std::sort(lists.begin(), lists.end(), [](const QList<int> *a, const QList<int> *b) {
+        return a->size() < b->size();
+    });
+    QList<int> candidates = *lists.first();
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        QList<int> merged;
+        std::set_intersection(candidates.cbegin(), candidates.cend(),
+                              lists.at(i)->cbegin(), lists.at(i)->cend(),
+                              std::back_inserter(merged));
+        candidates = std::move(merged);
+    }
+
+    // 三元组全部命中不代表连续出现，用缓存文本确认
+    results.reserve(candidates.size());
+    for (int slot : candidates) {
+        const int id = m_slots.at(slot);
+        if (id >= 0 && matches(id, foldedTerm)) {
+            results.insert(id);
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief 检查单条已索引记录是否包含搜索词
+ * @param id 记录ID
+ * @param foldedTerm 折叠后的搜索词
+ * @return 匹配返回true
+ */
+bool TrigramIndex::matches(int id, const QString &foldedTerm) const
+{
+    auto it = m_entries.constFind(id);
+    return it != m_entries.cend() && it->text.contains(foldedTerm);
+}
+
+/**
+ * @brief 对文本做大小写折叠
+ * @param text 原始文本
+ * @return 折叠后的文本
+ */
+QString TrigramIndex::fold(const QString &text)
+{
+    return text.toCaseFolded();
+}
+
+/**
+ * @brief 提取文本中不含字段分隔符的去重三元组
+ * @param text 折叠后的文本
+ * @return 升序排列的三元组键
+ */
+QList<quint64> TrigramIndex::trigrams(const QString &text)
+{
+    QList<quint64> keys;
+    if (text.size() < 3) {
+        return keys;
+    }
+
+    keys.reserve(text.size() - 2);
+    const QChar *data = text.constData();
+    for (qsizetype i = 0; i + 2 < text.size(); ++i) {
+        if (data[i] == FIELD_SEPARATOR || data[i + 1] == FIELD_SEPARATOR || data[i + 2] == FIELD_SEPARATOR) {
+            continue;
+        }
+        keys.append((quint64(data[i].unicode()) << 32)
+                    | (quint64(data[i + 1].unicode()) << 16)
+                    | quint64(data[i + 2].unicode()));
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+/**
+ * @brief 将项目的三元组加入倒排表
+ * @param slot 项目槽位
+ * @param text 折叠后的文本
+ */
+void TrigramIndex::addPostings(int slot, const QString &text)
+{
+    for (quint64 key : trigrams(text)) {
+        QList<int> &list = m_postings[key];
+        // 新槽位总在末尾；重新索引已有项目时需要按序插入
+        if (list.isEmpty() || list.last() < slot) {
+            list.append(slot);
+        } else {
+            list.insert(std::lower_bound(list.begin(), list.end(), slot), slot);
+        }
+    }
+}
+
+/**
+ * @brief 从倒排表中删除项目的三元组
+ * @param slot 项目槽位
+ * @param text 折叠后的文本
+ */
+void TrigramIndex::removePostings(int slot, const QString &text)
+{
+    for (quint64 key : trigrams(text)) {
+        auto it = m_postings.find(key);
+        if (it == m_postings.end()) {
+            continue;
+        }
+        QList<int> &list = it.value();
+        auto pos = std::lower_bound(list.begin(), list.end(), slot);
+        if (pos != list.end() && *pos == slot) {
+            list.erase(pos);
+        }
+        if (list.isEmpty()) {
+            m_postings.erase(it);
+        }
+    }
+}
+
+/**
+ * @brief 重新编号槽位并重建倒排表
+ */
+void TrigramIndex::compact()
+{
+    QList<int> renumbered;
+    renumbered.reserve(m_entries.size());
+    m_postings.clear();
+
+    // 按原槽位顺序重新编号，使用缓存文本，不需要重新折叠
+    for (int id : std::as_const(m_slots)) {
+        if (id < 0) {
+            continue;
+        }
+        Entry &entry = m_entries[id];
+        entry.slot = renumbered.size();
+        renumbered.append(id);
+        addPostings(entry.slot, entry.text);
+    }
+    m_slots = std::move(renumbered);
+}
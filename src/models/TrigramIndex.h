@@ -0,0 +1,115 @@
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+struct PasswordRecord;
+
+/**
+ * @brief 内存中的三元组搜索索引
+ *
+ * 为每个密码记录缓存一次大小写折叠后的可搜索文本（标题、用户名、网址、
+ * 备注、分类），并维护三元组到项目槽位的倒排表。搜索时先求各三元组
+ * 倒排表的交集得到候选项目，再用缓存文本确认子串匹配，
+ * 不必在每次按键时对所有项目重新转换大小写。
+ * 字段变化时只需对该项目调用insert()重新索引。
+ * 缓存文本含有用户名和备注明文，被替换、移除或clear()时先清零。
+ */
+class TrigramIndex
+{
+public:
+    /**
+     * @brief 清零缓存的文本并清空索引
+     */
+    void clear();
+
+    /**
+     * @brief 索引中的项目数量
+     * @return 项目数量
+     */
+    int size() const { return m_entries.size(); }
+
+    /**
+     * @brief 检查记录是否已被索引
+     * @param id 记录ID
+     * @return 已索引返回true
+     */
+    bool contains(int id) const { return m_entries.contains(id); }
+
+    /**
+     * @brief 索引或重新索引一条记录
+     *
+     * 会读取用户名和备注明文，批量索引前应先批量解密
+     * @param record 密码记录
+     */
+    void insert(const PasswordRecord &record);
+
+    /**
+     * @brief 从索引中移除记录
+     * @param id 记录ID
+     */
+    void remove(int id);
+
+    /**
+     * @brief 查找包含搜索词的所有记录
+     * @param foldedTerm 已经过fold()处理的搜索词
+     * @return 匹配的记录ID集合
+     */
+    QSet<int> search(const QString &foldedTerm) const;
+
+    /**
+     * @brief 检查单条已索引记录是否包含搜索词
+     * @param id 记录ID
+     * @param foldedTerm 已经过fold()处理的搜索词
+     * @return 匹配返回true，未索引的记录返回false
+     */
+    bool matches(int id, const QString &foldedTerm) const;
+
+    /**
+     * @brief 对文本做大小写折叠，用于索引和查询
+     * @param text 原始文本
+     * @return 折叠后的文本
+     */
+    static QString fold(const QString &text);
+
+private:
+    struct Entry {
+        int slot;          // 在倒排表中使用的槽位
+        QString text;      // 折叠后的可搜索文本，字段之间以换行分隔
+    };
+
+    QHash<int, Entry> m_entries;                      // 记录ID到缓存文本的映射
+    QList<int> m_slots;                               // 槽位到记录ID的映射，已移除的槽位为-1
+    QHash<quint64, QList<int>> m_postings;            // 三元组到升序槽位列表的倒排表
+
+    /**
+     * @brief 提取文本中不含字段分隔符的去重三元组
+     * @param text 折叠后的文本
+     * @return 升序排列的三元组键
+     */
+    static QList<quint64> trigrams(const QString &text);
+
+    /**
+     * @brief 将项目的三元组加入倒排表
+     * @param slot 项目槽位
+     * @param text 折叠后的文本
+     */
+    void addPostings(int slot, const QString &text);
+
+    /**
+     * @brief 从倒排表中删除项目的三元组
+     * @param slot 项目槽位
+     * @param text 折叠后的文本
+     */
+    void removePostings(int slot, const QString &text);
+
+    /**
+     * @brief 已移除的槽位过多时重新编号，保持倒排表紧凑
+     */
+    void compact();
+};
+
+#endif // TRIGRAMINDEX_H
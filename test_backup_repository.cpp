@@ -0,0 +1,113 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include "src/database/BackupRepository.h"
+
+static int failures = 0;
+
+static void check(bool passed, const char *name)
+{
+    if (passed) {
+        qDebug() << "✓" << name << "test PASSED";
+    } else {
+        qDebug() << "✗" << name << "test FAILED";
+        ++failures;
+    }
+}
+
+static bool writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+static QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    qDebug() << "Testing BackupRepository...";
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "Failed to create temporary directory";
+        return -1;
+    }
+
+    // 固定种子的随机内容，近似加密后的数据库页
+    QByteArray original(1024 * 1024, Qt::Uninitialized);
+    QRandomGenerator generator(20240102);
+    generator.fillRange(reinterpret_cast<quint32 *>(original.data()), original.size() / sizeof(quint32));
+    const QString databasePath = dir.filePath("passwords.db");
+    writeFile(databasePath, original);
+
+    BackupRepository repository(dir.filePath("backups"));
+    check(repository.initialize(), "Initialize");
+
+    BackupSnapshotStats firstStats;
+    const QString firstManifest = repository.createSnapshot(databasePath, &firstStats);
+    check(!firstManifest.isEmpty(), "Create first snapshot");
+    check(firstStats.totalBytes == original.size() && firstStats.storedChunks == firstStats.chunkCount,
+          "First snapshot stores every chunk");
+    check(BackupRepository::isSnapshotManifest(firstManifest), "Manifest detection");
+    check(QDir(BackupRepository::repositoryForManifest(firstManifest)) == QDir(dir.filePath("backups")),
+          "Repository for manifest");
+
+    // 只修改中间的一页，第二次快照应复用其余的块
+    QByteArray modified = original;
+    for (int i = 0; i < 4096; ++i) {
+        modified[512 * 1024 + i] = static_cast<char>(i);
+    }
+    writeFile(databasePath, modified);
+
+    BackupSnapshotStats secondStats;
+    const QString secondManifest = repository.createSnapshot(databasePath, &secondStats);
+    check(!secondManifest.isEmpty() && secondManifest != firstManifest, "Create second snapshot");
+    check(secondStats.storedChunks > 0 && secondStats.storedChunks < secondStats.chunkCount / 4,
+          "Second snapshot reuses unchanged chunks");
+    const QStringList snapshots = repository.snapshots();
+    check(snapshots.size() == 2 && snapshots.contains(firstManifest) && snapshots.contains(secondManifest),
+          "List snapshots");
+
+    const QString firstRestore = dir.filePath("first.db");
+    check(repository.restoreSnapshot(firstManifest, firstRestore), "Restore first snapshot");
+    check(readFile(firstRestore) == original, "First snapshot round trip");
+
+    const QString secondRestore = dir.filePath("second.db");
+    check(repository.restoreSnapshot(secondManifest, secondRestore), "Restore second snapshot");
+    check(readFile(secondRestore) == modified, "Second snapshot round trip");
+
+    // 损坏任一块后恢复必须失败
+    const QStringList chunkFiles = QDir(dir.filePath("backups/chunks"))
+                                       .entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    bool corrupted = false;
+    if (!chunkFiles.isEmpty()) {
+        QDir chunkDir(dir.filePath("backups/chunks/" + chunkFiles.first()));
+        const QStringList chunks = chunkDir.entryList(QDir::Files);
+        if (!chunks.isEmpty()) {
+            QFile chunk(chunkDir.filePath(chunks.first()));
+            if (chunk.open(QIODevice::ReadWrite)) {
+                const char first = chunk.read(1).at(0);
+                chunk.seek(0);
+                chunk.write(QByteArray(1, static_cast<char>(first ^ 0xFF)));
+                corrupted = true;
+            }
+        }
+    }
+    check(corrupted, "Corrupt a chunk");
+    const bool firstRestored = repository.restoreSnapshot(firstManifest, dir.filePath("corrupt1.db"));
+    const bool secondRestored = repository.restoreSnapshot(secondManifest, dir.filePath("corrupt2.db"));
+    check(!(firstRestored && secondRestored), "Corrupted chunk detected");
+
+    qDebug() << "All tests completed!";
+
+    return failures == 0 ? 0 : 1;
+}
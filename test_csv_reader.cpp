@@ -0,0 +1,89 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTimeZone>
+#include "src/io/CsvPasswordRecordReader.h"
+
+static int failures = 0;
+
+static void check(bool passed, const char *name)
+{
+    if (passed) {
+        qDebug() << "✓" << name << "test PASSED";
+    } else {
+        qDebug() << "✗" << name << "test FAILED";
+        ++failures;
+    }
+}
+
+static bool writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+static const QByteArray CSV_HEADER =
+    "Title,Username,Password,Website,Notes,Category,Created At,Updated At,Is Favorite\r\n";
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    qDebug() << "Testing CsvPasswordRecordReader...";
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "Failed to create temporary directory";
+        return -1;
+    }
+
+    // 引号转义、引号内的逗号和换行、CRLF行尾，最后一条记录没有换行符
+    const QString quotedPath = dir.filePath("quoted.csv");
+    writeFile(quotedPath, CSV_HEADER
+              + "Mail,\"alice\",\"pa\"\"ss,word\",https://mail.example,"
+                "\"line1\r\nline2\nline3\",Work,2024-01-02T03:04:05Z,2024-01-02T03:04:05Z,true\r\n"
+              + "Bank,bob,\"x\"\"y\"\"\",,\"\",Finance,,,false");
+
+    CsvPasswordRecordReader reader;
+    check(reader.open(quotedPath), "Open");
+
+    PasswordRecord first;
+    check(reader.readNext(first), "Read quoted record");
+    check(first.title == "Mail" && first.username.plaintext() == "alice", "Quoted field");
+    check(first.password.plaintext() == "pa\"ss,word", "Escaped quote and comma");
+    check(first.notes.plaintext() == "line1\nline2\nline3", "Embedded CRLF and newline");
+    check(first.category == "Work" && first.isFavorite, "CRLF line ending");
+    check(first.createdAt == QDateTime(QDate(2024, 1, 2), QTime(3, 4, 5), QTimeZone::UTC).toMSecsSinceEpoch(),
+          "Timestamp");
+
+    PasswordRecord second;
+    check(reader.readNext(second), "Read last record without newline");
+    check(second.password.plaintext() == "x\"y\"", "Trailing escaped quote");
+    check(second.website.isEmpty() && second.notes.plaintext().isEmpty(), "Empty fields");
+    check(second.createdAt == 0 && !second.isFavorite, "Missing timestamp");
+
+    PasswordRecord none;
+    check(!reader.readNext(none) && !reader.hasError(), "End of file");
+    check(reader.progressValue() == reader.progressMaximum(), "Progress");
+
+    // 引号未闭合：之前的记录照常读出，随后报告错误
+    const QString brokenPath = dir.filePath("broken.csv");
+    writeFile(brokenPath, CSV_HEADER
+              + "Good,user,pw,,,Misc,,,false\n"
+              + "Bad,\"user,pw,,,Misc,,,false\n"
+              + "Never,user,pw,,,Misc,,,false\n");
+
+    CsvPasswordRecordReader brokenReader;
+    check(brokenReader.open(brokenPath), "Open unterminated");
+    PasswordRecord good;
+    check(brokenReader.readNext(good) && good.title == "Good", "Record before unterminated quote");
+    PasswordRecord bad;
+    check(!brokenReader.readNext(bad), "Stop at unterminated quote");
+    check(brokenReader.hasError(), "Unterminated quote error");
+
+    qDebug() << "All tests completed!";
+
+    return failures == 0 ? 0 : 1;
+}
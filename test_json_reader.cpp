@@ -0,0 +1,65 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include "src/io/JsonArrayReader.h"
+
+static int failures = 0;
+
+static void check(bool passed, const char *name)
+{
+    if (passed) {
+        qDebug() << "✓" << name << "test PASSED";
+    } else {
+        qDebug() << "✗" << name << "test FAILED";
+        ++failures;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    qDebug() << "Testing JsonArrayReader...";
+
+    // 字符串中的括号、转义引号和反斜杠不能影响元素边界
+    QByteArray json = "\xEF\xBB\xBF[\n"
+                      "  {\"title\": \"a]b}c\", \"notes\": \"say \\\"}]\\\" ok\"},\n"
+                      "  {\"title\": \"slash\\\\\", \"nested\": {\"list\": [\"]\", \"}\"]}},\n"
+                      "  42, \"skipped\", [1, 2],\n";
+    // 跨越读取块边界的长字符串，结尾紧跟转义的右括号
+    const QByteArray longText(JsonArrayReader::READ_CHUNK_SIZE + 100, 'x');
+    json += "  {\"title\": \"long\", \"notes\": \"" + longText + "\\\"}]\"}\n]";
+
+    QBuffer buffer(&json);
+    buffer.open(QIODevice::ReadOnly);
+    JsonArrayReader reader(&buffer);
+
+    QJsonObject object;
+    check(reader.readNext(object), "Read first object");
+    check(object["title"].toString() == "a]b}c", "Brackets inside string");
+    check(object["notes"].toString() == "say \"}]\" ok", "Escaped quotes around brackets");
+
+    check(reader.readNext(object), "Read second object");
+    check(object["title"].toString() == "slash\\", "Escaped backslash before closing quote");
+    check(object["nested"].toObject()["list"].toArray().size() == 2, "Nested brackets");
+
+    check(reader.readNext(object), "Skip non-object elements");
+    check(object["title"].toString() == "long", "Object across read chunks");
+    check(object["notes"].toString() == QString::fromLatin1(longText + "\"}]"), "Long string content");
+
+    check(!reader.readNext(object) && reader.atEnd() && !reader.hasError(), "End of array");
+    check(reader.bytesConsumed() == json.size(), "Bytes consumed");
+
+    // 字符串未闭合的数组应报告错误而不是读出对象
+    QByteArray broken = "[{\"title\": \"open]}\n";
+    QBuffer brokenBuffer(&broken);
+    brokenBuffer.open(QIODevice::ReadOnly);
+    JsonArrayReader brokenReader(&brokenBuffer);
+    check(!brokenReader.readNext(object) && brokenReader.hasError(), "Unterminated string");
+
+    qDebug() << "All tests completed!";
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDateTime>
+#include <QSet>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTimeZone>
+#include "src/crypto/CryptoManager.h"
+#include "src/database/DatabaseManager.h"
+
+// 与DatabaseManager中的MIGRATION_BATCH_SIZE一致，中断发生在第一批提交之后
+static const int MIGRATED_BEFORE_INTERRUPT = 500;
+
+// 版本1数据库中的条目数，覆盖中断后剩余的多个批次和最后不满的一批
+static const int LEGACY_ROW_COUNT = 1234;
+
+static int failures = 0;
+
+static void check(bool passed, const char *name)
+{
+    if (passed) {
+        qDebug() << "✓" << name << "test PASSED";
+    } else {
+        qDebug() << "✗" << name << "test FAILED";
+        ++failures;
+    }
+}
+
+/**
+ * @brief 创建版本1格式的数据库，并模拟升级在第一批提交后中断
+ *
+ * 版本1的密文为Base64文本，只有16字节IV时解密为空字符串；
+ * 已复制到passwords_v2的行使用不同的标题和密码，用来确认它们没有被重新复制
+ */
+static bool createInterruptedDatabase(const QString &path, const QByteArray &key)
+{
+    SQLCipherWrapper db;
+    if (!db.openDatabase(path) || !db.setKey(key)) {
+        return false;
+    }
+
+    bool ok = db.execute(R"(
+        CREATE TABLE passwords (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL,
+            username TEXT,
+            password TEXT NOT NULL,
+            website TEXT,
+            notes TEXT,
+            category TEXT,
+            created_at TEXT NOT NULL,
+            updated_at TEXT NOT NULL,
+            is_favorite INTEGER DEFAULT 0
+        )
+    )") && db.execute(R"(
+        CREATE TABLE passwords_v2 (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL,
+            username BLOB,
+            password BLOB NOT NULL,
+            website TEXT,
+            notes BLOB,
+            category TEXT,
+            created_at INTEGER NOT NULL,
+            updated_at INTEGER NOT NULL,
+            is_favorite INTEGER DEFAULT 0,
+            secrets BLOB
+        )
+    )") && db.beginTransaction();
+    if (!ok) {
+        return false;
+    }
+
+    const QString emptyLegacy = QString::fromLatin1(QByteArray(16, '\0').toBase64());
+    SQLCipherStatement legacyStmt = db.prepare(R"(
+        INSERT INTO passwords (id, title, username, password, website, notes, category, created_at, updated_at, is_favorite)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    )");
+    for (int id = 1; ok && id <= LEGACY_ROW_COUNT; ++id) {
+        legacyStmt.bindInt64(1, id);
+        legacyStmt.bindText(2, QStringLiteral("legacy-%1").arg(id));
+        legacyStmt.bindText(3, emptyLegacy);
+        legacyStmt.bindText(4, emptyLegacy);
+        legacyStmt.bindText(5, QStringLiteral("https://example.com/%1").arg(id));
+        legacyStmt.bindText(6, emptyLegacy);
+        legacyStmt.bindText(7, QStringLiteral("Legacy"));
+        legacyStmt.bindText(8, QStringLiteral("2020-05-06T07:08:09Z"));
+        legacyStmt.bindText(9, QStringLiteral("2020-05-06T07:08:09Z"));
+        legacyStmt.bindInt64(10, id % 2);
+        ok = legacyStmt.exec();
+    }
+
+    CryptoManager *crypto = CryptoManager::instance();
+    SQLCipherStatement migratedStmt = db.prepare(R"(
+        INSERT INTO passwords_v2 (id, title, username, password, website, notes, category, created_at, updated_at, is_favorite)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    )");
+    for (int id = 1; ok && id <= MIGRATED_BEFORE_INTERRUPT; ++id) {
+        migratedStmt.bindInt64(1, id);
+        migratedStmt.bindText(2, QStringLiteral("resumed-%1").arg(id));
+        migratedStmt.bindBlob(3, crypto->encryptField(QString()));
+        migratedStmt.bindBlob(4, crypto->encryptField(QStringLiteral("kept")));
+        migratedStmt.bindText(5, QStringLiteral("https://example.com/%1").arg(id));
+        migratedStmt.bindBlob(6, crypto->encryptField(QString()));
+        migratedStmt.bindText(7, QStringLiteral("Legacy"));
+        migratedStmt.bindInt64(8, 0);
+        migratedStmt.bindInt64(9, 0);
+        migratedStmt.bindInt64(10, id % 2);
+        ok = migratedStmt.exec();
+    }
+
+    ok = ok && db.commitTransaction();
+    // 关闭前归还语句
+    legacyStmt = SQLCipherStatement();
+    migratedStmt = SQLCipherStatement();
+    return db.closeDatabase() && ok;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    qDebug() << "Testing schema version 2 migration resume...";
+
+    // 设置和盐值都写到临时位置，不影响真实的密码库
+    QStandardPaths::setTestModeEnabled(true);
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "Failed to create temporary directory";
+        return -1;
+    }
+    QSettings::setDefaultFormat(QSettings::IniFormat);
+    QSettings::setPath(QSettings::IniFormat, QSettings::UserScope, dir.path());
+
+    CryptoManager *crypto = CryptoManager::instance();
+    if (!crypto->initialize("test123456")) {
+        qDebug() << "Failed to initialize CryptoManager";
+        return -1;
+    }
+
+    const QString databasePath = dir.filePath("passwords.db");
+    check(createInterruptedDatabase(databasePath, crypto->databaseKey()), "Create interrupted database");
+
+    DatabaseManager *database = DatabaseManager::instance();
+    check(database->initialize(databasePath), "Initialize");
+    check(database->setDatabaseKey(crypto->databaseKey(), QString()), "Resume migration");
+
+    int count = 0;
+    int resumed = 0;
+    int copied = 0;
+    bool fieldsOk = true;
+    QSet<int> ids;
+    const bool visited = database->executor()->run([&]() {
+        return database->forEachPasswordRecord([&](const PasswordRecord &record) {
+            ++count;
+            ids.insert(record.id);
+            if (record.id <= MIGRATED_BEFORE_INTERRUPT) {
+                // 中断前已提交的行原样保留
+                resumed += record.title == QStringLiteral("resumed-%1").arg(record.id);
+                fieldsOk = fieldsOk && record.password.plaintext() == "kept";
+            } else {
+                // 之后的行从旧表转换，时间改为毫秒时间戳
+                copied += record.title == QStringLiteral("legacy-%1").arg(record.id);
+                fieldsOk = fieldsOk && record.password.plaintext().isEmpty()
+                           && record.createdAt == QDateTime(QDate(2020, 5, 6), QTime(7, 8, 9), QTimeZone::UTC)
+                                                      .toMSecsSinceEpoch();
+            }
+            fieldsOk = fieldsOk && record.isFavorite == (record.id % 2 == 1);
+            return true;
+        });
+    });
+    check(visited, "Read migrated records");
+    check(count == LEGACY_ROW_COUNT && ids.size() == LEGACY_ROW_COUNT, "Every row migrated exactly once");
+    check(resumed == MIGRATED_BEFORE_INTERRUPT, "Committed batch not redone");
+    check(copied == LEGACY_ROW_COUNT - MIGRATED_BEFORE_INTERRUPT, "Remaining batches copied");
+    check(fieldsOk, "Migrated fields");
+    check(database->closeDatabase(), "Close");
+
+    // 旧表已被替换，版本号已更新
+    SQLCipherWrapper db;
+    const bool reopened = db.openDatabase(databasePath) && db.verifyKey(crypto->databaseKey());
+    check(reopened, "Reopen");
+    const QList<QVariantMap> leftovers = db.query(
+        "SELECT name FROM sqlite_master WHERE type = 'table' AND name = 'passwords_v2'");
+    check(reopened && leftovers.isEmpty(), "Temporary table removed");
+    const QList<QVariantMap> version = db.query("SELECT version FROM database_version");
+    check(!version.isEmpty() && version.first().value("version").toInt() == 3, "Database version");
+    db.closeDatabase();
+
+    qDebug() << "All tests completed!";
+
+    return failures == 0 ? 0 : 1;
+}